@@ -7,6 +7,8 @@
 #include <iomanip>
 #include <stack>
 #include <algorithm>
+#include <thread>
+#include <atomic>
 
 using namespace std;
 
@@ -636,8 +638,48 @@ public:
 map<string, node::node_generator*> node::node_generator::prototypes;
 map<unsigned int, node*> node::id_node_table;
 
+// forwarding table of a switch: the next hop toward each destination
+// the rules are stored in an array indexed by the destination id, so a lookup is O(1);
+// unlike map::operator[], a lookup of a missing destination never adds a rule
+class forwarding_table {
+    vector<unsigned int> next_hop; // BROCAST_ID means that there is no rule for the destination
+    unsigned int rule_num;
+
+public:
+    forwarding_table() : rule_num(0) {}
+
+    // add or replace the rule of destination dst; a rule with BROCAST_ID, which marks a destination without a rule in the
+    // table, is rejected: false is returned and the table is not changed
+    bool install(unsigned int dst, unsigned int next) {
+        if (dst == BROCAST_ID || next == BROCAST_ID)
+            return false;
+        if (dst >= next_hop.size())
+            next_hop.resize(dst + 1, BROCAST_ID);
+        if (next_hop[dst] == BROCAST_ID)
+            rule_num++;
+        next_hop[dst] = next;
+        return true;
+    }
+    void remove(unsigned int dst) {
+        if (contains(dst)) {
+            next_hop[dst] = BROCAST_ID;
+            rule_num--;
+        }
+    }
+
+    // return false if there is no rule for dst (next is not changed in this case)
+    bool lookup(unsigned int dst, unsigned int& next) const {
+        if (!contains(dst))
+            return false;
+        next = next_hop[dst];
+        return true;
+    }
+    bool contains(unsigned int dst) const { return dst < next_hop.size() && next_hop[dst] != BROCAST_ID; }
+    unsigned int size() const { return rule_num; }
+};
+
 class SDN_switch : public node {
-    map<unsigned int, unsigned int> next; // you can use this variable to record the node's 1-hop neighbors 
+    forwarding_table next; // the next hop toward each destination
 
     bool hi; // this is used for example; you can remove it when doing hw2
 
@@ -656,12 +698,13 @@ public:
     // void add_one_hop_neighbor (unsigned int n_id) { one_hop_neighbors[n_id] = true; }
     // unsigned int get_one_hop_neighbor_num () { return one_hop_neighbors.size(); }
 
-    void set_next_node_of_dest(unsigned int _dest, unsigned int _next) { next[_dest] = _next; }
-    unsigned int get_next_node_of_dest(unsigned int _dest) { return next[_dest]; }
-    bool checkDestNotExist(int dest) {
-        if (next.count(dest) == 0)return true;
-        return false;
+    void set_next_node_of_dest(unsigned int _dest, unsigned int _next) {
+        if (!next.install(_dest, _next))
+            cerr << "SDN_switch error: node " << getNodeID() << " rejects a rule with BROCAST_ID" << endl;
     }
+    // return false if there is no rule for _dest
+    bool get_next_node_of_dest(unsigned int _dest, unsigned int& _next) const { return next.lookup(_dest, _next); }
+    bool checkDestNotExist(unsigned int dest) const { return !next.contains(dest); }
 
     class SDN_switch_generator;
     friend class SDN_switch_generator;
@@ -687,6 +730,129 @@ struct Round {
     bool operator==(const Round& a) { return a.target == this->target; }
 };
 
+// the progress of the update rounds of one destination
+// each target of the current round has an index to its slot and the round counts the targets which have not acknowledged yet,
+// so an ack costs O(1) and the next round is released as soon as the count reaches zero
+class RoundTracker {
+    vector<vector<Round > >* rounds = nullptr;
+    vector<pair<unsigned int, unsigned int> > slotOf; // target -> (round, index in the round)
+    unsigned int cur = 0; // the current round
+    unsigned int outstanding = 0; // the targets of the current round which have not acknowledged yet
+
+    // index the targets of the current round
+    void enter() {
+        outstanding = 0;
+        if (finished()) return;
+        for (unsigned int i = 0; i < (*rounds)[cur].size(); i++) {
+            unsigned int target = (*rounds)[cur][i].target;
+            if (target >= slotOf.size()) slotOf.resize(target + 1, { UINT_MAX, 0 });
+            if (slotOf[target].first == cur) continue; // the same target twice in a round is acknowledged once
+            slotOf[target] = { cur, i };
+            outstanding++;
+        }
+    }
+
+public:
+    // the first round becomes the current one
+    void track(vector<vector<Round > >& _rounds) {
+        rounds = &_rounds;
+        cur = 0;
+        slotOf.clear();
+        enter();
+    }
+    bool tracking() const { return rounds != nullptr; }
+    unsigned int current() const { return cur; }
+    bool finished() const { return cur >= rounds->size(); }
+    // target acknowledged its rule; returns true if this ack completed the current round, and then the next round is the current one
+    bool ack(unsigned int target) {
+        if (finished() || target >= slotOf.size() || slotOf[target].first != cur) return false; // not a target of the current round
+        Round& r = (*rounds)[cur][slotOf[target].second];
+        if (r.state == 1) return false; // acknowledged before
+        r.state = 1;
+        if (--outstanding > 0) return false;
+        cur++;
+        enter();
+        return true;
+    }
+};
+
+const unsigned int NO_PARENT = UINT_MAX; // the node is not reached from dest
+// the graph in compressed sparse row form: the neighbors of node u are adj[first[u]], ..., adj[first[u + 1] - 1]
+// they keep the order of the neighbor lists in the stat packets, so dijkstra pushes them in the same order as before
+class CsrGraph {
+public:
+    vector<unsigned int> first; // nodeNum() + 1 offsets into adj
+    vector<unsigned int> adj; // the neighbor at the other end of each link
+    vector<unsigned int> weight; // the weight of the link to adj[k]
+    unsigned int minWeight = UINT_MAX; // the smallest weight of all links
+
+    CsrGraph() : first(1, 0) {}
+    CsrGraph(const map<unsigned int, vector<pair<unsigned int, unsigned int>>>& nodes, unsigned int nodeCnt) {
+        for (auto& i : nodes) {
+            nodeCnt = max(nodeCnt, i.first + 1);
+            for (auto& j : i.second)
+                nodeCnt = max(nodeCnt, j.first + 1);
+        }
+        first.assign(nodeCnt + 1, 0);
+        for (auto& i : nodes)
+            first[i.first + 1] = i.second.size();
+        for (unsigned int u = 0; u < nodeCnt; u++)
+            first[u + 1] += first[u];
+        adj.resize(first[nodeCnt]);
+        weight.resize(first[nodeCnt]);
+        for (auto& i : nodes) {
+            unsigned int k = first[i.first];
+            for (auto& j : i.second) {
+                adj[k] = j.first;
+                weight[k++] = j.second;
+                minWeight = min(minWeight, j.second);
+            }
+        }
+    }
+    unsigned int nodeNum() const { return first.size() - 1; }
+    bool sameLinks(const CsrGraph& g) const { return first == g.first && adj == g.adj; } // only the weights may differ
+};
+
+class LinkChange { // a link in the neighbor list of u whose weight changed
+public:
+    unsigned int u;
+    unsigned int v;
+    unsigned int weight; // the new weight
+    unsigned int oldWeight;
+};
+// the shortest-path tree toward dest; it is built by dijkstra() and then updated incrementally (Ramalingam-Reps style)
+// when only the link weights change, so the work depends on the nodes whose cost or next hop can change, not on the network size
+class ShortestPathTree {
+    vector<unsigned int> firstChild; // the children of each node in the tree, linked by nextSibling and prevSibling
+    vector<unsigned int> nextSibling;
+    vector<unsigned int> prevSibling;
+    vector<unsigned int> stamp; // the epoch in which the node was last visited
+    unsigned int epoch = 0;
+
+    void linkChild(unsigned int v); // add v to the children of table[v]
+    void unlinkChild(unsigned int v); // remove v from the children of table[v]
+    bool visit(unsigned int v) { // true at the first visit of v in the current epoch
+        if (stamp[v] == epoch) return false;
+        stamp[v] = epoch;
+        return true;
+    }
+    unsigned int nextHopOf(unsigned int v, const CsrGraph& graph) const;
+
+public:
+    unsigned int dest = 0;
+    vector<unsigned int> table; // next hop toward dest as dijkstra() gives it, NO_PARENT if not reached
+    vector<unsigned int> cost; // path cost toward dest, UINT_MAX if not reached
+
+    void build(unsigned int _dest, const CsrGraph& graph);
+    // graph already has the new weights of changes; changed gets the nodes whose next hop changed, in id order
+    // returns false if the tree cannot be updated (zero weights, or other nodes or links); build() it again then
+    bool update(const CsrGraph& graph, const vector<LinkChange>& changes, vector<unsigned int>& changed);
+};
+// the next hop of id in table; a node without a route reads as 0, as a missing key of the old map tables did
+unsigned int routeOf(const vector<unsigned int>& table, unsigned int id) {
+    return id < table.size() && table[id] != NO_PARENT ? table[id] : 0;
+}
+
 class SDN_controller : public node {
     // map<unsigned int,bool> one_hop_neighbors; // you can use this variable to record the node's 1-hop neighbors 
     map<unsigned int, vector<vector<Round > > >newRound; // update round of the route table
@@ -697,9 +863,12 @@ protected:
 
 
 public:
-    map<unsigned int, unsigned int> newCurRound;
-    vector<map<unsigned int, unsigned int> >tableList; // route table list for different dest
-    vector<map<unsigned int, unsigned int> >newTableList; // route table using new weight
+    vector<RoundTracker> newCurRound; // the progress of the update rounds of each dest
+    vector<vector<unsigned int> >tableList; // route table list for different dest
+    vector<vector<unsigned int> >newTableList; // route table using new weight
+    vector<ShortestPathTree> trees; // the tree of each dest, updated when the weights change
+    vector<vector<unsigned int> >changedRoutes; // the nodes whose next hop toward each dest changed, i.e., the Round entries that differ
+    CsrGraph treeGraph; // the graph of the trees
     vector<unsigned int> statReceived;
     map<unsigned int, vector<pair<unsigned int, unsigned int>>> nodes; // nodes list and their neighbor
     vector<unsigned int>destIds;
@@ -708,6 +877,13 @@ public:
     string type() { return "SDN_controller"; }
     void setNewRound(map<unsigned int, vector<vector<Round > > > _round) {
         newRound = _round;
+        newCurRound.clear();
+    }
+    // the tracker of the rounds of mat; it indexes the rounds at the first ack of mat
+    RoundTracker& trackerOf(vector<RoundTracker>& trackers, map<unsigned int, vector<vector<Round > > >& rounds, unsigned int mat) {
+        if (mat >= trackers.size()) trackers.resize(mat + 1);
+        if (!trackers[mat].tracking()) trackers[mat].track(rounds[mat]);
+        return trackers[mat];
     }
     // please define recv_handler function to deal with the incoming packet
     virtual void recv_handler(packet* p);
@@ -1648,9 +1824,10 @@ void SDN_switch::recv_handler(packet* p) {
         // cout << "node " << getNodeID() << " send the packet" << endl;
         SDN_data_packet* p2 = nullptr;
         p2 = dynamic_cast<SDN_data_packet*> (p);
-        if (p2->getHeader()->getDstID() == getNodeID() || checkDestNotExist(p2->getHeader()->getDstID()))return; // if dest does not exist or dest == current id do nothing
+        unsigned int nexID;
+        if (p2->getHeader()->getDstID() == getNodeID() || !get_next_node_of_dest(p2->getHeader()->getDstID(), nexID))return; // if dest does not exist or dest == current id do nothing
         p2->getHeader()->setPreID(getNodeID()); // get current node id
-        p2->getHeader()->setNexID(get_next_node_of_dest(p2->getHeader()->getDstID())); //get next node of dest from map and set to the header
+        p2->getHeader()->setNexID(nexID); // set the next node of dest found in the forwarding table to the header
         p2->getHeader()->setDstID(p2->getHeader()->getDstID());
         send_handler(p2);
     }
@@ -1728,8 +1905,25 @@ void SDN_switch::recv_handler(packet* p) {
 }
 
 class Node;
-void dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsigned int, vector<pair<unsigned int, unsigned int>>>& nodes, int nodeCnt);
-void calRound(map<unsigned int, unsigned int>& table, map<unsigned int, unsigned int>& newTable, unsigned int dest, vector < vector<Round > >& round);
+// run task(i) for every i in [0, taskCnt) on a pool of threads; the tasks are taken in order from a shared counter
+// each task must write only its own outputs, so the results do not depend on the number of threads
+template <typename Task>
+void parallelFor(unsigned int taskCnt, Task task) {
+    unsigned int threadCnt = min(max(thread::hardware_concurrency(), 1u), taskCnt);
+    atomic<unsigned int> next(0);
+    auto work = [&]() {
+        for (unsigned int i = next++; i < taskCnt; i = next++)
+            task(i);
+    };
+    vector<thread> pool;
+    for (unsigned int i = 1; i < threadCnt; i++)
+        pool.emplace_back(work);
+    work();
+    for (auto& t : pool)
+        t.join();
+}
+void dijkstra(vector<unsigned int>& table, vector<unsigned int>& cost, unsigned int dest, const CsrGraph& graph);
+void calRound(const vector<unsigned int>& table, const vector<unsigned int>& newTable, unsigned int dest, vector < vector<Round > >& round);
 void SDN_controller::recv_handler(packet* p) {
     if (p == nullptr) return;
 
@@ -1743,19 +1937,10 @@ void SDN_controller::recv_handler(packet* p) {
         SDN_ctrl_payload* l2 = nullptr;
         l2 = dynamic_cast<SDN_ctrl_payload*> (p2->getPayload());
         auto mat = l2->getMatID();
-        auto nowRound = newCurRound[mat];
-        // if (newCurRound[mat] >= newRound[mat].size())return;
-        for (long unsigned int i = 0; i < newRound[mat][newCurRound[mat]].size(); i++) {
-            if (newRound[mat][nowRound][i].target == p2->getHeader()->getSrcID()) { // find and update packet acknowledge state to 1
-                newRound[mat][nowRound][i].state = 1;
-                auto zeroFound = count_if(newRound[mat][newCurRound[mat]].begin(), newRound[mat][newCurRound[mat]].end(), [](Round r1) { return r1.state == 0; }); // if last round is all acknowledged, then generate next round
-                if (zeroFound == 0) { // if all acknowledged
-                    newCurRound[mat]++; // cur round ++
-                    if (newCurRound[mat] >= newRound[mat].size())return; // if no next round, then return
-                    for (auto j : newRound[mat][newCurRound[mat]]) {
-                        ctrl_packet_event(getNodeID(), j.target, j.match, j.action, event::getCurTime(), "update"); // generate next round update packet
-                    }
-                }
+        RoundTracker& tracker = trackerOf(newCurRound, newRound, mat);
+        if (tracker.ack(p2->getHeader()->getSrcID()) && !tracker.finished()) { // if the round is all acknowledged, then generate next round
+            for (auto j : newRound[mat][tracker.current()]) {
+                ctrl_packet_event(getNodeID(), j.target, j.match, j.action, event::getCurTime(), "update"); // generate next round update packet
             }
         }
     }
@@ -1783,13 +1968,16 @@ void SDN_controller::recv_handler(packet* p) {
         else
             statReceived[p4->getHeader()->getSrcID()] = 3; // else is update packet
         if (count(statReceived.begin(), statReceived.end(), 1) == getNodeNum() - 1) { // if all state == 1
-            for (unsigned int i = 0; i < destIds.size(); i++) {
-                dijkstra(tableList[i], destIds[i], nodes, getNodeNum() - 1); // shortest path algorithm, using old weight
-            }
+            treeGraph = CsrGraph(nodes, getNodeNum() - 1);
+            trees.resize(destIds.size());
+            parallelFor(destIds.size(), [&](unsigned int i) { // the trees of the destinations are independent
+                trees[i].build(destIds[i], treeGraph); // shortest path algorithm, using old weight
+                tableList[i] = trees[i].table;
+            });
             for (unsigned int id = 0; id < node::getNodeNum() - 1; id++) {
                 for (unsigned int i = 0; i < destIds.size(); i++) {
                     if (id == destIds[i])continue;
-                    ctrl_packet_event(getNodeID(), id, destIds[i], tableList[i][id]); // generate all insert ctrl packet
+                    ctrl_packet_event(getNodeID(), id, destIds[i], routeOf(tableList[i], id)); // generate all insert ctrl packet
                 }
             }
             for (auto& j : statReceived) {
@@ -1797,10 +1985,42 @@ void SDN_controller::recv_handler(packet* p) {
             }
         }
         else if (count(statReceived.begin(), statReceived.end(), 3) == getNodeNum() - 1) { // if all state == 3
+            CsrGraph graph(nodes, getNodeNum() - 1);
+            // only the links whose weight changed are handed to the trees, unless the links themselves changed
+            bool incremental = graph.sameLinks(treeGraph);
+            vector<LinkChange> changes;
+            for (unsigned int u = 0; incremental && u < graph.nodeNum(); u++) {
+                for (unsigned int k = graph.first[u]; k < graph.first[u + 1]; k++) {
+                    if (graph.weight[k] != treeGraph.weight[k])
+                        changes.push_back({ u, graph.adj[k], graph.weight[k], treeGraph.weight[k] });
+                }
+            }
+            changedRoutes.assign(destIds.size(), {});
+            // a destination listed twice appends to the same rounds, so its trees are built by one task in the input order
+            vector<vector<unsigned int> > destTasks;
+            map<unsigned int, unsigned int> taskOfDest;
             for (unsigned int i = 0; i < destIds.size(); i++) {
-                dijkstra(newTableList[i], destIds[i], nodes, getNodeNum() - 1); // shortest path algorithm, using new weight
-                calRound(tableList[i], newTableList[i], destIds[i], newRound[destIds[i]]); // calculate round
+                if (taskOfDest.find(destIds[i]) == taskOfDest.end()) {
+                    taskOfDest[destIds[i]] = destTasks.size();
+                    destTasks.push_back({});
+                    newRound[destIds[i]]; // create the entry before the threads use it
+                }
+                destTasks[taskOfDest[destIds[i]]].push_back(i);
             }
+            parallelFor(destTasks.size(), [&](unsigned int task) {
+                for (auto i : destTasks[task]) {
+                    if (!incremental || !trees[i].update(graph, changes, changedRoutes[i])) {
+                        trees[i].build(destIds[i], graph); // shortest path algorithm, using new weight
+                        for (unsigned int id = 0; id < trees[i].table.size(); id++) {
+                            if (routeOf(tableList[i], id) != routeOf(trees[i].table, id))
+                                changedRoutes[i].push_back(id);
+                        }
+                    }
+                    newTableList[i] = trees[i].table;
+                    calRound(tableList[i], newTableList[i], destIds[i], newRound.find(destIds[i])->second); // calculate round
+                }
+            });
+            treeGraph = graph;
             for (auto i : destIds) {
                 for (auto k : newRound[i][0]) {
                     ctrl_packet_event(getNodeID(), k.target, k.match, k.action, event::getCurTime(), "update"); // generate only first round
@@ -1814,6 +2034,125 @@ void SDN_controller::recv_handler(packet* p) {
     }
 }
 
+void ShortestPathTree::linkChild(unsigned int v) {
+    unsigned int p = table[v];
+    prevSibling[v] = NO_PARENT;
+    nextSibling[v] = firstChild[p];
+    if (firstChild[p] != NO_PARENT) prevSibling[firstChild[p]] = v;
+    firstChild[p] = v;
+}
+void ShortestPathTree::unlinkChild(unsigned int v) {
+    if (prevSibling[v] != NO_PARENT) nextSibling[prevSibling[v]] = nextSibling[v];
+    else firstChild[table[v]] = nextSibling[v];
+    if (nextSibling[v] != NO_PARENT) prevSibling[nextSibling[v]] = prevSibling[v];
+}
+// with positive weights, dijkstra() picks the smallest id among the neighbors on a shortest path (CompareOld),
+// since all of them are selected before v; the links are symmetric, so the neighbor list of v has the same weights
+unsigned int ShortestPathTree::nextHopOf(unsigned int v, const CsrGraph& graph) const {
+    unsigned int next = NO_PARENT;
+    if (cost[v] == UINT_MAX) return next;
+    for (unsigned int k = graph.first[v]; k < graph.first[v + 1]; k++) {
+        unsigned int u = graph.adj[k];
+        if (cost[u] != UINT_MAX && cost[u] + graph.weight[k] == cost[v] && u < next)
+            next = u;
+    }
+    return next;
+}
+void ShortestPathTree::build(unsigned int _dest, const CsrGraph& graph) {
+    dest = _dest;
+    dijkstra(table, cost, dest, graph);
+    unsigned int nodeNum = table.size();
+    firstChild.assign(nodeNum, NO_PARENT);
+    nextSibling.assign(nodeNum, NO_PARENT);
+    prevSibling.assign(nodeNum, NO_PARENT);
+    stamp.assign(nodeNum, 0);
+    epoch = 0;
+    for (unsigned int v = 0; v < nodeNum; v++) {
+        if (v != dest && table[v] != NO_PARENT)
+            linkChild(v);
+    }
+}
+bool ShortestPathTree::update(const CsrGraph& graph, const vector<LinkChange>& changes, vector<unsigned int>& changed) {
+    if (graph.minWeight == 0 || graph.nodeNum() != table.size()) return false; // zero weights break the tie rule of nextHopOf
+    vector<unsigned int> affected; // the nodes which lost their paths
+    vector<unsigned int> todo;
+    // 1. a heavier tree link cuts the subtree below it; its nodes forget their costs
+    for (auto& c : changes) {
+        if (c.weight <= c.oldWeight || c.v == dest || table[c.v] != c.u || cost[c.v] == UINT_MAX) continue;
+        todo.push_back(c.v);
+        while (!todo.empty()) {
+            unsigned int x = todo.back();
+            todo.pop_back();
+            cost[x] = UINT_MAX;
+            affected.push_back(x);
+            for (unsigned int y = firstChild[x]; y != NO_PARENT; y = nextSibling[y])
+                if (cost[y] != UINT_MAX) todo.push_back(y);
+        }
+    }
+    // 2. the cut nodes restart from their neighbors outside the cut subtrees, and lighter links shorten the paths through them
+    priority_queue<pair<unsigned int, unsigned int>, vector<pair<unsigned int, unsigned int> >, greater<pair<unsigned int, unsigned int> > > pq;
+    vector<pair<unsigned int, unsigned int> > seeds;
+    for (auto x : affected) {
+        unsigned int best = UINT_MAX;
+        for (unsigned int k = graph.first[x]; k < graph.first[x + 1]; k++) {
+            unsigned int y = graph.adj[k];
+            if (cost[y] != UINT_MAX && cost[y] + graph.weight[k] < best)
+                best = cost[y] + graph.weight[k];
+        }
+        if (best != UINT_MAX) seeds.push_back({ best, x });
+    }
+    for (auto& seed : seeds) {
+        cost[seed.second] = seed.first;
+        pq.push(seed);
+    }
+    for (auto& c : changes) {
+        if (c.weight >= c.oldWeight || cost[c.u] == UINT_MAX || cost[c.u] + c.weight >= cost[c.v]) continue;
+        cost[c.v] = cost[c.u] + c.weight;
+        pq.push({ cost[c.v], c.v });
+    }
+    // 3. spread the new costs like dijkstra
+    vector<unsigned int> moved = affected; // the nodes whose cost may have changed
+    while (!pq.empty()) {
+        auto top = pq.top();
+        pq.pop();
+        unsigned int x = top.second;
+        if (top.first != cost[x]) continue; // an older entry of x
+        moved.push_back(x);
+        for (unsigned int k = graph.first[x]; k < graph.first[x + 1]; k++) {
+            unsigned int y = graph.adj[k];
+            if (top.first + graph.weight[k] < cost[y]) {
+                cost[y] = top.first + graph.weight[k];
+                pq.push({ cost[y], y });
+            }
+        }
+    }
+    // 4. the next hop can only change at the moved nodes, at their neighbors and at the ends of the changed links
+    epoch++;
+    vector<unsigned int> touched;
+    auto touch = [&](unsigned int v) { if (visit(v)) touched.push_back(v); };
+    for (auto x : moved) {
+        touch(x);
+        for (unsigned int k = graph.first[x]; k < graph.first[x + 1]; k++)
+            touch(graph.adj[k]);
+    }
+    for (auto& c : changes) {
+        touch(c.u);
+        touch(c.v);
+    }
+    changed.clear();
+    for (auto v : touched) {
+        if (v == dest) continue;
+        unsigned int next = nextHopOf(v, graph);
+        if (next == table[v]) continue;
+        if (table[v] != NO_PARENT) unlinkChild(v);
+        table[v] = next;
+        if (next != NO_PARENT) linkChild(v);
+        changed.push_back(v);
+    }
+    sort(changed.begin(), changed.end());
+    return true;
+}
+
 // hw1
 class Link { // input links
 public:
@@ -1851,16 +2190,24 @@ public:
         return b.oldWeight < a.oldWeight;
     }
 };
-void dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsigned int, vector<pair<unsigned int, unsigned int>>>& nodes, int nodeCnt) {
-    map<unsigned int, unsigned int> cost; // path cost for each point
-    priority_queue<pqLink, vector<pqLink>, CompareOld> oldPq; // two priority for using different compare function
-    vector<bool> selected; // node selected already
+// dijkstra toward dest; table[v] is the next hop of v (NO_PARENT if v is not reached) and table[dest] = dest
+// cost[v] is the path cost of v (UINT_MAX if v is not reached)
+// the pushes and the comparisons are the same as with the old map tables, so ties are broken the same way
+// graph is only read, so the trees of different destinations can be built at the same time
+void dijkstra(vector<unsigned int>& table, vector<unsigned int>& cost, unsigned int dest, const CsrGraph& graph) {
+    unsigned int nodeNum = graph.nodeNum();
+    cost.assign(nodeNum, UINT_MAX); // path cost for each point
+    vector<char> selected(nodeNum, false); // node selected already
+    vector<pqLink> heap; // the storage of the priority queue; one push per link at most
+    heap.reserve(graph.adj.size());
+    priority_queue<pqLink, vector<pqLink>, CompareOld> oldPq(CompareOld(), move(heap));
     pqLink current;
-    selected.resize(nodeCnt);
+    table.assign(nodeNum, NO_PARENT);
     table[dest] = dest;
+    cost[dest] = 0;
     selected[dest] = true;
-    for (auto i : nodes[dest]) {
-        oldPq.push({ dest, i.first, i.second }); // push all neighbors of dest
+    for (unsigned int k = graph.first[dest]; k < graph.first[dest + 1]; k++) {
+        oldPq.push({ dest, graph.adj[k], graph.weight[k] }); // push all neighbors of dest
     }
     while (!oldPq.empty()) {
         current = oldPq.top(); // get top of pq and pop
@@ -1870,35 +2217,41 @@ void dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<uns
         cost[current.to] = current.oldWeight; // upsate cost
 
         selected[current.to] = true; // update selected
-        for (auto i : nodes[current.to]) { // push all neighbors of the popped node
-            if (!selected[i.first]) { // check if not selected
-                oldPq.push({ current.to, i.first, i.second + (int)cost[current.to] });
+        for (unsigned int k = graph.first[current.to]; k < graph.first[current.to + 1]; k++) { // push all neighbors of the popped node
+            if (!selected[graph.adj[k]]) { // check if not selected
+                oldPq.push({ current.to, graph.adj[k], graph.weight[k] + cost[current.to] });
             }
         }
     }
 
 }
 
-void calRound(map<unsigned int, unsigned int>& table, map<unsigned int, unsigned int>& newTable, unsigned int dest, vector < vector<Round > >& round) {
+void calRound(const vector<unsigned int>& table, const vector<unsigned int>& newTable, unsigned int dest, vector < vector<Round > >& round) {
     // calculate depth for table and set round
+    // a node is one deeper than its next hop, so the walk toward dest stops at the first node whose depth is known
+    // and every depth is counted once
+    const unsigned int UNKNOWN = UINT_MAX;
     unsigned maxDepth = 0;
-    map<unsigned int, unsigned int> depth;
+    vector<unsigned int> depth(newTable.size(), UNKNOWN);
+    vector<unsigned int> path; // the walked nodes whose depth is not known yet
     depth[dest] = 0;
-    for (auto i : newTable) {
-        unsigned int depthCnt = 0;
+    for (unsigned int i = 0; i < newTable.size(); i++) {
+        if (newTable[i] == NO_PARENT)continue; // not reached from dest
         unsigned int currentNode;
-        currentNode = i.first;
-        while (currentNode != dest) {
-            depthCnt++;
+        currentNode = i;
+        while (depth[currentNode] == UNKNOWN) {
+            path.push_back(currentNode);
             currentNode = newTable[currentNode];
         }
-        depth[i.first] = depthCnt;
-        if (depthCnt > maxDepth)maxDepth = depthCnt;
+        unsigned int depthCnt = depth[currentNode];
+        for (; !path.empty(); path.pop_back())
+            depth[path.back()] = ++depthCnt;
+        if (depth[i] > maxDepth)maxDepth = depth[i];
     }
     round.resize(maxDepth);
-    for (auto i : depth) {
-        if (i.first == dest)continue;
-        round[i.second - 1].push_back({ i.first, dest, newTable[i.first], 0 });
+    for (unsigned int i = 0; i < newTable.size(); i++) {
+        if (i == dest || newTable[i] == NO_PARENT)continue;
+        round[depth[i] - 1].push_back({ i, dest, newTable[i], 0 });
     }
 
 }
@@ -2,6 +2,10 @@
 #include <vector>
 #include <queue>
 #include <map>
+#include <climits>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 using namespace std;
 
@@ -14,19 +18,6 @@ public:
     int newWeight;
 };
 
-class Neighbor { // neighbor and weight between
-public:
-    unsigned int id;
-    int oldWeight;
-    int newWeight;
-};
-
-class Node { // node and it's neighbor list
-public:
-    unsigned int id;
-    vector<Neighbor>neighbors;
-};
-
 class pqLink { // structure for dijkstra priority queue
 public:
     unsigned int from;
@@ -49,17 +40,77 @@ public:
         return b.newWeight < a.newWeight;
     }
 };
-int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsigned int, Node>& nodes, int nodeCnt, bool newWeight) {
-    map<unsigned int, unsigned int> cost; // path cost for each point
-    priority_queue<pqLink, vector<pqLink>, CompareOld> oldPq; // two priority for using different compare function
-    priority_queue<pqLink, vector<pqLink>, CompareNew> newPq;
-    vector<bool> selected; // node selected already
+// run task(i) for every i in [0, taskCnt) on a pool of threads; the tasks are taken in order from a shared counter
+// each task must write only its own outputs, so the results do not depend on the number of threads
+template <typename Task>
+void parallelFor(unsigned int taskCnt, Task task) {
+    unsigned int threadCnt = min(max(thread::hardware_concurrency(), 1u), taskCnt);
+    atomic<unsigned int> next(0);
+    auto work = [&]() {
+        for (unsigned int i = next++; i < taskCnt; i = next++)
+            task(i);
+    };
+    vector<thread> pool;
+    for (unsigned int i = 1; i < threadCnt; i++)
+        pool.emplace_back(work);
+    work();
+    for (auto& t : pool)
+        t.join();
+}
+const unsigned int NO_PARENT = UINT_MAX; // the node is not reached from dest
+// the graph in compressed sparse row form: the neighbors of node u are adj[first[u]], ..., adj[first[u + 1] - 1]
+// they keep the input order of the links, so dijkstra pushes them in the same order as the old neighbor lists
+class CsrGraph {
+public:
+    vector<unsigned int> first; // nodeNum() + 1 offsets into adj
+    vector<unsigned int> adj; // the neighbor at the other end of each link
+    vector<int> oldWeight; // the weights of the link to adj[k]
+    vector<int> newWeight;
+
+    CsrGraph(const vector<Link>& links, unsigned int nodeCnt) {
+        for (auto& l : links)
+            nodeCnt = max(nodeCnt, max(l.nodeA, l.nodeB) + 1);
+        first.assign(nodeCnt + 1, 0);
+        for (auto& l : links) { // count the degrees
+            first[l.nodeA + 1]++;
+            first[l.nodeB + 1]++;
+        }
+        for (unsigned int u = 0; u < nodeCnt; u++)
+            first[u + 1] += first[u];
+        adj.resize(first[nodeCnt]);
+        oldWeight.resize(first[nodeCnt]);
+        newWeight.resize(first[nodeCnt]);
+        vector<unsigned int> next(first.begin(), first.end() - 1); // the next free slot of each node
+        for (auto& l : links) {
+            unsigned int k = next[l.nodeA]++;
+            adj[k] = l.nodeB, oldWeight[k] = l.oldWeight, newWeight[k] = l.newWeight;
+            k = next[l.nodeB]++;
+            adj[k] = l.nodeA, oldWeight[k] = l.oldWeight, newWeight[k] = l.newWeight;
+        }
+    }
+    unsigned int nodeNum() const { return first.size() - 1; }
+};
+// the next hop of id in table; a node without a route reads as 0, as a missing key of the old map tables did
+unsigned int routeOf(const vector<unsigned int>& table, unsigned int id) {
+    return id < table.size() && table[id] != NO_PARENT ? table[id] : 0;
+}
+// dijkstra toward dest; table[v] is the next hop of v (NO_PARENT if v is not reached) and table[dest] = dest
+// the pushes and the comparisons are the same as with the old map tables, so ties are broken the same way
+// graph is only read, so the trees of different destinations can be built at the same time
+int dijkstra(vector<unsigned int>& table, unsigned int dest, const CsrGraph& graph, bool newWeight) {
+    unsigned int nodeNum = graph.nodeNum();
+    vector<int> cost(nodeNum, 0); // path cost for each point
+    vector<char> selected(nodeNum, false); // node selected already
+    vector<pqLink> heap; // the storage of the priority queue; one push per link at most
+    heap.reserve(graph.adj.size());
     pqLink current;
-    selected.resize(nodeCnt);
+    table.assign(nodeNum, NO_PARENT);
+    table[dest] = dest;
     if (!newWeight) { // if comparing old weight
+        priority_queue<pqLink, vector<pqLink>, CompareOld> oldPq(CompareOld(), move(heap)); // two priority for using different compare function
         selected[dest] = true;
-        for (auto i : nodes[dest].neighbors) {
-            oldPq.push({ dest, i.id, i.oldWeight, i.newWeight }); // push all neighbors of dest
+        for (unsigned int k = graph.first[dest]; k < graph.first[dest + 1]; k++) {
+            oldPq.push({ dest, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] }); // push all neighbors of dest
         }
         while (!oldPq.empty()) {
             current = oldPq.top(); // get top of pq and pop
@@ -69,17 +120,17 @@ int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsi
             cost[current.to] = current.oldWeight; // upsate cost
 
             selected[current.to] = true; // update selected
-            for (auto i : nodes[current.to].neighbors) { // push all neighbors of the popped node
-                if (!selected[i.id]) // check if not selected
-                    oldPq.push({ current.to, i.id, i.oldWeight + (int)cost[current.to] , i.newWeight });
+            for (unsigned int k = graph.first[current.to]; k < graph.first[current.to + 1]; k++) { // push all neighbors of the popped node
+                if (!selected[graph.adj[k]]) // check if not selected
+                    oldPq.push({ current.to, graph.adj[k], graph.oldWeight[k] + cost[current.to], graph.newWeight[k] });
             }
-
         }
     }
     else {
+        priority_queue<pqLink, vector<pqLink>, CompareNew> newPq(CompareNew(), move(heap));
         selected[dest] = true;
-        for (auto i : nodes[dest].neighbors) {
-            newPq.push({ dest, i.id, i.oldWeight, i.newWeight });
+        for (unsigned int k = graph.first[dest]; k < graph.first[dest + 1]; k++) {
+            newPq.push({ dest, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] });
         }
         while (!newPq.empty()) {
             current = newPq.top();
@@ -89,11 +140,10 @@ int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsi
             cost[current.to] = current.newWeight;
 
             selected[current.to] = true;
-            for (auto i : nodes[current.to].neighbors) {
-                if (!selected[i.id])
-                    newPq.push({ current.to, i.id, i.oldWeight  , i.newWeight + (int)cost[current.to] });
+            for (unsigned int k = graph.first[current.to]; k < graph.first[current.to + 1]; k++) {
+                if (!selected[graph.adj[k]])
+                    newPq.push({ current.to, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] + cost[current.to] });
             }
-
         }
     }
     return 1;
@@ -101,9 +151,8 @@ int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsi
 
 int main(int argc, char** argv) {
     vector<Link> links; // save input
-    map<unsigned int, Node> nodes; // nodes list and their neighbor
-    vector<map<unsigned int, unsigned int>>tableList; // route table list for different dest
-    vector<map<unsigned int, unsigned int>>newTableList; // route table using new weight
+    vector<vector<unsigned int>>tableList; // route table list for different dest
+    vector<vector<unsigned int>>newTableList; // route table using new weight
     unsigned int nodeCnt, destCnt, linkCnt;
     vector<unsigned int> dests; // destination list
 
@@ -119,34 +168,31 @@ int main(int argc, char** argv) {
         cin >> link.linkId >> link.nodeA >> link.nodeB >> link.oldWeight >> link.newWeight;
         links.push_back(link);
     }
-    for (auto i : links) { // build node list and their neighbors
-        nodes[i.nodeA].neighbors.push_back({ i.nodeB, i.oldWeight, i.newWeight });
-        nodes[i.nodeB].neighbors.push_back({ i.nodeA, i.oldWeight, i.newWeight });
-    }
+    CsrGraph graph(links, nodeCnt); // build node list and their neighbors
     tableList.resize(destCnt); // resize the table
     newTableList.resize(destCnt);
-    for (unsigned int i = 0; i < destCnt; i++) {
-        dijkstra(tableList[i], dests[i], nodes, nodeCnt, false); // shortest path algorithm, using old weight
-    }
-    for (unsigned int i = 0; i < destCnt; i++) {
-        dijkstra(newTableList[i], dests[i], nodes, nodeCnt, true); // new weight
-    }
+    parallelFor(2 * destCnt, [&](unsigned int i) { // every (dest, weight) tree is independent
+        if (i < destCnt)
+            dijkstra(tableList[i], dests[i], graph, false); // shortest path algorithm, using old weight
+        else
+            dijkstra(newTableList[i - destCnt], dests[i - destCnt], graph, true); // new weight
+    });
     for (unsigned int i = 0; i < nodeCnt; i++) { // print old route table
         cout << i << endl;
         for (unsigned int j = 0; j < destCnt; j++) {
             if (dests[j] != i)
-                cout << dests[j] << " " << tableList[j][i] << endl;
+                cout << dests[j] << " " << routeOf(tableList[j], i) << endl;
         }
     }
     for (unsigned int i = 0; i < nodeCnt; i++) { // print changed route
         int first = 1;
         for (unsigned int j = 0; j < destCnt; j++) {
-            if (tableList[j][i] != newTableList[j][i]) {
+            if (routeOf(tableList[j], i) != routeOf(newTableList[j], i)) {
                 if (first == 1) {   // print node id only at the first time
                     cout << i << endl;
                     first = 0;
                 }
-                cout << dests[j] << " " << newTableList[j][i] << endl;
+                cout << dests[j] << " " << routeOf(newTableList[j], i) << endl;
             }
         }
     }
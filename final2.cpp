@@ -1,2710 +1,5663 @@
-#include <iostream>
-#include <map>
-#include <queue>
-#include <utility>
-#include <climits>
-#include <functional>
-#include <iomanip>
-#include <stack>
-
-using namespace std;
-
-#define SET(func_name, type, var_name, _var_name) \
-    void func_name(type _var_name) { var_name = _var_name; }
-#define GET(func_name, type, var_name) \
-    type func_name() const { return var_name; }
-
-class header;
-class payload;
-class packet;
-class node;
-class event;
-class link; // new
-
-// for simplicity, we use a const int to simulate the delay
-// if you want to simulate the more details, you should revise it to be a class
-const unsigned int ONE_HOP_DELAY = 10;
-const unsigned int BROCAST_ID = UINT_MAX;
-
-// BROCAST_ID means that all neighbors are receivers; UINT_MAX is the maximum value of unsigned int
-
-class header {
-public:
-    virtual ~header() {}
-
-    SET(setSrcID, unsigned int, srcID, _srcID);
-    SET(setDstID, unsigned int, dstID, _dstID);
-    SET(setPreID, unsigned int, preID, _preID);
-    SET(setNexID, unsigned int, nexID, _nexID);
-    GET(getSrcID, unsigned int, srcID);
-    GET(getDstID, unsigned int, dstID);
-    GET(getPreID, unsigned int, preID);
-    GET(getNexID, unsigned int, nexID);
-
-    virtual string type() = 0;
-
-    // factory concept: generate a header
-    class header_generator {
-        // lock the copy constructor
-        header_generator(header_generator&) {}
-        // store all possible types of header
-        static map<string, header_generator*> prototypes;
-
-    protected:
-        // allow derived class to use it
-        header_generator() {}
-        // after you create a new header type, please register the factory of this header type by this function
-        void register_header_type(header_generator* h) { prototypes[h->type()] = h; }
-        // you have to implement your own generate() to generate your header
-        virtual header* generate() = 0;
-
-    public:
-        // you have to implement your own type() to return your header type
-        virtual string type() = 0;
-        // this function is used to generate any type of header derived
-        static header* generate(string type) {
-            if (prototypes.find(type) != prototypes.end()) {                                        // if this type derived exists
-                return prototypes[type]->generate(); // generate it!!
-            }
-            std::cerr << "no such header type" << std::endl; // otherwise
-            return nullptr;
-        }
-        static void print() {
-            cout << "registered header types: " << endl;
-            for (map<string, header::header_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
-                cout << it->second->type() << endl;
-        }
-        virtual ~header_generator() {};
-    };
-
-protected:
-    header() : srcID(BROCAST_ID), dstID(BROCAST_ID), preID(BROCAST_ID), nexID(BROCAST_ID) {} // this constructor cannot be directly called by users
-
-private:
-    unsigned int srcID;
-    unsigned int dstID;
-    unsigned int preID;
-    unsigned int nexID;
-    header(header&) {} // this constructor cannot be directly called by users
-};
-map<string, header::header_generator*> header::header_generator::prototypes;
-
-class SDN_data_header : public header {
-    SDN_data_header(SDN_data_header&) {} // cannot be called by users
-
-protected:
-    SDN_data_header() {} // this constructor cannot be directly called by users
-
-public:
-    ~SDN_data_header() {}
-    string type() { return "SDN_data_header"; }
-
-    class SDN_data_header_generator;
-    friend class SDN_data_header_generator;
-    // SDN_data_header_generator is derived from header_generator to generate a header
-    class SDN_data_header_generator : public header_generator {
-        static SDN_data_header_generator sample;
-        // this constructor is only for sample to register this header type
-        SDN_data_header_generator() { /*cout << "SDN_data_header registered" << endl;*/
-            register_header_type(&sample);
-        }
-
-    protected:
-        virtual header* generate() {
-            // cout << "SDN_data_header generated" << endl;
-            return new SDN_data_header;
-        }
-
-    public:
-        virtual string type() { return "SDN_data_header"; }
-        ~SDN_data_header_generator() {}
-    };
-};
-SDN_data_header::SDN_data_header_generator SDN_data_header::SDN_data_header_generator::sample;
-
-class SDN_ctrl_header : public header {
-    SDN_ctrl_header(SDN_ctrl_header&) {} // cannot be called by users
-
-protected:
-    SDN_ctrl_header() {} // this constructor cannot be directly called by users
-
-public:
-    ~SDN_ctrl_header() {}
-    string type() { return "SDN_ctrl_header"; }
-
-    class SDN_ctrl_header_generator;
-    friend class SDN_ctrl_header_generator;
-    // SDN_ctrl_header_generator is derived from header_generator to generate a header
-    class SDN_ctrl_header_generator : public header_generator {
-        static SDN_ctrl_header_generator sample;
-        // this constructor is only for sample to register this header type
-        SDN_ctrl_header_generator() { /*cout << "SDN_ctrl_header registered" << endl;*/
-            register_header_type(&sample);
-        }
-
-    protected:
-        virtual header* generate() {
-            // cout << "SDN_ctrl_header generated" << endl;
-            return new SDN_ctrl_header;
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_header"; }
-        ~SDN_ctrl_header_generator() {}
-    };
-};
-SDN_ctrl_header::SDN_ctrl_header_generator SDN_ctrl_header::SDN_ctrl_header_generator::sample;
-
-class payload {
-    payload(payload&) {} // this constructor cannot be directly called by users
-
-    string msg;
-
-protected:
-    payload() {}
-
-public:
-    virtual ~payload() {}
-    virtual string type() = 0;
-
-    SET(setMsg, string, msg, _msg);
-    GET(getMsg, string, msg);
-
-    class payload_generator {
-        // lock the copy constructor
-        payload_generator(payload_generator&) {}
-        // store all possible types of header
-        static map<string, payload_generator*> prototypes;
-
-    protected:
-        // allow derived class to use it
-        payload_generator() {}
-        // after you create a new payload type, please register the factory of this payload type by this function
-        void register_payload_type(payload_generator* h) { prototypes[h->type()] = h; }
-        // you have to implement your own generate() to generate your payload
-        virtual payload* generate() = 0;
-
-    public:
-        // you have to implement your own type() to return your header type
-        virtual string type() = 0;
-        // this function is used to generate any type of header derived
-        static payload* generate(string type) {
-            if (prototypes.find(type) != prototypes.end()) {                                        // if this type derived exists
-                return prototypes[type]->generate(); // generate it!!
-            }
-            std::cerr << "no such payload type" << std::endl; // otherwise
-            return nullptr;
-        }
-        static void print() {
-            cout << "registered payload types: " << endl;
-            for (map<string, payload::payload_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
-                cout << it->second->type() << endl;
-        }
-        virtual ~payload_generator() {};
-    };
-};
-map<string, payload::payload_generator*> payload::payload_generator::prototypes;
-
-class SDN_data_payload : public payload {
-    SDN_data_payload(SDN_data_payload&) {}
-
-protected:
-    SDN_data_payload() {} // this constructor cannot be directly called by users
-public:
-    ~SDN_data_payload() {}
-
-    string type() { return "SDN_data_payload"; }
-
-    class SDN_data_payload_generator;
-    friend class SDN_data_payload_generator;
-    // SDN_data_payload is derived from payload_generator to generate a payload
-    class SDN_data_payload_generator : public payload_generator {
-        static SDN_data_payload_generator sample;
-        // this constructor is only for sample to register this payload type
-        SDN_data_payload_generator() { /*cout << "SDN_data_payload registered" << endl;*/
-            register_payload_type(&sample);
-        }
-
-    protected:
-        virtual payload* generate() {
-            // cout << "SDN_data_payload generated" << endl;
-            return new SDN_data_payload;
-        }
-
-    public:
-        virtual string type() { return "SDN_data_payload"; }
-        ~SDN_data_payload_generator() {}
-    };
-};
-SDN_data_payload::SDN_data_payload_generator SDN_data_payload::SDN_data_payload_generator::sample;
-
-class SDN_ctrl_payload : public payload {
-    SDN_ctrl_payload(SDN_ctrl_payload&) {}
-
-    unsigned int matID; // match: target
-    unsigned int actID; // action: the next hop
-
-protected:
-    SDN_ctrl_payload() {} // this constructor cannot be directly called by users
-public:
-    ~SDN_ctrl_payload() {}
-
-    string type() { return "SDN_ctrl_payload"; }
-
-    SET(setMatID, unsigned int, matID, _matID);
-    GET(getMatID, unsigned int, matID);
-    SET(setActID, unsigned int, actID, _actID);
-    GET(getActID, unsigned int, actID);
-
-    class SDN_ctrl_payload_generator;
-    friend class SDN_ctrl_payload_generator;
-    // SDN_data_payload is derived from payload_generator to generate a payload
-    class SDN_ctrl_payload_generator : public payload_generator {
-        static SDN_ctrl_payload_generator sample;
-        // this constructor is only for sample to register this payload type
-        SDN_ctrl_payload_generator() { /*cout << "SDN_ctrl_payload registered" << endl;*/
-            register_payload_type(&sample);
-        }
-
-    protected:
-        virtual payload* generate() {
-            // cout << "SDN_ctrl_payload generated" << endl;
-            return new SDN_ctrl_payload;
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_payload"; }
-        ~SDN_ctrl_payload_generator() {}
-    };
-};
-SDN_ctrl_payload::SDN_ctrl_payload_generator SDN_ctrl_payload::SDN_ctrl_payload_generator::sample;
-
-class packet {
-    // a packet usually contains a header and a payload
-    header* hdr;
-    payload* pld;
-    unsigned int p_id;
-    static unsigned int last_packet_id;
-
-    packet(packet&) {}
-    static int live_packet_num;
-
-protected:
-    // these constructors cannot be directly called by users
-    packet() : hdr(nullptr), pld(nullptr) {
-        p_id = last_packet_id++;
-        live_packet_num++;
-    }
-    packet(string _hdr, string _pld, bool rep = false, unsigned int rep_id = 0) {
-        if (!rep) // a duplicated packet does not have a new packet id
-            p_id = last_packet_id++;
-        else
-            p_id = rep_id;
-        hdr = header::header_generator::generate(_hdr);
-        pld = payload::payload_generator::generate(_pld);
-        live_packet_num++;
-    }
-
-public:
-    virtual ~packet() {
-        // cout << "packet destructor begin" << endl;
-        if (hdr != nullptr)
-            delete hdr;
-        if (pld != nullptr)
-            delete pld;
-        live_packet_num--;
-        // cout << "packet destructor end" << endl;
-    }
-
-    SET(setHeader, header*, hdr, _hdr);
-    GET(getHeader, header*, hdr);
-    SET(setPayload, payload*, pld, _pld);
-    GET(getPayload, payload*, pld);
-    GET(getPacketID, unsigned int, p_id);
-
-    static void discard(packet*& p) {
-        // cout << "checking" << endl;
-        if (p != nullptr) {
-            // cout << "discarding" << endl;
-            // cout << p->type() << endl;
-            delete p;
-            // cout << "discarded" << endl;
-        }
-        p = nullptr;
-        // cout << "checked" << endl;
-    }
-    virtual string type() = 0;
-
-    static int getLivePacketNum() { return live_packet_num; }
-
-    class packet_generator;
-    friend class packet_generator;
-    class packet_generator {
-        // lock the copy constructor
-        packet_generator(packet_generator&) {}
-        // store all possible types of packet
-        static map<string, packet_generator*> prototypes;
-
-    protected:
-        // allow derived class to use it
-        packet_generator() {}
-        // after you create a new packet type, please register the factory of this payload type by this function
-        void register_packet_type(packet_generator* h) { prototypes[h->type()] = h; }
-        // you have to implement your own generate() to generate your payload
-        virtual packet* generate(packet* p = nullptr) = 0;
-
-    public:
-        // you have to implement your own type() to return your packet type
-        virtual string type() = 0;
-        // this function is used to generate any type of packet derived
-        static packet* generate(string type) {
-            if (prototypes.find(type) != prototypes.end()) {                                        // if this type derived exists
-                return prototypes[type]->generate(); // generate it!!
-            }
-            std::cerr << "no such packet type" << std::endl; // otherwise
-            return nullptr;
-        }
-        static packet* replicate(packet* p) {
-            if (prototypes.find(p->type()) != prototypes.end()) {                                              // if this type derived exists
-                return prototypes[p->type()]->generate(p); // generate it!!
-            }
-            std::cerr << "no such packet type" << std::endl; // otherwise
-            return nullptr;
-        }
-        static void print() {
-            cout << "registered packet types: " << endl;
-            for (map<string, packet::packet_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
-                cout << it->second->type() << endl;
-        }
-        virtual ~packet_generator() {};
-    };
-};
-map<string, packet::packet_generator*> packet::packet_generator::prototypes;
-unsigned int packet::last_packet_id = 0;
-int packet::live_packet_num = 0;
-
-// this packet is used to tell the destination the msg
-class SDN_data_packet : public packet {
-    SDN_data_packet(SDN_data_packet&) {}
-
-protected:
-    SDN_data_packet() {} // this constructor cannot be directly called by users
-    SDN_data_packet(packet* p) : packet(p->getHeader()->type(), p->getPayload()->type(), true, p->getPacketID()) {
-        *(dynamic_cast<SDN_data_header*>(this->getHeader())) = *(dynamic_cast<SDN_data_header*>(p->getHeader()));
-        *(dynamic_cast<SDN_data_payload*>(this->getPayload())) = *(dynamic_cast<SDN_data_payload*>(p->getPayload()));
-        // DFS_path = (dynamic_cast<SDN_data_header*>(p))->DFS_path;
-        // isVisited = (dynamic_cast<SDN_data_header*>(p))->isVisited;
-    } // for duplicate
-    SDN_data_packet(string _h, string _p) : packet(_h, _p) {}
-
-public:
-    virtual ~SDN_data_packet() {}
-    string type() { return "SDN_data_packet"; }
-
-    class SDN_data_packet_generator;
-    friend class SDN_data_packet_generator;
-    // SDN_data_packet is derived from packet_generator to generate a pub packet
-    class SDN_data_packet_generator : public packet_generator {
-        static SDN_data_packet_generator sample;
-        // this constructor is only for sample to register this packet type
-        SDN_data_packet_generator() { /*cout << "SDN_data_packet registered" << endl;*/
-            register_packet_type(&sample);
-        }
-
-    protected:
-        virtual packet* generate(packet* p = nullptr) {
-            // cout << "SDN_data_packet generated" << endl;
-            if (nullptr == p)
-                return new SDN_data_packet("SDN_data_header", "SDN_data_payload");
-            else
-                return new SDN_data_packet(p); // duplicate
-        }
-
-    public:
-        virtual string type() { return "SDN_data_packet"; }
-        ~SDN_data_packet_generator() {}
-    };
-};
-SDN_data_packet::SDN_data_packet_generator SDN_data_packet::SDN_data_packet_generator::sample;
-
-class SDN_ctrl_packet : public packet {
-    SDN_ctrl_packet(SDN_ctrl_packet&) {}
-
-protected:
-    SDN_ctrl_packet() {} // this constructor cannot be directly called by users
-    SDN_ctrl_packet(packet* p) : packet(p->getHeader()->type(), p->getPayload()->type(), true, p->getPacketID()) {
-        *(dynamic_cast<SDN_ctrl_header*>(this->getHeader())) = *(dynamic_cast<SDN_ctrl_header*>(p->getHeader()));
-        *(dynamic_cast<SDN_ctrl_payload*>(this->getPayload())) = *(dynamic_cast<SDN_ctrl_payload*>(p->getPayload()));
-        // DFS_path = (dynamic_cast<SDN_ctrl_header*>(p))->DFS_path;
-        // isVisited = (dynamic_cast<SDN_ctrl_header*>(p))->isVisited;
-    } // for duplicate
-    SDN_ctrl_packet(string _h, string _p) : packet(_h, _p) {}
-
-public:
-    virtual ~SDN_ctrl_packet() {}
-    string type() { return "SDN_ctrl_packet"; }
-
-    class SDN_ctrl_packet_generator;
-    friend class SDN_ctrl_packet_generator;
-    // SDN_ctrl_packet is derived from packet_generator to generate a pub packet
-    class SDN_ctrl_packet_generator : public packet_generator {
-        static SDN_ctrl_packet_generator sample;
-        // this constructor is only for sample to register this packet type
-        SDN_ctrl_packet_generator() { /*cout << "SDN_ctrl_packet registered" << endl;*/
-            register_packet_type(&sample);
-        }
-
-    protected:
-        virtual packet* generate(packet* p = nullptr) {
-            // cout << "SDN_ctrl_packet generated" << endl;
-            if (nullptr == p)
-                return new SDN_ctrl_packet("SDN_ctrl_header", "SDN_ctrl_payload");
-            else
-                return new SDN_ctrl_packet(p); // duplicate
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_packet"; }
-        ~SDN_ctrl_packet_generator() {}
-    };
-};
-SDN_ctrl_packet::SDN_ctrl_packet_generator SDN_ctrl_packet::SDN_ctrl_packet_generator::sample;
-
-class node {
-    // all nodes created in the program
-    static map<unsigned int, node*> id_node_table;
-
-    unsigned int id;
-    map<unsigned int, bool> phy_neighbors;
-
-protected:
-    node(node&) {} // this constructor should not be used
-    node() {}       // this constructor should not be used
-    node(unsigned int _id) : id(_id) { id_node_table[_id] = this; }
-
-public:
-    virtual ~node() { // erase the node
-        id_node_table.erase(id);
-    }
-    virtual string type() = 0; // please define it in your derived node class
-
-    void add_phy_neighbor(unsigned int _id, string link_type = "simple_link"); // we only add a directed link from id to _id
-    void del_phy_neighbor(unsigned int _id);                                   // we only delete a directed link from id to _id
-
-    // you can use the function to get the node's neigbhors at this time
-    // but in the project 3, you are not allowed to use this function
-    const map<unsigned int, bool>& getPhyNeighbors() {
-        return phy_neighbors;
-    }
-
-    void recv(packet* p) {
-        packet* tp = p;
-        recv_handler(tp);
-        packet::discard(p);
-    } // the packet will be directly deleted after the handler
-    void send(packet* p);
-
-    // receive the packet and do something; this is a pure virtual function
-    virtual void recv_handler(packet* p) = 0;
-    void send_handler(packet* P);
-
-    static node* id_to_node(unsigned int _id) { return ((id_node_table.find(_id) != id_node_table.end()) ? id_node_table[_id] : nullptr); }
-    GET(getNodeID, unsigned int, id);
-
-    static void del_node(unsigned int _id) {
-        if (id_node_table.find(_id) != id_node_table.end())
-            id_node_table.erase(_id);
-    }
-    static unsigned int getNodeNum() { return id_node_table.size(); }
-
-    class node_generator {
-        // lock the copy constructor
-        node_generator(node_generator&) {}
-        // store all possible types of node
-        static map<string, node_generator*> prototypes;
-
-    protected:
-        // allow derived class to use it
-        node_generator() {}
-        // after you create a new node type, please register the factory of this node type by this function
-        void register_node_type(node_generator* h) { prototypes[h->type()] = h; }
-        // you have to implement your own generate() to generate your node
-        virtual node* generate(unsigned int _id) = 0;
-
-    public:
-        // you have to implement your own type() to return your node type
-        virtual string type() = 0;
-        // this function is used to generate any type of node derived
-        static node* generate(string type, unsigned int _id) {
-            if (id_node_table.find(_id) != id_node_table.end()) {
-                std::cerr << "duplicate node id" << std::endl; // node id is duplicated
-                return nullptr;
-            }
-            else if (BROCAST_ID == _id) {
-                cerr << "BROCAST_ID cannot be used" << endl;
-                return nullptr;
-            }
-            else if (prototypes.find(type) != prototypes.end()) { // if this type derived exists
-                node* created_node = prototypes[type]->generate(_id);
-                return created_node; // generate it!!
-            }
-            std::cerr << "no such node type" << std::endl; // otherwise
-            return nullptr;
-        }
-        static void print() {
-            cout << "registered node types: " << endl;
-            for (map<string, node::node_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
-                cout << it->second->type() << endl;
-        }
-        virtual ~node_generator() {};
-    };
-};
-map<string, node::node_generator*> node::node_generator::prototypes;
-map<unsigned int, node*> node::id_node_table;
-
-class SDN_switch : public node {
-    // map<unsigned int,bool> one_hop_neighbors; // you can use this variable to record the node's 1-hop neighbors
-
-    // bool hi; // this is used for example; you can remove it when doing hw2
-
-protected:
-    SDN_switch() {}                             // it should not be used
-    SDN_switch(SDN_switch&) {}                 // it should not be used
-    SDN_switch(unsigned int _id) : node(_id) {} // this constructor cannot be directly called by users
-
-public:
-    ~SDN_switch() {}
-    string type() { return "SDN_switch"; }
-
-    map<unsigned int, unsigned> routing_table;
-
-    // please define recv_handler function to deal with the incoming packet
-    virtual void recv_handler(packet* p);
-
-    // void add_one_hop_neighbor (unsigned int n_id) { one_hop_neighbors[n_id] = true; }
-    // unsigned int get_one_hop_neighbor_num () { return one_hop_neighbors.size(); }
-
-    class SDN_switch_generator;
-    friend class SDN_switch_generator;
-    // SDN_switch is derived from node_generator to generate a node
-    class SDN_switch_generator : public node_generator {
-        static SDN_switch_generator sample;
-        // this constructor is only for sample to register this node type
-        SDN_switch_generator() { /*cout << "SDN_switch registered" << endl;*/
-            register_node_type(&sample);
-        }
-
-    protected:
-        virtual node* generate(unsigned int _id) { /*cout << "SDN_switch generated" << endl;*/
-            return new SDN_switch(_id);
-        }
-
-    public:
-        virtual string type() { return "SDN_switch"; }
-        ~SDN_switch_generator() {}
-    };
-};
-SDN_switch::SDN_switch_generator SDN_switch::SDN_switch_generator::sample;
-
-class SDN_controller : public node {
-    // map<unsigned int,bool> one_hop_neighbors; // you can use this variable to record the node's 1-hop neighbors
-
-    // bool hi; // this is used for example; you can remove it when doing hw2
-
-protected:
-    SDN_controller() {}                             // it should not be used
-    SDN_controller(SDN_controller&) {}             // it should not be used
-    SDN_controller(unsigned int _id) : node(_id) {} // this constructor cannot be directly called by users
-
-public:
-    ~SDN_controller() {}
-    string type() { return "SDN_controller"; }
-
-    // please define recv_handler function to deal with the incoming packet
-    virtual void recv_handler(packet* p);
-
-    // void add_one_hop_neighbor (unsigned int n_id) { one_hop_neighbors[n_id] = true; }
-    // unsigned int get_one_hop_neighbor_num () { return one_hop_neighbors.size(); }
-
-    class SDN_controller_generator;
-    friend class SDN_controller_generator;
-    // SDN_controller is derived from node_generator to generate a node
-    class SDN_controller_generator : public node_generator {
-        static SDN_controller_generator sample;
-        // this constructor is only for sample to register this node type
-        SDN_controller_generator() { /*cout << "SDN_controller registered" << endl;*/
-            register_node_type(&sample);
-        }
-
-    protected:
-        virtual node* generate(unsigned int _id) { /*cout << "SDN_controller generated" << endl;*/
-            return new SDN_controller(_id);
-        }
-
-    public:
-        virtual string type() { return "SDN_controller"; }
-        ~SDN_controller_generator() {}
-    };
-};
-SDN_controller::SDN_controller_generator SDN_controller::SDN_controller_generator::sample;
-
-class mycomp {
-    bool reverse;
-
-public:
-    mycomp(const bool& revparam = false) { reverse = revparam; }
-    bool operator()(const event* lhs, const event* rhs) const;
-};
-
-class event {
-    event(event*&) {} // this constructor cannot be directly called by users
-    static priority_queue<event*, vector<event*>, mycomp> events;
-    static unsigned int cur_time; // timer
-    static unsigned int end_time;
-
-    // get the next event
-    static event* get_next_event();
-    static void add_event(event* e) { events.push(e); }
-    static hash<string> event_seq;
-
-protected:
-    unsigned int trigger_time;
-
-    event() {} // it should not be used
-    event(unsigned int _trigger_time) : trigger_time(_trigger_time) {}
-
-public:
-    virtual void trigger() = 0;
-    virtual ~event() {}
-
-    virtual unsigned int event_priority() const = 0;
-    unsigned int get_hash_value(string string_for_hash) const {
-        unsigned int priority = event_seq(string_for_hash);
-        return priority;
-    }
-
-    static void flush_events(); // only for debug
-
-    GET(getTriggerTime, unsigned int, trigger_time);
-
-    static void start_simulate(unsigned int _end_time); // the function is used to start the simulation
-
-    static unsigned int getCurTime() { return cur_time; }
-    static void getCurTime(unsigned int _cur_time) { cur_time = _cur_time; }
-    // static unsigned int getEndTime() { return end_time ; }
-    // static void getEndTime(unsigned int _end_time) { end_time = _end_time; }
-
-    virtual void print() const = 0; // the function is used to print the event information
-
-    class event_generator {
-        // lock the copy constructor
-        event_generator(event_generator&) {}
-        // store all possible types of event
-        static map<string, event_generator*> prototypes;
-
-    protected:
-        // allow derived class to use it
-        event_generator() {}
-        // after you create a new event type, please register the factory of this event type by this function
-        void register_event_type(event_generator* h) { prototypes[h->type()] = h; }
-        // you have to implement your own generate() to generate your event
-        virtual event* generate(unsigned int _trigger_time, void* data) = 0;
-
-    public:
-        // you have to implement your own type() to return your event type
-        virtual string type() = 0;
-        // this function is used to generate any type of event derived
-        static event* generate(string type, unsigned int _trigger_time, void* data) {
-            if (prototypes.find(type) != prototypes.end()) { // if this type derived exists
-                event* e = prototypes[type]->generate(_trigger_time, data);
-                add_event(e);
-                return e; // generate it!!
-            }
-            std::cerr << "no such event type" << std::endl; // otherwise
-            return nullptr;
-        }
-        static void print() {
-            cout << "registered event types: " << endl;
-            for (map<string, event::event_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
-                cout << it->second->type() << endl;
-        }
-        virtual ~event_generator() {}
-    };
-};
-map<string, event::event_generator*> event::event_generator::prototypes;
-priority_queue<event*, vector<event*>, mycomp> event::events;
-hash<string> event::event_seq;
-
-unsigned int event::cur_time = 0;
-unsigned int event::end_time = 0;
-
-void event::flush_events() {
-    cout << "**flush begin" << endl;
-    while (!events.empty()) {
-        cout << setw(11) << events.top()->trigger_time << ": " << setw(11) << events.top()->event_priority() << endl;
-        delete events.top();
-        events.pop();
-    }
-    cout << "**flush end" << endl;
-}
-event* event::get_next_event() {
-    if (events.empty())
-        return nullptr;
-    event* e = events.top();
-    events.pop();
-    // cout << events.size() << " events remains" << endl;
-    return e;
-}
-void event::start_simulate(unsigned int _end_time) {
-    if (_end_time < 0) {
-        cerr << "you should give a possitive value of _end_time" << endl;
-        return;
-    }
-    end_time = _end_time;
-    event* e;
-    e = event::get_next_event();
-    while (e != nullptr && e->trigger_time <= end_time) {
-        if (cur_time <= e->trigger_time)
-            cur_time = e->trigger_time;
-        else {
-            cerr << "cur_time = " << cur_time << ", event trigger_time = " << e->trigger_time << endl;
-            break;
-        }
-
-        // cout << "event trigger_time = " << e->trigger_time << endl;
-        e->print(); // for log
-        // cout << " event begin" << endl;
-        e->trigger();
-        // cout << " event end" << endl;
-        delete e;
-        e = event::get_next_event();
-    }
-    // cout << "no more event" << endl;
-}
-
-bool mycomp::operator()(const event* lhs, const event* rhs) const {
-    // cout << lhs->getTriggerTime() << ", " << rhs->getTriggerTime() << endl;
-    // cout << lhs->type() << ", " << rhs->type() << endl;
-    unsigned int lhs_pri = lhs->event_priority();
-    unsigned int rhs_pri = rhs->event_priority();
-    // cout << "lhs hash = " << lhs_pri << endl;
-    // cout << "rhs hash = " << rhs_pri << endl;
-
-    if (reverse)
-        return ((lhs->getTriggerTime()) == (rhs->getTriggerTime())) ? (lhs_pri < rhs_pri) : ((lhs->getTriggerTime()) < (rhs->getTriggerTime()));
-    else
-        return ((lhs->getTriggerTime()) == (rhs->getTriggerTime())) ? (lhs_pri > rhs_pri) : ((lhs->getTriggerTime()) > (rhs->getTriggerTime()));
-}
-
-class recv_event : public event {
-public:
-    class recv_data; // forward declaration
-
-private:
-    recv_event(recv_event&) {} // this constructor cannot be used
-    recv_event() {}             // we don't allow users to new a recv_event by themselv
-    unsigned int senderID;      // the sender
-    unsigned int receiverID;    // the receiver; the packet will be given to the receiver
-    packet* pkt;                // the packet
-
-protected:
-    // this constructor cannot be directly called by users; only by generator
-    recv_event(unsigned int _trigger_time, void* data) : event(_trigger_time), senderID(BROCAST_ID), receiverID(BROCAST_ID), pkt(nullptr) {
-        recv_data* data_ptr = (recv_data*)data;
-        senderID = data_ptr->s_id;
-        receiverID = data_ptr->r_id; // the packet will be given to the receiver
-        pkt = data_ptr->_pkt;
-    }
-
-public:
-    virtual ~recv_event() {}
-    // recv_event will trigger the recv function
-    virtual void trigger();
-
-    unsigned int event_priority() const;
-
-    class recv_event_generator;
-    friend class recv_event_generator;
-    // recv_event is derived from event_generator to generate a event
-    class recv_event_generator : public event_generator {
-        static recv_event_generator sample;
-        // this constructor is only for sample to register this event type
-        recv_event_generator() { /*cout << "recv_event registered" << endl;*/
-            register_event_type(&sample);
-        }
-
-    protected:
-        virtual event* generate(unsigned int _trigger_time, void* data) {
-            // cout << "recv_event generated" << endl;
-            return new recv_event(_trigger_time, data);
-        }
-
-    public:
-        virtual string type() { return "recv_event"; }
-        ~recv_event_generator() {}
-    };
-    // this class is used to initialize the recv_event
-    class recv_data {
-    public:
-        unsigned int s_id;
-        unsigned int r_id;
-        packet* _pkt;
-    };
-
-    void print() const;
-};
-recv_event::recv_event_generator recv_event::recv_event_generator::sample;
-
-void recv_event::trigger() {
-    if (pkt == nullptr) {
-        cerr << "recv_event error: no pkt!" << endl;
-        return;
-    }
-    else if (node::id_to_node(receiverID) == nullptr) {
-        cerr << "recv_event error: no node " << receiverID << "!" << endl;
-        delete pkt;
-        return;
-    }
-    node::id_to_node(receiverID)->recv(pkt);
-}
-unsigned int recv_event::event_priority() const {
-    string string_for_hash;
-    string_for_hash = to_string(getTriggerTime()) + to_string(senderID) + to_string(receiverID) + to_string(pkt->getPacketID());
-    return get_hash_value(string_for_hash);
-}
-// the recv_event::print() function is used for log file
-void recv_event::print() const {
-    cout << "time " << setw(11) << event::getCurTime()
-        << "   recID" << setw(11) << receiverID
-        << "   pktID" << setw(11) << pkt->getPacketID()
-        << "   srcID" << setw(11) << pkt->getHeader()->getSrcID()
-        << "   dstID" << setw(11) << pkt->getHeader()->getDstID()
-        << "   preID" << setw(11) << pkt->getHeader()->getPreID()
-        << "   nexID" << setw(11) << pkt->getHeader()->getNexID()
-        << "   " << pkt->type()
-        << endl;
-    // cout << pkt->type()
-    //      << "   time "       << setw(11) << event::getCurTime()
-    //      << "   recID "      << setw(11) << receiverID
-    //      << "   pktID"       << setw(11) << pkt->getPacketID()
-    //      << "   srcID "      << setw(11) << pkt->getHeader()->getSrcID()
-    //      << "   dstID"       << setw(11) << pkt->getHeader()->getDstID()
-    //      << "   preID"       << setw(11) << pkt->getHeader()->getPreID()
-    //      << "   nexID"       << setw(11) << pkt->getHeader()->getNexID()
-    //      << endl;
-}
-
-class send_event : public event {
-public:
-    class send_data; // forward declaration
-
-private:
-    send_event(send_event&) {}
-    send_event() {} // we don't allow users to new a recv_event by themselves
-    // this constructor cannot be directly called by users; only by generator
-    unsigned int senderID;   // the sender
-    unsigned int receiverID; // the receiver
-    packet* pkt;             // the packet
-
-protected:
-    send_event(unsigned int _trigger_time, void* data) : event(_trigger_time), senderID(BROCAST_ID), receiverID(BROCAST_ID), pkt(nullptr) {
-        send_data* data_ptr = (send_data*)data;
-        senderID = data_ptr->s_id;
-        receiverID = data_ptr->r_id;
-        pkt = data_ptr->_pkt;
-    }
-
-public:
-    virtual ~send_event() {}
-    // send_event will trigger the send function
-    virtual void trigger();
-
-    unsigned int event_priority() const;
-
-    class send_event_generator;
-    friend class send_event_generator;
-    // send_event is derived from event_generator to generate a event
-    class send_event_generator : public event_generator {
-        static send_event_generator sample;
-        // this constructor is only for sample to register this event type
-        send_event_generator() { /*cout << "send_event registered" << endl;*/
-            register_event_type(&sample);
-        }
-
-    protected:
-        virtual event* generate(unsigned int _trigger_time, void* data) {
-            // cout << "send_event generated" << endl;
-            return new send_event(_trigger_time, data);
-        }
-
-    public:
-        virtual string type() { return "send_event"; }
-        ~send_event_generator() {}
-    };
-    // this class is used to initialize the send_event
-    class send_data {
-    public:
-        unsigned int s_id;
-        unsigned int r_id;
-        packet* _pkt;
-        unsigned int t;
-    };
-
-    void print() const;
-};
-send_event::send_event_generator send_event::send_event_generator::sample;
-
-void send_event::trigger() {
-    if (pkt == nullptr) {
-        cerr << "send_event error: no pkt!" << endl;
-        return;
-    }
-    else if (node::id_to_node(senderID) == nullptr) {
-        cerr << "send_event error: no node " << senderID << "!" << endl;
-        delete pkt;
-        return;
-    }
-    node::id_to_node(senderID)->send(pkt);
-}
-unsigned int send_event::event_priority() const {
-    string string_for_hash;
-    string_for_hash = to_string(getTriggerTime()) + to_string(senderID) + to_string(receiverID) + to_string(pkt->getPacketID());
-    return get_hash_value(string_for_hash);
-}
-// the send_event::print() function is used for log file
-void send_event::print() const {
-    cout << "time " << setw(11) << event::getCurTime()
-        << "   senID" << setw(11) << senderID
-        << "   pktID" << setw(11) << pkt->getPacketID()
-        << "   srcID" << setw(11) << pkt->getHeader()->getSrcID()
-        << "   dstID" << setw(11) << pkt->getHeader()->getDstID()
-        << "   preID" << setw(11) << pkt->getHeader()->getPreID()
-        << "   nexID" << setw(11) << pkt->getHeader()->getNexID()
-        << "   " << pkt->type()
-        //<< "   msg"         << setw(11) << dynamic_cast<SDN_data_payload*>(pkt->getPayload())->getMsg()
-        << endl;
-    // cout << pkt->type()
-    //      << "   time "       << setw(11) << event::getCurTime()
-    //      << "   senID "      << setw(11) << senderID
-    //      << "   pktID"       << setw(11) << pkt->getPacketID()
-    //      << "   srcID "      << setw(11) << pkt->getHeader()->getSrcID()
-    //      << "   dstID"       << setw(11) << pkt->getHeader()->getDstID()
-    //      << "   preID"       << setw(11) << pkt->getHeader()->getPreID()
-    //      << "   nexID"       << setw(11) << pkt->getHeader()->getNexID()
-    //      << endl;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-class SDN_data_pkt_gen_event : public event {
-public:
-    class gen_data; // forward declaration
-
-private:
-    SDN_data_pkt_gen_event(SDN_data_pkt_gen_event&) {}
-    SDN_data_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
-    // this constructor cannot be directly called by users; only by generator
-    unsigned int src; // the src
-    unsigned int dst; // the dst
-    // packet *pkt; // the packet
-    string msg;
-
-protected:
-    SDN_data_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
-        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
-        src = data_ptr->src_id;
-        dst = data_ptr->dst_id;
-        // pkt = data_ptr->_pkt;
-        msg = data_ptr->msg;
-    }
-
-public:
-    virtual ~SDN_data_pkt_gen_event() {}
-    // SDN_data_pkt_gen_event will trigger the packet gen function
-    virtual void trigger();
-
-    unsigned int event_priority() const;
-
-    class SDN_data_pkt_gen_event_generator;
-    friend class SDN_data_pkt_gen_event_generator;
-    // SDN_data_pkt_gen_event_generator is derived from event_generator to generate an event
-    class SDN_data_pkt_gen_event_generator : public event_generator {
-        static SDN_data_pkt_gen_event_generator sample;
-        // this constructor is only for sample to register this event type
-        SDN_data_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
-            register_event_type(&sample);
-        }
-
-    protected:
-        virtual event* generate(unsigned int _trigger_time, void* data) {
-            // cout << "send_event generated" << endl;
-            return new SDN_data_pkt_gen_event(_trigger_time, data);
-        }
-
-    public:
-        virtual string type() { return "SDN_data_pkt_gen_event"; }
-        ~SDN_data_pkt_gen_event_generator() {}
-    };
-    // this class is used to initialize the SDN_data_pkt_gen_event
-    class pkt_gen_data {
-    public:
-        unsigned int src_id;
-        unsigned int dst_id;
-        string msg;
-        // packet *_pkt;
-    };
-
-    void print() const;
-};
-SDN_data_pkt_gen_event::SDN_data_pkt_gen_event_generator SDN_data_pkt_gen_event::SDN_data_pkt_gen_event_generator::sample;
-
-void SDN_data_pkt_gen_event::trigger() {
-    if (node::id_to_node(src) == nullptr) {
-        cerr << "SDN_data_pkt_gen_event error: no node " << src << "!" << endl;
-        return;
-    }
-    else if (dst != BROCAST_ID && node::id_to_node(dst) == nullptr) {
-        cerr << "SDN_data_pkt_gen_event error: no node " << dst << "!" << endl;
-        return;
-    }
-
-    SDN_data_packet* pkt = dynamic_cast<SDN_data_packet*>(packet::packet_generator::generate("SDN_data_packet"));
-    if (pkt == nullptr) {
-        cerr << "packet type is incorrect" << endl;
-        return;
-    }
-    SDN_data_header* hdr = dynamic_cast<SDN_data_header*>(pkt->getHeader());
-    SDN_data_payload* pld = dynamic_cast<SDN_data_payload*>(pkt->getPayload());
-
-    if (hdr == nullptr) {
-        cerr << "header type is incorrect" << endl;
-        return;
-    }
-    if (pld == nullptr) {
-        cerr << "payload type is incorrect" << endl;
-        return;
-    }
-
-    hdr->setSrcID(src);
-    hdr->setDstID(dst);
-    hdr->setPreID(src); // this column is not important when the packet is first received by the src (i.e., just generated)
-    hdr->setNexID(src); // this column is not important when the packet is first received by the src (i.e., just generated)
-
-    pld->setMsg(msg);
-
-    recv_event::recv_data e_data;
-    e_data.s_id = src;
-    e_data.r_id = src; // to make the packet start from the src
-    e_data._pkt = pkt;
-
-    recv_event* e = dynamic_cast<recv_event*>(event::event_generator::generate("recv_event", trigger_time, (void*)&e_data));
-}
-unsigned int SDN_data_pkt_gen_event::event_priority() const {
-    string string_for_hash;
-    string_for_hash = to_string(getTriggerTime()) + to_string(src) + to_string(dst); // to_string (pkt->getPacketID());
-    return get_hash_value(string_for_hash);
-}
-// the SDN_data_pkt_gen_event::print() function is used for log file
-void SDN_data_pkt_gen_event::print() const {
-    cout << "time " << setw(11) << event::getCurTime()
-        << "        " << setw(11) << " "
-        << "        " << setw(11) << " "
-        << "   srcID" << setw(11) << src
-        << "   dstID" << setw(11) << dst
-        << "        " << setw(11) << " "
-        << "        " << setw(11) << " "
-        << "   SDN_data_packet generating"
-        << endl;
-}
-
-class SDN_ctrl_pkt_gen_event : public event {
-public:
-    class gen_data; // forward declaration
-
-private:
-    SDN_ctrl_pkt_gen_event(SDN_ctrl_pkt_gen_event&) {}
-    SDN_ctrl_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
-    // this constructor cannot be directly called by users; only by generator
-    unsigned int src; // the src
-    unsigned int dst; // the dst
-    unsigned int mat;
-    unsigned int act;
-    // packet *pkt; // the packet
-    string msg;
-
-protected:
-    SDN_ctrl_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
-        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
-        src = data_ptr->src_id;
-        dst = data_ptr->dst_id;
-        // pkt = data_ptr->_pkt;
-        mat = data_ptr->mat_id;
-        act = data_ptr->act_id;
-        msg = data_ptr->msg;
-    }
-
-public:
-    virtual ~SDN_ctrl_pkt_gen_event() {}
-    // SDN_ctrl_pkt_gen_event will trigger the packet gen function
-    virtual void trigger();
-
-    unsigned int event_priority() const;
-
-    class SDN_ctrl_pkt_gen_event_generator;
-    friend class SDN_ctrl_pkt_gen_event_generator;
-    // SDN_ctrl_pkt_gen_event_generator is derived from event_generator to generate an event
-    class SDN_ctrl_pkt_gen_event_generator : public event_generator {
-        static SDN_ctrl_pkt_gen_event_generator sample;
-        // this constructor is only for sample to register this event type
-        SDN_ctrl_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
-            register_event_type(&sample);
-        }
-
-    protected:
-        virtual event* generate(unsigned int _trigger_time, void* data) {
-            // cout << "send_event generated" << endl;
-            return new SDN_ctrl_pkt_gen_event(_trigger_time, data);
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_pkt_gen_event"; }
-        ~SDN_ctrl_pkt_gen_event_generator() {}
-    };
-    // this class is used to initialize the SDN_ctrl_pkt_gen_event
-    class pkt_gen_data {
-    public:
-        unsigned int src_id; // the controller
-        unsigned int dst_id; // the node that should update its rule
-        unsigned int mat_id; // the target of the rule
-        unsigned int act_id; // the next hop toward the target recorded in the rule
-        string msg;
-        // packet *_pkt;
-    };
-
-    void print() const;
-};
-SDN_ctrl_pkt_gen_event::SDN_ctrl_pkt_gen_event_generator SDN_ctrl_pkt_gen_event::SDN_ctrl_pkt_gen_event_generator::sample;
-
-void SDN_ctrl_pkt_gen_event::trigger() {
-    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
-        cerr << "SDN_ctrl_pkt_gen_event error: no node " << dst << "!" << endl;
-        return;
-    }
-
-    SDN_ctrl_packet* pkt = dynamic_cast<SDN_ctrl_packet*>(packet::packet_generator::generate("SDN_ctrl_packet"));
-    if (pkt == nullptr) {
-        cerr << "packet type is incorrect" << endl;
-        return;
-    }
-    SDN_ctrl_header* hdr = dynamic_cast<SDN_ctrl_header*>(pkt->getHeader());
-    SDN_ctrl_payload* pld = dynamic_cast<SDN_ctrl_payload*>(pkt->getPayload());
-
-    if (hdr == nullptr) {
-        cerr << "header type is incorrect" << endl;
-        return;
-    }
-    if (pld == nullptr) {
-        cerr << "payload type is incorrect" << endl;
-        return;
-    }
-
-    hdr->setSrcID(src);
-    hdr->setDstID(dst);
-    hdr->setPreID(src);
-    hdr->setNexID(src); // in hw3, you should set NexID to src
-    // payload
-    pld->setMsg(msg);
-    pld->setMatID(mat);
-    pld->setActID(act);
-
-    recv_event::recv_data e_data;
-    e_data.s_id = src;
-    e_data.r_id = src; // in hw3, you should set r_id it src
-    e_data._pkt = pkt;
-
-    recv_event* e = dynamic_cast<recv_event*>(event::event_generator::generate("recv_event", trigger_time, (void*)&e_data));
-}
-unsigned int SDN_ctrl_pkt_gen_event::event_priority() const {
-    string string_for_hash;
-    string_for_hash = to_string(getTriggerTime()) + to_string(src) + to_string(dst) + to_string(mat) + to_string(act); // to_string (pkt->getPacketID());
-    return get_hash_value(string_for_hash);
-}
-// the SDN_ctrl_pkt_gen_event::print() function is used for log file
-void SDN_ctrl_pkt_gen_event::print() const {
-    cout << "time " << setw(11) << event::getCurTime()
-        << "        " << setw(11) << " "
-        << "        " << setw(11) << " "
-        << "   srcID" << setw(11) << src
-        << "   dstID" << setw(11) << dst
-        << "   matID" << setw(11) << mat
-        << "   actID" << setw(11) << act
-        << "   SDN_ctrl_packet generating"
-        << endl;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-
-class link {
-    // all links created in the program
-    static map<pair<unsigned int, unsigned int>, link*> id_id_link_table;
-
-    unsigned int id1; // from
-    unsigned int id2; // to
-
-protected:
-    link(link&) {} // this constructor should not be used
-    link() {}       // this constructor should not be used
-    link(unsigned int _id1, unsigned int _id2) : id1(_id1), id2(_id2) { id_id_link_table[pair<unsigned int, unsigned int>(id1, id2)] = this; }
-
-public:
-    virtual ~link() {
-        id_id_link_table.erase(pair<unsigned int, unsigned int>(id1, id2)); // erase the link
-    }
-
-    static link* id_id_to_link(unsigned int _id1, unsigned int _id2) {
-        return ((id_id_link_table.find(pair<unsigned int, unsigned int>(_id1, _id2)) != id_id_link_table.end()) ? id_id_link_table[pair<unsigned, unsigned>(_id1, _id2)] : nullptr);
-    }
-
-    virtual double getLatency() = 0; // you must implement your own latency
-
-    static void del_link(unsigned int _id1, unsigned int _id2) {
-        pair<unsigned int, unsigned int> temp;
-        if (id_id_link_table.find(temp) != id_id_link_table.end())
-            id_id_link_table.erase(temp);
-    }
-
-    static unsigned int getLinkNum() { return id_id_link_table.size(); }
-
-    class link_generator {
-        // lock the copy constructor
-        link_generator(link_generator&) {}
-        // store all possible types of link
-        static map<string, link_generator*> prototypes;
-
-    protected:
-        // allow derived class to use it
-        link_generator() {}
-        // after you create a new link type, please register the factory of this link type by this function
-        void register_link_type(link_generator* h) { prototypes[h->type()] = h; }
-        // you have to implement your own generate() to generate your link
-        virtual link* generate(unsigned int _id1, unsigned int _id2) = 0;
-
-    public:
-        // you have to implement your own type() to return your link type
-        virtual string type() = 0;
-        // this function is used to generate any type of link derived
-        static link* generate(string type, unsigned int _id1, unsigned int _id2) {
-            if (id_id_link_table.find(pair<unsigned int, unsigned int>(_id1, _id2)) != id_id_link_table.end()) {
-                std::cerr << "duplicate link id" << std::endl; // link id is duplicated
-                return nullptr;
-            }
-            else if (BROCAST_ID == _id1 || BROCAST_ID == _id2) {
-                cerr << "BROCAST_ID cannot be used" << endl;
-                return nullptr;
-            }
-            else if (prototypes.find(type) != prototypes.end()) { // if this type derived exists
-                link* created_link = prototypes[type]->generate(_id1, _id2);
-                return created_link; // generate it!!
-            }
-            std::cerr << "no such link type" << std::endl; // otherwise
-            return nullptr;
-        }
-        static void print() {
-            cout << "registered link types: " << endl;
-            for (map<string, link::link_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
-                cout << it->second->type() << endl;
-        }
-        virtual ~link_generator() {};
-    };
-};
-map<string, link::link_generator*> link::link_generator::prototypes;
-map<pair<unsigned int, unsigned int>, link*> link::id_id_link_table;
-
-void node::add_phy_neighbor(unsigned int _id, string link_type) {
-    if (id == _id)
-        return; // if the two nodes are the same...
-    if (id_node_table.find(_id) == id_node_table.end())
-        return; // if this node does not exist
-    if (phy_neighbors.find(_id) != phy_neighbors.end())
-        return; // if this neighbor has been added
-    phy_neighbors[_id] = true;
-
-    link::link_generator::generate(link_type, id, _id);
-}
-void node::del_phy_neighbor(unsigned int _id) {
-    phy_neighbors.erase(_id);
-}
-
-class simple_link : public link {
-protected:
-    simple_link() {}                                                        // it should not be used outside the class
-    simple_link(simple_link&) {}                                           // it should not be used
-    simple_link(unsigned int _id1, unsigned int _id2) : link(_id1, _id2) {} // this constructor cannot be directly called by users
-
-public:
-    virtual ~simple_link() {}
-    virtual double getLatency() { return ONE_HOP_DELAY; } // you can implement your own latency
-
-    class simple_link_generator;
-    friend class simple_link_generator;
-    // simple_link is derived from link_generator to generate a link
-    class simple_link_generator : public link_generator {
-        static simple_link_generator sample;
-        // this constructor is only for sample to register this link type
-        simple_link_generator() { /*cout << "simple_link registered" << endl;*/
-            register_link_type(&sample);
-        }
-
-    protected:
-        virtual link* generate(unsigned int _id1, unsigned int _id2) { /*cout << "simple_link generated" << endl;*/
-            return new simple_link(_id1, _id2);
-        }
-
-    public:
-        virtual string type() { return "simple_link"; }
-        ~simple_link_generator() {}
-    };
-};
-simple_link::simple_link_generator simple_link::simple_link_generator::sample;
-
-///////////////// Final Exam ////////////////
-// ctrl new packet
-class SDN_ctrl_new_header : public header {
-    SDN_ctrl_new_header(SDN_ctrl_new_header&) {} // cannot be called by users
-
-protected:
-    SDN_ctrl_new_header() {} // this constructor cannot be directly called by users
-
-public:
-    ~SDN_ctrl_new_header() {}
-    string type() { return "SDN_ctrl_new_header"; }
-
-    class SDN_ctrl_new_header_generator;
-    friend class SDN_ctrl_new_header_generator;
-    // SDN_ctrl_new_header_generator is derived from header_generator to generate a header
-    class SDN_ctrl_new_header_generator : public header_generator {
-        static SDN_ctrl_new_header_generator sample;
-        // this constructor is only for sample to register this header type
-        SDN_ctrl_new_header_generator() { /*cout << "SDN_ctrl_new_header registered" << endl;*/
-            register_header_type(&sample);
-        }
-
-    protected:
-        virtual header* generate() {
-            // cout << "SDN_ctrl_new_header generated" << endl;
-            return new SDN_ctrl_new_header;
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_new_header"; }
-        ~SDN_ctrl_new_header_generator() {}
-    };
-};
-SDN_ctrl_new_header::SDN_ctrl_new_header_generator SDN_ctrl_new_header::SDN_ctrl_new_header_generator::sample;
-
-class SDN_ctrl_new_payload : public payload {
-    SDN_ctrl_new_payload(SDN_ctrl_new_payload&) {}
-
-    unsigned int matID; // match: target
-    unsigned int actID; // action: the next hop
-
-protected:
-    SDN_ctrl_new_payload() {} // this constructor cannot be directly called by users
-public:
-    ~SDN_ctrl_new_payload() {}
-
-    string type() { return "SDN_ctrl_new_payload"; }
-
-    SET(setMatID, unsigned int, matID, _matID);
-    GET(getMatID, unsigned int, matID);
-    SET(setActID, unsigned int, actID, _actID);
-    GET(getActID, unsigned int, actID);
-
-    class SDN_ctrl_new_payload_generator;
-    friend class SDN_ctrl_new_payload_generator;
-    // SDN_data_payload is derived from payload_generator to generate a payload
-    class SDN_ctrl_new_payload_generator : public payload_generator {
-        static SDN_ctrl_new_payload_generator sample;
-        // this constructor is only for sample to register this payload type
-        SDN_ctrl_new_payload_generator() { /*cout << "SDN_ctrl_new_payload registered" << endl;*/
-            register_payload_type(&sample);
-        }
-
-    protected:
-        virtual payload* generate() {
-            // cout << "SDN_ctrl_new_payload generated" << endl;
-            return new SDN_ctrl_new_payload;
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_new_payload"; }
-        ~SDN_ctrl_new_payload_generator() {}
-    };
-};
-SDN_ctrl_new_payload::SDN_ctrl_new_payload_generator SDN_ctrl_new_payload::SDN_ctrl_new_payload_generator::sample;
-
-class SDN_ctrl_new_packet : public packet {
-    SDN_ctrl_new_packet(SDN_ctrl_new_packet&) {}
-
-protected:
-    SDN_ctrl_new_packet() {} // this constructor cannot be directly called by users
-    SDN_ctrl_new_packet(packet* p) : packet(p->getHeader()->type(), p->getPayload()->type(), true, p->getPacketID()) {
-        *(dynamic_cast<SDN_ctrl_new_header*>(this->getHeader())) = *(dynamic_cast<SDN_ctrl_new_header*>(p->getHeader()));
-        *(dynamic_cast<SDN_ctrl_new_payload*>(this->getPayload())) = *(dynamic_cast<SDN_ctrl_new_payload*>(p->getPayload()));
-        // DFS_path = (dynamic_cast<SDN_ctrl_new_header*>(p))->DFS_path;
-        // isVisited = (dynamic_cast<SDN_ctrl_new_header*>(p))->isVisited;
-    } // for duplicate
-    SDN_ctrl_new_packet(string _h, string _p) : packet(_h, _p) {}
-
-public:
-    virtual ~SDN_ctrl_new_packet() {}
-    string type() { return "SDN_ctrl_new_packet"; }
-
-    class SDN_ctrl_new_packet_generator;
-    friend class SDN_ctrl_new_packet_generator;
-    // SDN_ctrl_new_packet is derived from packet_generator to generate a pub packet
-    class SDN_ctrl_new_packet_generator : public packet_generator {
-        static SDN_ctrl_new_packet_generator sample;
-        // this constructor is only for sample to register this packet type
-        SDN_ctrl_new_packet_generator() { /*cout << "SDN_ctrl_new_packet registered" << endl;*/
-            register_packet_type(&sample);
-        }
-
-    protected:
-        virtual packet* generate(packet* p = nullptr) {
-            // cout << "SDN_ctrl_new_packet generated" << endl;
-            if (nullptr == p)
-                return new SDN_ctrl_new_packet("SDN_ctrl_new_header", "SDN_ctrl_new_payload");
-            else
-                return new SDN_ctrl_new_packet(p); // duplicate
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_new_packet"; }
-        ~SDN_ctrl_new_packet_generator() {}
-    };
-};
-SDN_ctrl_new_packet::SDN_ctrl_new_packet_generator SDN_ctrl_new_packet::SDN_ctrl_new_packet_generator::sample;
-
-class SDN_ctrl_new_pkt_gen_event : public event {
-public:
-    class gen_data; // forward declaration
-
-private:
-    SDN_ctrl_new_pkt_gen_event(SDN_ctrl_new_pkt_gen_event&) {}
-    SDN_ctrl_new_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
-    // this constructor cannot be directly called by users; only by generator
-    unsigned int src; // the src
-    unsigned int dst; // the dst
-    unsigned int mat;
-    unsigned int act;
-    // packet *pkt; // the packet
-    string msg;
-
-protected:
-    SDN_ctrl_new_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
-        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
-        src = data_ptr->src_id;
-        dst = data_ptr->dst_id;
-        // pkt = data_ptr->_pkt;
-        mat = data_ptr->mat_id;
-        act = data_ptr->act_id;
-        msg = data_ptr->msg;
-    }
-
-public:
-    virtual ~SDN_ctrl_new_pkt_gen_event() {}
-    // SDN_ctrl_new_pkt_gen_event will trigger the packet gen function
-    virtual void trigger();
-
-    unsigned int event_priority() const;
-
-    class SDN_ctrl_new_pkt_gen_event_generator;
-    friend class SDN_ctrl_new_pkt_gen_event_generator;
-    // SDN_ctrl_new_pkt_gen_event_generator is derived from event_generator to generate an event
-    class SDN_ctrl_new_pkt_gen_event_generator : public event_generator {
-        static SDN_ctrl_new_pkt_gen_event_generator sample;
-        // this constructor is only for sample to register this event type
-        SDN_ctrl_new_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
-            register_event_type(&sample);
-        }
-
-    protected:
-        virtual event* generate(unsigned int _trigger_time, void* data) {
-            // cout << "send_event generated" << endl;
-            return new SDN_ctrl_new_pkt_gen_event(_trigger_time, data);
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_new_pkt_gen_event"; }
-        ~SDN_ctrl_new_pkt_gen_event_generator() {}
-    };
-    // this class is used to initialize the SDN_ctrl_new_pkt_gen_event
-    class pkt_gen_data {
-    public:
-        unsigned int src_id; // the controller
-        unsigned int dst_id; // the node that should update its rule
-        unsigned int mat_id; // the target of the rule
-        unsigned int act_id; // the next hop toward the target recorded in the rule
-        string msg;
-        // packet *_pkt;
-    };
-
-    void print() const;
-};
-SDN_ctrl_new_pkt_gen_event::SDN_ctrl_new_pkt_gen_event_generator SDN_ctrl_new_pkt_gen_event::SDN_ctrl_new_pkt_gen_event_generator::sample;
-void SDN_ctrl_new_pkt_gen_event::trigger() {
-    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
-        cerr << "SDN_ctrl_new_pkt_gen_event error: no node " << dst << "!" << endl;
-        return;
-    }
-
-    SDN_ctrl_new_packet* pkt = dynamic_cast<SDN_ctrl_new_packet*>(packet::packet_generator::generate("SDN_ctrl_new_packet"));
-    if (pkt == nullptr) {
-        cerr << "packet type is incorrect" << endl;
-        return;
-    }
-    SDN_ctrl_new_header* hdr = dynamic_cast<SDN_ctrl_new_header*>(pkt->getHeader());
-    SDN_ctrl_new_payload* pld = dynamic_cast<SDN_ctrl_new_payload*>(pkt->getPayload());
-
-    if (hdr == nullptr) {
-        cerr << "header type is incorrect" << endl;
-        return;
-    }
-    if (pld == nullptr) {
-        cerr << "payload type is incorrect" << endl;
-        return;
-    }
-
-    hdr->setSrcID(src);
-    hdr->setDstID(dst);
-    hdr->setPreID(src);
-    hdr->setNexID(src); // in hw3, you should set NexID to src
-    // payload
-    pld->setMsg(msg);
-    pld->setMatID(mat);
-    pld->setActID(act);
-
-    recv_event::recv_data e_data;
-    e_data.s_id = src;
-    e_data.r_id = src; // in hw3, you should set r_id it src
-    e_data._pkt = pkt;
-
-    recv_event* e = dynamic_cast<recv_event*>(event::event_generator::generate("recv_event", trigger_time, (void*)&e_data));
-}
-unsigned int SDN_ctrl_new_pkt_gen_event::event_priority() const {
-    string string_for_hash;
-    string_for_hash = to_string(getTriggerTime()) + to_string(src) + to_string(dst) + to_string(mat) + to_string(act); // to_string (pkt->getPacketID());
-    return get_hash_value(string_for_hash);
-}
-// the SDN_ctrl_new_pkt_gen_event::print() function is used for log file
-void SDN_ctrl_new_pkt_gen_event::print() const {
-    cout << "time " << setw(11) << event::getCurTime()
-        << "        " << setw(11) << " "
-        << "        " << setw(11) << " "
-        << "   srcID" << setw(11) << src
-        << "   dstID" << setw(11) << dst
-        << "   matID" << setw(11) << mat
-        << "   actID" << setw(11) << act
-        << "   SDN_ctrl_new_packet generating"
-        << endl;
-}
-void ctrl_new_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), string msg = "default") {
-    // void ctrl_new_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
-    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
-        cerr << "id is incorrect" << endl;
-        return;
-    }
-
-    unsigned int src = con_id;
-    SDN_ctrl_new_pkt_gen_event::pkt_gen_data e_data;
-    e_data.src_id = src;
-    e_data.dst_id = id;
-    e_data.mat_id = mat;
-    e_data.act_id = act;
-    e_data.msg = msg;
-
-    SDN_ctrl_new_pkt_gen_event* e = dynamic_cast<SDN_ctrl_new_pkt_gen_event*>(event::event_generator::generate("SDN_ctrl_new_pkt_gen_event", t, (void*)&e_data));
-    if (e == nullptr)
-        cerr << "event type is incorrect" << endl;
-}
-// ctrl delete packet
-class SDN_ctrl_del_header : public header {
-    SDN_ctrl_del_header(SDN_ctrl_del_header&) {} // cannot be called by users
-
-protected:
-    SDN_ctrl_del_header() {} // this constructor cannot be directly called by users
-
-public:
-    ~SDN_ctrl_del_header() {}
-    string type() { return "SDN_ctrl_del_header"; }
-
-    class SDN_ctrl_del_header_generator;
-    friend class SDN_ctrl_del_header_generator;
-    // SDN_ctrl_del_header_generator is derived from header_generator to generate a header
-    class SDN_ctrl_del_header_generator : public header_generator {
-        static SDN_ctrl_del_header_generator sample;
-        // this constructor is only for sample to register this header type
-        SDN_ctrl_del_header_generator() { /*cout << "SDN_ctrl_del_header registered" << endl;*/
-            register_header_type(&sample);
-        }
-
-    protected:
-        virtual header* generate() {
-            // cout << "SDN_ctrl_del_header generated" << endl;
-            return new SDN_ctrl_del_header;
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_del_header"; }
-        ~SDN_ctrl_del_header_generator() {}
-    };
-};
-SDN_ctrl_del_header::SDN_ctrl_del_header_generator SDN_ctrl_del_header::SDN_ctrl_del_header_generator::sample;
-
-class SDN_ctrl_del_payload : public payload {
-    SDN_ctrl_del_payload(SDN_ctrl_del_payload&) {}
-
-    unsigned int matID; // match: target
-    unsigned int actID; // action: the next hop
-
-protected:
-    SDN_ctrl_del_payload() {} // this constructor cannot be directly called by users
-public:
-    ~SDN_ctrl_del_payload() {}
-
-    string type() { return "SDN_ctrl_del_payload"; }
-
-    SET(setMatID, unsigned int, matID, _matID);
-    GET(getMatID, unsigned int, matID);
-    SET(setActID, unsigned int, actID, _actID);
-    GET(getActID, unsigned int, actID);
-
-    class SDN_ctrl_del_payload_generator;
-    friend class SDN_ctrl_del_payload_generator;
-    // SDN_data_payload is derived from payload_generator to generate a payload
-    class SDN_ctrl_del_payload_generator : public payload_generator {
-        static SDN_ctrl_del_payload_generator sample;
-        // this constructor is only for sample to register this payload type
-        SDN_ctrl_del_payload_generator() { /*cout << "SDN_ctrl_del_payload registered" << endl;*/
-            register_payload_type(&sample);
-        }
-
-    protected:
-        virtual payload* generate() {
-            // cout << "SDN_ctrl_del_payload generated" << endl;
-            return new SDN_ctrl_del_payload;
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_del_payload"; }
-        ~SDN_ctrl_del_payload_generator() {}
-    };
-};
-SDN_ctrl_del_payload::SDN_ctrl_del_payload_generator SDN_ctrl_del_payload::SDN_ctrl_del_payload_generator::sample;
-
-class SDN_ctrl_del_packet : public packet {
-    SDN_ctrl_del_packet(SDN_ctrl_del_packet&) {}
-
-protected:
-    SDN_ctrl_del_packet() {} // this constructor cannot be directly called by users
-    SDN_ctrl_del_packet(packet* p) : packet(p->getHeader()->type(), p->getPayload()->type(), true, p->getPacketID()) {
-        *(dynamic_cast<SDN_ctrl_del_header*>(this->getHeader())) = *(dynamic_cast<SDN_ctrl_del_header*>(p->getHeader()));
-        *(dynamic_cast<SDN_ctrl_del_payload*>(this->getPayload())) = *(dynamic_cast<SDN_ctrl_del_payload*>(p->getPayload()));
-        // DFS_path = (dynamic_cast<SDN_ctrl_del_header*>(p))->DFS_path;
-        // isVisited = (dynamic_cast<SDN_ctrl_del_header*>(p))->isVisited;
-    } // for duplicate
-    SDN_ctrl_del_packet(string _h, string _p) : packet(_h, _p) {}
-
-public:
-    virtual ~SDN_ctrl_del_packet() {}
-    string type() { return "SDN_ctrl_del_packet"; }
-
-    class SDN_ctrl_del_packet_generator;
-    friend class SDN_ctrl_del_packet_generator;
-    // SDN_ctrl_del_packet is derived from packet_generator to generate a pub packet
-    class SDN_ctrl_del_packet_generator : public packet_generator {
-        static SDN_ctrl_del_packet_generator sample;
-        // this constructor is only for sample to register this packet type
-        SDN_ctrl_del_packet_generator() { /*cout << "SDN_ctrl_del_packet registered" << endl;*/
-            register_packet_type(&sample);
-        }
-
-    protected:
-        virtual packet* generate(packet* p = nullptr) {
-            // cout << "SDN_ctrl_del_packet generated" << endl;
-            if (nullptr == p)
-                return new SDN_ctrl_del_packet("SDN_ctrl_del_header", "SDN_ctrl_del_payload");
-            else
-                return new SDN_ctrl_del_packet(p); // duplicate
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_del_packet"; }
-        ~SDN_ctrl_del_packet_generator() {}
-    };
-};
-SDN_ctrl_del_packet::SDN_ctrl_del_packet_generator SDN_ctrl_del_packet::SDN_ctrl_del_packet_generator::sample;
-
-class SDN_ctrl_del_pkt_gen_event : public event {
-public:
-    class gen_data; // forward declaration
-
-private:
-    SDN_ctrl_del_pkt_gen_event(SDN_ctrl_del_pkt_gen_event&) {}
-    SDN_ctrl_del_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
-    // this constructor cannot be directly called by users; only by generator
-    unsigned int src; // the src
-    unsigned int dst; // the dst
-    unsigned int mat;
-    unsigned int act;
-    // packet *pkt; // the packet
-    string msg;
-
-protected:
-    SDN_ctrl_del_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
-        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
-        src = data_ptr->src_id;
-        dst = data_ptr->dst_id;
-        // pkt = data_ptr->_pkt;
-        mat = data_ptr->mat_id;
-        act = data_ptr->act_id;
-        msg = data_ptr->msg;
-    }
-
-public:
-    virtual ~SDN_ctrl_del_pkt_gen_event() {}
-    // SDN_ctrl_del_pkt_gen_event will trigger the packet gen function
-    virtual void trigger();
-
-    unsigned int event_priority() const;
-
-    class SDN_ctrl_del_pkt_gen_event_generator;
-    friend class SDN_ctrl_del_pkt_gen_event_generator;
-    // SDN_ctrl_del_pkt_gen_event_generator is derived from event_generator to generate an event
-    class SDN_ctrl_del_pkt_gen_event_generator : public event_generator {
-        static SDN_ctrl_del_pkt_gen_event_generator sample;
-        // this constructor is only for sample to register this event type
-        SDN_ctrl_del_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
-            register_event_type(&sample);
-        }
-
-    protected:
-        virtual event* generate(unsigned int _trigger_time, void* data) {
-            // cout << "send_event generated" << endl;
-            return new SDN_ctrl_del_pkt_gen_event(_trigger_time, data);
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_del_pkt_gen_event"; }
-        ~SDN_ctrl_del_pkt_gen_event_generator() {}
-    };
-    // this class is used to initialize the SDN_ctrl_del_pkt_gen_event
-    class pkt_gen_data {
-    public:
-        unsigned int src_id; // the controller
-        unsigned int dst_id; // the node that should update its rule
-        unsigned int mat_id; // the target of the rule
-        unsigned int act_id; // the next hop toward the target recorded in the rule
-        string msg;
-        // packet *_pkt;
-    };
-
-    void print() const;
-};
-SDN_ctrl_del_pkt_gen_event::SDN_ctrl_del_pkt_gen_event_generator SDN_ctrl_del_pkt_gen_event::SDN_ctrl_del_pkt_gen_event_generator::sample;
-void SDN_ctrl_del_pkt_gen_event::trigger() {
-    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
-        cerr << "SDN_ctrl_del_pkt_gen_event error: no node " << dst << "!" << endl;
-        return;
-    }
-
-    SDN_ctrl_del_packet* pkt = dynamic_cast<SDN_ctrl_del_packet*>(packet::packet_generator::generate("SDN_ctrl_del_packet"));
-    if (pkt == nullptr) {
-        cerr << "packet type is incorrect" << endl;
-        return;
-    }
-    SDN_ctrl_del_header* hdr = dynamic_cast<SDN_ctrl_del_header*>(pkt->getHeader());
-    SDN_ctrl_del_payload* pld = dynamic_cast<SDN_ctrl_del_payload*>(pkt->getPayload());
-
-    if (hdr == nullptr) {
-        cerr << "header type is incorrect" << endl;
-        return;
-    }
-    if (pld == nullptr) {
-        cerr << "payload type is incorrect" << endl;
-        return;
-    }
-
-    hdr->setSrcID(src);
-    hdr->setDstID(dst);
-    hdr->setPreID(src);
-    hdr->setNexID(src); // in hw3, you should set NexID to src
-    // payload
-    pld->setMsg(msg);
-    pld->setMatID(mat);
-    pld->setActID(act);
-
-    recv_event::recv_data e_data;
-    e_data.s_id = src;
-    e_data.r_id = src; // in hw3, you should set r_id it src
-    e_data._pkt = pkt;
-
-    recv_event* e = dynamic_cast<recv_event*>(event::event_generator::generate("recv_event", trigger_time, (void*)&e_data));
-}
-unsigned int SDN_ctrl_del_pkt_gen_event::event_priority() const {
-    string string_for_hash;
-    string_for_hash = to_string(getTriggerTime()) + to_string(src) + to_string(dst) + to_string(mat) + to_string(act); // to_string (pkt->getPacketID());
-    return get_hash_value(string_for_hash);
-}
-// the SDN_ctrl_del_pkt_gen_event::print() function is used for log file
-void SDN_ctrl_del_pkt_gen_event::print() const {
-    cout << "time " << setw(11) << event::getCurTime()
-        << "        " << setw(11) << " "
-        << "        " << setw(11) << " "
-        << "   srcID" << setw(11) << src
-        << "   dstID" << setw(11) << dst
-        << "   matID" << setw(11) << mat
-        << "   actID" << setw(11) << act
-        << "   SDN_ctrl_del_packet generating"
-        << endl;
-}
-void ctrl_del_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), string msg = "default") {
-    // void ctrl_del_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
-    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
-        cerr << "id is incorrect" << endl;
-        return;
-    }
-
-    unsigned int src = con_id;
-    SDN_ctrl_del_pkt_gen_event::pkt_gen_data e_data;
-    e_data.src_id = src;
-    e_data.dst_id = id;
-    e_data.mat_id = mat;
-    e_data.act_id = act;
-    e_data.msg = msg;
-
-    SDN_ctrl_del_pkt_gen_event* e = dynamic_cast<SDN_ctrl_del_pkt_gen_event*>(event::event_generator::generate("SDN_ctrl_del_pkt_gen_event", t, (void*)&e_data));
-    if (e == nullptr)
-        cerr << "event type is incorrect" << endl;
-}
-// ctrl update packet
-class SDN_ctrl_upd_header : public header {
-    SDN_ctrl_upd_header(SDN_ctrl_upd_header&) {} // cannot be called by users
-
-protected:
-    SDN_ctrl_upd_header() {} // this constructor cannot be directly called by users
-
-public:
-    ~SDN_ctrl_upd_header() {}
-    string type() { return "SDN_ctrl_upd_header"; }
-
-    class SDN_ctrl_upd_header_generator;
-    friend class SDN_ctrl_upd_header_generator;
-    // SDN_ctrl_upd_header_generator is derived from header_generator to generate a header
-    class SDN_ctrl_upd_header_generator : public header_generator {
-        static SDN_ctrl_upd_header_generator sample;
-        // this constructor is only for sample to register this header type
-        SDN_ctrl_upd_header_generator() { /*cout << "SDN_ctrl_upd_header registered" << endl;*/
-            register_header_type(&sample);
-        }
-
-    protected:
-        virtual header* generate() {
-            // cout << "SDN_ctrl_upd_header generated" << endl;
-            return new SDN_ctrl_upd_header;
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_upd_header"; }
-        ~SDN_ctrl_upd_header_generator() {}
-    };
-};
-SDN_ctrl_upd_header::SDN_ctrl_upd_header_generator SDN_ctrl_upd_header::SDN_ctrl_upd_header_generator::sample;
-
-class SDN_ctrl_upd_payload : public payload {
-    SDN_ctrl_upd_payload(SDN_ctrl_upd_payload&) {}
-
-    unsigned int matID; // match: target
-    unsigned int actID; // action: the next hop
-
-protected:
-    SDN_ctrl_upd_payload() {} // this constructor cannot be directly called by users
-public:
-    ~SDN_ctrl_upd_payload() {}
-
-    string type() { return "SDN_ctrl_upd_payload"; }
-
-    SET(setMatID, unsigned int, matID, _matID);
-    GET(getMatID, unsigned int, matID);
-    SET(setActID, unsigned int, actID, _actID);
-    GET(getActID, unsigned int, actID);
-
-    class SDN_ctrl_upd_payload_generator;
-    friend class SDN_ctrl_upd_payload_generator;
-    // SDN_data_payload is derived from payload_generator to generate a payload
-    class SDN_ctrl_upd_payload_generator : public payload_generator {
-        static SDN_ctrl_upd_payload_generator sample;
-        // this constructor is only for sample to register this payload type
-        SDN_ctrl_upd_payload_generator() { /*cout << "SDN_ctrl_upd_payload registered" << endl;*/
-            register_payload_type(&sample);
-        }
-
-    protected:
-        virtual payload* generate() {
-            // cout << "SDN_ctrl_upd_payload generated" << endl;
-            return new SDN_ctrl_upd_payload;
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_upd_payload"; }
-        ~SDN_ctrl_upd_payload_generator() {}
-    };
-};
-SDN_ctrl_upd_payload::SDN_ctrl_upd_payload_generator SDN_ctrl_upd_payload::SDN_ctrl_upd_payload_generator::sample;
-
-class SDN_ctrl_upd_packet : public packet {
-    SDN_ctrl_upd_packet(SDN_ctrl_upd_packet&) {}
-
-protected:
-    SDN_ctrl_upd_packet() {} // this constructor cannot be directly called by users
-    SDN_ctrl_upd_packet(packet* p) : packet(p->getHeader()->type(), p->getPayload()->type(), true, p->getPacketID()) {
-        *(dynamic_cast<SDN_ctrl_upd_header*>(this->getHeader())) = *(dynamic_cast<SDN_ctrl_upd_header*>(p->getHeader()));
-        *(dynamic_cast<SDN_ctrl_upd_payload*>(this->getPayload())) = *(dynamic_cast<SDN_ctrl_upd_payload*>(p->getPayload()));
-        // DFS_path = (dynamic_cast<SDN_ctrl_upd_header*>(p))->DFS_path;
-        // isVisited = (dynamic_cast<SDN_ctrl_upd_header*>(p))->isVisited;
-    } // for duplicate
-    SDN_ctrl_upd_packet(string _h, string _p) : packet(_h, _p) {}
-
-public:
-    virtual ~SDN_ctrl_upd_packet() {}
-    string type() { return "SDN_ctrl_upd_packet"; }
-
-    class SDN_ctrl_upd_packet_generator;
-    friend class SDN_ctrl_upd_packet_generator;
-    // SDN_ctrl_upd_packet is derived from packet_generator to generate a pub packet
-    class SDN_ctrl_upd_packet_generator : public packet_generator {
-        static SDN_ctrl_upd_packet_generator sample;
-        // this constructor is only for sample to register this packet type
-        SDN_ctrl_upd_packet_generator() { /*cout << "SDN_ctrl_upd_packet registered" << endl;*/
-            register_packet_type(&sample);
-        }
-
-    protected:
-        virtual packet* generate(packet* p = nullptr) {
-            // cout << "SDN_ctrl_upd_packet generated" << endl;
-            if (nullptr == p)
-                return new SDN_ctrl_upd_packet("SDN_ctrl_upd_header", "SDN_ctrl_upd_payload");
-            else
-                return new SDN_ctrl_upd_packet(p); // duplicate
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_upd_packet"; }
-        ~SDN_ctrl_upd_packet_generator() {}
-    };
-};
-SDN_ctrl_upd_packet::SDN_ctrl_upd_packet_generator SDN_ctrl_upd_packet::SDN_ctrl_upd_packet_generator::sample;
-
-class SDN_ctrl_upd_pkt_gen_event : public event {
-public:
-    class gen_data; // forward declaration
-
-private:
-    SDN_ctrl_upd_pkt_gen_event(SDN_ctrl_upd_pkt_gen_event&) {}
-    SDN_ctrl_upd_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
-    // this constructor cannot be directly called by users; only by generator
-    unsigned int src; // the src
-    unsigned int dst; // the dst
-    unsigned int mat;
-    unsigned int act;
-    // packet *pkt; // the packet
-    string msg;
-
-protected:
-    SDN_ctrl_upd_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
-        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
-        src = data_ptr->src_id;
-        dst = data_ptr->dst_id;
-        // pkt = data_ptr->_pkt;
-        mat = data_ptr->mat_id;
-        act = data_ptr->act_id;
-        msg = data_ptr->msg;
-    }
-
-public:
-    virtual ~SDN_ctrl_upd_pkt_gen_event() {}
-    // SDN_ctrl_upd_pkt_gen_event will trigger the packet gen function
-    virtual void trigger();
-
-    unsigned int event_priority() const;
-
-    class SDN_ctrl_upd_pkt_gen_event_generator;
-    friend class SDN_ctrl_upd_pkt_gen_event_generator;
-    // SDN_ctrl_upd_pkt_gen_event_generator is derived from event_generator to generate an event
-    class SDN_ctrl_upd_pkt_gen_event_generator : public event_generator {
-        static SDN_ctrl_upd_pkt_gen_event_generator sample;
-        // this constructor is only for sample to register this event type
-        SDN_ctrl_upd_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
-            register_event_type(&sample);
-        }
-
-    protected:
-        virtual event* generate(unsigned int _trigger_time, void* data) {
-            // cout << "send_event generated" << endl;
-            return new SDN_ctrl_upd_pkt_gen_event(_trigger_time, data);
-        }
-
-    public:
-        virtual string type() { return "SDN_ctrl_upd_pkt_gen_event"; }
-        ~SDN_ctrl_upd_pkt_gen_event_generator() {}
-    };
-    // this class is used to initialize the SDN_ctrl_upd_pkt_gen_event
-    class pkt_gen_data {
-    public:
-        unsigned int src_id; // the controller
-        unsigned int dst_id; // the node that should update its rule
-        unsigned int mat_id; // the target of the rule
-        unsigned int act_id; // the next hop toward the target recorded in the rule
-        string msg;
-        // packet *_pkt;
-    };
-
-    void print() const;
-};
-SDN_ctrl_upd_pkt_gen_event::SDN_ctrl_upd_pkt_gen_event_generator SDN_ctrl_upd_pkt_gen_event::SDN_ctrl_upd_pkt_gen_event_generator::sample;
-void SDN_ctrl_upd_pkt_gen_event::trigger() {
-    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
-        cerr << "SDN_ctrl_upd_pkt_gen_event error: no node " << dst << "!" << endl;
-        return;
-    }
-
-    SDN_ctrl_upd_packet* pkt = dynamic_cast<SDN_ctrl_upd_packet*>(packet::packet_generator::generate("SDN_ctrl_upd_packet"));
-    if (pkt == nullptr) {
-        cerr << "packet type is incorrect" << endl;
-        return;
-    }
-    SDN_ctrl_upd_header* hdr = dynamic_cast<SDN_ctrl_upd_header*>(pkt->getHeader());
-    SDN_ctrl_upd_payload* pld = dynamic_cast<SDN_ctrl_upd_payload*>(pkt->getPayload());
-
-    if (hdr == nullptr) {
-        cerr << "header type is incorrect" << endl;
-        return;
-    }
-    if (pld == nullptr) {
-        cerr << "payload type is incorrect" << endl;
-        return;
-    }
-
-    hdr->setSrcID(src);
-    hdr->setDstID(dst);
-    hdr->setPreID(src);
-    hdr->setNexID(src); // in hw3, you should set NexID to src
-    // payload
-    pld->setMsg(msg);
-    pld->setMatID(mat);
-    pld->setActID(act);
-
-    recv_event::recv_data e_data;
-    e_data.s_id = src;
-    e_data.r_id = src; // in hw3, you should set r_id it src
-    e_data._pkt = pkt;
-
-    recv_event* e = dynamic_cast<recv_event*>(event::event_generator::generate("recv_event", trigger_time, (void*)&e_data));
-}
-unsigned int SDN_ctrl_upd_pkt_gen_event::event_priority() const {
-    string string_for_hash;
-    string_for_hash = to_string(getTriggerTime()) + to_string(src) + to_string(dst) + to_string(mat) + to_string(act); // to_string (pkt->getPacketID());
-    return get_hash_value(string_for_hash);
-}
-// the SDN_ctrl_upd_pkt_gen_event::print() function is used for log file
-void SDN_ctrl_upd_pkt_gen_event::print() const {
-    cout << "time " << setw(11) << event::getCurTime()
-        << "        " << setw(11) << " "
-        << "        " << setw(11) << " "
-        << "   srcID" << setw(11) << src
-        << "   dstID" << setw(11) << dst
-        << "   matID" << setw(11) << mat
-        << "   actID" << setw(11) << act
-        << "   SDN_ctrl_upd_packet generating"
-        << endl;
-}
-void ctrl_upd_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), string msg = "default") {
-    // void ctrl_upd_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
-    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
-        cerr << "id is incorrect" << endl;
-        return;
-    }
-
-    unsigned int src = con_id;
-    SDN_ctrl_upd_pkt_gen_event::pkt_gen_data e_data;
-    e_data.src_id = src;
-    e_data.dst_id = id;
-    e_data.mat_id = mat;
-    e_data.act_id = act;
-    e_data.msg = msg;
-
-    SDN_ctrl_upd_pkt_gen_event* e = dynamic_cast<SDN_ctrl_upd_pkt_gen_event*>(event::event_generator::generate("SDN_ctrl_upd_pkt_gen_event", t, (void*)&e_data));
-    if (e == nullptr)
-        cerr << "event type is incorrect" << endl;
-}
-class SDN_stat_header : public header {
-    SDN_stat_header(SDN_stat_header&) {} // cannot be called by users
-
-protected:
-    SDN_stat_header() {} // this constructor cannot be directly called by users
-
-public:
-    ~SDN_stat_header() {}
-    string type() { return "SDN_stat_header"; }
-
-    class SDN_stat_header_generator;
-    friend class SDN_stat_header_generator;
-    // SDN_stat_header_generator is derived from header_generator to generate a header
-    class SDN_stat_header_generator : public header_generator {
-        static SDN_stat_header_generator sample;
-        // this constructor is only for sample to register this header type
-        SDN_stat_header_generator() { /*cout << "SDN_stat_header registered" << endl;*/
-            register_header_type(&sample);
-        }
-
-    protected:
-        virtual header* generate() {
-            // cout << "SDN_stat_header generated" << endl;
-            return new SDN_stat_header;
-        }
-
-    public:
-        virtual string type() { return "SDN_stat_header"; }
-        ~SDN_stat_header_generator() {}
-    };
-};
-SDN_stat_header::SDN_stat_header_generator SDN_stat_header::SDN_stat_header_generator::sample;
-
-class SDN_stat_payload : public payload {
-    SDN_stat_payload(SDN_stat_payload&) {}
-
-    map<unsigned int, unsigned int> LinkWeight;
-    int aaa;
-
-protected:
-    SDN_stat_payload() {} // this constructor cannot be directly called by users
-public:
-    ~SDN_stat_payload() {}
-
-    string type() { return "SDN_stat_payload"; }
-
-    void setLinkWeight(map<unsigned int, unsigned int> _LinkWeight) { LinkWeight = _LinkWeight; }
-    map<unsigned int, unsigned int> getLinkWeight() { return LinkWeight; }
-
-    class SDN_stat_payload_generator;
-    friend class SDN_stat_payload_generator;
-    // SDN_data_payload is derived from payload_generator to generate a payload
-    class SDN_stat_payload_generator : public payload_generator {
-        static SDN_stat_payload_generator sample;
-        // this constructor is only for sample to register this payload type
-        SDN_stat_payload_generator() { /*cout << "SDN_stat_payload registered" << endl;*/
-            register_payload_type(&sample);
-        }
-
-    protected:
-        virtual payload* generate() {
-            // cout << "SDN_stat_payload generated" << endl;
-            return new SDN_stat_payload;
-        }
-
-    public:
-        virtual string type() { return "SDN_stat_payload"; }
-        ~SDN_stat_payload_generator() {}
-    };
-};
-SDN_stat_payload::SDN_stat_payload_generator SDN_stat_payload::SDN_stat_payload_generator::sample;
-
-class SDN_stat_packet : public packet {
-    SDN_stat_packet(SDN_stat_packet&) {}
-
-protected:
-    SDN_stat_packet() {} // this constructor cannot be directly called by users
-    SDN_stat_packet(packet* p) : packet(p->getHeader()->type(), p->getPayload()->type(), true, p->getPacketID()) {
-        *(dynamic_cast<SDN_stat_header*>(this->getHeader())) = *(dynamic_cast<SDN_stat_header*>(p->getHeader()));
-        *(dynamic_cast<SDN_stat_payload*>(this->getPayload())) = *(dynamic_cast<SDN_stat_payload*>(p->getPayload()));
-        // DFS_path = (dynamic_cast<SDN_stat_header*>(p))->DFS_path;
-        // isVisited = (dynamic_cast<SDN_stat_header*>(p))->isVisited;
-    } // for duplicate
-    SDN_stat_packet(string _h, string _p) : packet(_h, _p) {}
-
-public:
-    virtual ~SDN_stat_packet() {}
-    string type() { return "SDN_stat_packet"; }
-
-    class SDN_stat_packet_generator;
-    friend class SDN_stat_packet_generator;
-    // SDN_stat_packet is derived from packet_generator to generate a pub packet
-    class SDN_stat_packet_generator : public packet_generator {
-        static SDN_stat_packet_generator sample;
-        // this constructor is only for sample to register this packet type
-        SDN_stat_packet_generator() { /*cout << "SDN_stat_packet registered" << endl;*/
-            register_packet_type(&sample);
-        }
-
-    protected:
-        virtual packet* generate(packet* p = nullptr) {
-            // cout << "SDN_stat_packet generated" << endl;
-            if (nullptr == p)
-                return new SDN_stat_packet("SDN_stat_header", "SDN_stat_payload");
-            else
-                return new SDN_stat_packet(p); // duplicate
-        }
-
-    public:
-        virtual string type() { return "SDN_stat_packet"; }
-        ~SDN_stat_packet_generator() {}
-    };
-};
-SDN_stat_packet::SDN_stat_packet_generator SDN_stat_packet::SDN_stat_packet_generator::sample;
-
-class SDN_stat_pkt_gen_event : public event {
-public:
-    class gen_data; // forward declaration
-
-private:
-    SDN_stat_pkt_gen_event(SDN_stat_pkt_gen_event&) {}
-    SDN_stat_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
-    // this constructor cannot be directly called by users; only by generator
-    unsigned int src; // the src
-    unsigned int dst; // the dst
-    map<unsigned int, unsigned int> LinkWeight;
-    // packet *pkt; // the packet
-    string msg;
-
-protected:
-    SDN_stat_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
-        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
-        src = data_ptr->src_id;
-        dst = data_ptr->dst_id;
-        LinkWeight = data_ptr->LinkWeight;
-        msg = data_ptr->msg;
-    }
-
-public:
-    virtual ~SDN_stat_pkt_gen_event() {}
-    // SDN_stat_pkt_gen_event will trigger the packet gen function
-    virtual void trigger();
-
-    unsigned int event_priority() const;
-
-    class SDN_stat_pkt_gen_event_generator;
-    friend class SDN_stat_pkt_gen_event_generator;
-    // SDN_stat_pkt_gen_event_generator is derived from event_generator to generate an event
-    class SDN_stat_pkt_gen_event_generator : public event_generator {
-        static SDN_stat_pkt_gen_event_generator sample;
-        // this constructor is only for sample to register this event type
-        SDN_stat_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
-            register_event_type(&sample);
-        }
-
-    protected:
-        virtual event* generate(unsigned int _trigger_time, void* data) {
-            // cout << "send_event generated" << endl;
-            return new SDN_stat_pkt_gen_event(_trigger_time, data);
-        }
-
-    public:
-        virtual string type() { return "SDN_stat_pkt_gen_event"; }
-        ~SDN_stat_pkt_gen_event_generator() {}
-    };
-    // this class is used to initialize the SDN_stat_pkt_gen_event
-    class pkt_gen_data {
-    public:
-        unsigned int src_id; // the controller
-        unsigned int dst_id; // the node that should update its rule
-        map<unsigned int, unsigned int> LinkWeight;
-        string msg;
-        // packet *_pkt;
-    };
-
-    void print() const;
-};
-SDN_stat_pkt_gen_event::SDN_stat_pkt_gen_event_generator SDN_stat_pkt_gen_event::SDN_stat_pkt_gen_event_generator::sample;
-void SDN_stat_pkt_gen_event::trigger() {
-    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
-        cerr << "SDN_stat_pkt_gen_event error: no node " << dst << "!" << endl;
-        return;
-    }
-
-    SDN_stat_packet* pkt = dynamic_cast<SDN_stat_packet*>(packet::packet_generator::generate("SDN_stat_packet"));
-    if (pkt == nullptr) {
-        cerr << "packet type is incorrect" << endl;
-        return;
-    }
-    SDN_stat_header* hdr = dynamic_cast<SDN_stat_header*>(pkt->getHeader());
-    SDN_stat_payload* pld = dynamic_cast<SDN_stat_payload*>(pkt->getPayload());
-
-    if (hdr == nullptr) {
-        cerr << "header type is incorrect" << endl;
-        return;
-    }
-    if (pld == nullptr) {
-        cerr << "payload type is incorrect" << endl;
-        return;
-    }
-
-    hdr->setSrcID(src);
-    hdr->setDstID(dst);
-    hdr->setPreID(src);
-    hdr->setNexID(src); // in hw3, you should set NexID to src
-    // payload
-    pld->setMsg(msg);
-    pld->setLinkWeight(LinkWeight);
-
-    recv_event::recv_data e_data;
-    e_data.s_id = src;
-    e_data.r_id = src; // in hw3, you should set r_id it src
-    e_data._pkt = pkt;
-
-    recv_event* e = dynamic_cast<recv_event*>(event::event_generator::generate("recv_event", trigger_time, (void*)&e_data));
-}
-unsigned int SDN_stat_pkt_gen_event::event_priority() const {
-    string string_for_hash;
-    string_for_hash = to_string(getTriggerTime()) + to_string(src) + to_string(dst); // to_string (pkt->getPacketID());
-    return get_hash_value(string_for_hash);
-}
-// the SDN_stat_pkt_gen_event::print() function is used for log file
-void SDN_stat_pkt_gen_event::print() const {
-    cout << "time " << setw(11) << event::getCurTime()
-        << "        " << setw(11) << " "
-        << "        " << setw(11) << " "
-        << "   srcID" << setw(11) << src
-        << "   dstID" << setw(11) << dst
-        << "        " << setw(11) << " "
-        << "        " << setw(11) << " "
-        << "   SDN_stat_packet generating"
-        << endl;
-}
-void stat_packet_event(unsigned int src_id, unsigned int dst_id, map<unsigned int, unsigned int> LinkWeight, unsigned int t = event::getCurTime(), string msg = "default") {
-    // void stat_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
-    if (dst_id == BROCAST_ID || node::id_to_node(dst_id) == nullptr) {
-        cerr << "dst_id is incorrect" << endl;
-        return;
-    }
-
-    unsigned int src = src_id;
-    SDN_stat_pkt_gen_event::pkt_gen_data e_data;
-    e_data.src_id = src_id;
-    e_data.dst_id = dst_id;
-    e_data.LinkWeight = LinkWeight;
-    e_data.msg = msg;
-
-    SDN_stat_pkt_gen_event* e = dynamic_cast<SDN_stat_pkt_gen_event*>(event::event_generator::generate("SDN_stat_pkt_gen_event", t, (void*)&e_data));
-    if (e == nullptr)
-        cerr << "event type is incorrect" << endl;
-}
-/////////////////////////////////////////////
-
-// the data_packet_event function is used to add an initial event
-void data_packet_event(unsigned int src, unsigned int dst, unsigned int t = 0, string msg = "default") {
-    if (node::id_to_node(src) == nullptr || (dst != BROCAST_ID && node::id_to_node(dst) == nullptr)) {
-        cerr << "src or dst is incorrect" << endl;
-        return;
-        return;
-    }
-
-    SDN_data_pkt_gen_event::pkt_gen_data e_data;
-    e_data.src_id = src;
-    e_data.dst_id = dst;
-    e_data.msg = msg;
-
-    // recv_event *e = dynamic_cast<recv_event*> ( event::event_generator::generate("recv_event",t, (void *)&e_data) );
-    SDN_data_pkt_gen_event* e = dynamic_cast<SDN_data_pkt_gen_event*>(event::event_generator::generate("SDN_data_pkt_gen_event", t, (void*)&e_data));
-    if (e == nullptr)
-        cerr << "event type is incorrect" << endl;
-}
-
-// the ctrl_packet_event function is used to add an initial event
-void ctrl_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), string msg = "default") {
-    // void ctrl_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
-    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
-        cerr << "id is incorrect" << endl;
-        return;
-    }
-
-    unsigned int src = con_id;
-    SDN_ctrl_pkt_gen_event::pkt_gen_data e_data;
-    e_data.src_id = src;
-    e_data.dst_id = id;
-    e_data.mat_id = mat;
-    e_data.act_id = act;
-    e_data.msg = msg;
-
-    SDN_ctrl_pkt_gen_event* e = dynamic_cast<SDN_ctrl_pkt_gen_event*>(event::event_generator::generate("SDN_ctrl_pkt_gen_event", t, (void*)&e_data));
-    if (e == nullptr)
-        cerr << "event type is incorrect" << endl;
-}
-
-// send_handler function is used to transmit packet p based on the information in the header
-// Note that the packet p will not be discard after send_handler ()
-
-void node::send_handler(packet* p) {
-    packet* _p = packet::packet_generator::replicate(p);
-    send_event::send_data e_data;
-    e_data.s_id = _p->getHeader()->getPreID();
-    e_data.r_id = _p->getHeader()->getNexID();
-    e_data._pkt = _p;
-    send_event* e = dynamic_cast<send_event*>(event::event_generator::generate("send_event", event::getCurTime(), (void*)&e_data));
-    if (e == nullptr)
-        cerr << "event type is incorrect" << endl;
-}
-
-void node::send(packet* p) { // this function is called by event; not for the user
-    if (p == nullptr)
-        return;
-
-    unsigned int _nexID = p->getHeader()->getNexID();
-    for (map<unsigned int, bool>::iterator it = phy_neighbors.begin(); it != phy_neighbors.end(); it++) {
-        unsigned int nb_id = it->first; // neighbor id
-
-        if (nb_id != _nexID && BROCAST_ID != _nexID)
-            continue; // this neighbor will not receive the packet
-
-        unsigned int trigger_time = event::getCurTime() + link::id_id_to_link(id, nb_id)->getLatency(); // we simply assume that the delay is fixed
-        // cout << "node " << id << " send to node " <<  nb_id << endl;
-        recv_event::recv_data e_data;
-        e_data.s_id = id;    // set the sender   (i.e., preID)
-        e_data.r_id = nb_id; // set the receiver (i.e., nexID)
-
-        packet* p2 = packet::packet_generator::replicate(p);
-        e_data._pkt = p2;
-
-        recv_event* e = dynamic_cast<recv_event*>(event::event_generator::generate("recv_event", trigger_time, (void*)&e_data)); // send the packet to the neighbor
-        if (e == nullptr)
-            cerr << "event type is incorrect" << endl;
-    }
-    packet::discard(p);
-}
-
-// you have to write the code in recv_handler of SDN_switch
-void SDN_switch::recv_handler(packet* p) {
-    // in this function, you are "not" allowed to use node::id_to_node(id) !!!!!!!!(getNodeID())
-
-    // this is a simple example
-    // node 0 broadcasts its message to every node and every node relays the packet "only once"
-    // the variable hi is used to examine whether the packet has been received before
-    // you can remove the variable hi and create your own variables in class SDN_switch
-    if (p == nullptr)
-        return;
-
-    if (p->type() == "SDN_data_packet") { // the switch receives a packet from the other switch
-        // cout << "node " << getNodeID() << " send the packet" << endl;
-        SDN_data_packet* p2 = nullptr;
-        p2 = dynamic_cast<SDN_data_packet*>(p);
-        if (getNodeID() == p2->getHeader()->getDstID())
-            return;
-        p2->getHeader()->setPreID(getNodeID());
-        p2->getHeader()->setNexID(routing_table[p2->getHeader()->getDstID()]);
-        //p2->getHeader()->setSrcID(p2->getHeader()->getSrcID());
-        //p2->getHeader()->setDstID(p2->getHeader()->getDstID());
-        send_handler(p2);
-    }
-    else if (p->type() == "SDN_ctrl_new_packet") { // the switch receives a packet from the controller
-        SDN_ctrl_new_packet* p3 = nullptr;
-        p3 = dynamic_cast<SDN_ctrl_new_packet*>(p);
-        SDN_ctrl_new_payload* l3 = nullptr;
-        l3 = dynamic_cast<SDN_ctrl_new_payload*>(p3->getPayload());
-        unsigned mat = l3->getMatID();
-        unsigned act = l3->getActID();
-        routing_table[mat] = act;
-        p3->getHeader()->setDstID(p3->getHeader()->getSrcID());
-        p3->getHeader()->setSrcID(getNodeID());
-        p3->getHeader()->setPreID(getNodeID());
-        p3->getHeader()->setNexID(p3->getHeader()->getDstID());
-        send_handler(p3);
-        // string msg = l3->getMsg(); // get the msg
-    }
-    else if (p->type() == "SDN_stat_packet") {
-        SDN_stat_packet* p4 = nullptr;
-        p4 = dynamic_cast<SDN_stat_packet*>(p);
-        p4->getHeader()->setNexID(p4->getHeader()->getDstID());
-        send_handler(p4);
-    }
-    // you should implement the SDN's distributed algorithm in recv_handler
-    // getNodeID() returns the id of the current node
-
-    // The current node's neighbors are already stored in the following variable
-    // map<unsigned int,bool> node::
-    // however, this variable is private in the class node
-    // You have to use node::getPhyNeighbors to get the variable
-    // for example, if you want to print all the neighbors of this node
-    // const map<unsigned int,bool> &nblist = getPhyNeighbors();
-    // cout << "node " << getNodeID() << "'s nblist: ";
-    // for (map<unsigned int,bool>::const_iterator it = nblist.begin(); it != nblist.end(); it ++) {
-    //     cout << it->first << ", " ;
-    // }
-    // cout << endl;
-
-    // you can use p->getHeader()->setSrcID() or getSrcID()
-    //             p->getHeader()->setDstID() or getDstID()
-    //             p->getHeader()->setPreID() or getPreID()
-    //             p->getHeader()->setNexID() or getNexID() to change or read the packet header
-
-    // In addition, you can get the packet, header, and payload with the correct type (GR)
-    // in fact, this is downcasting
-    // SDN_data_packet * pkt = dynamic_cast<SDN_data_packet*> (p);
-    // SDN_data_header * hdr = dynamic_cast<SDN_data_header*> (p->getHeader());
-    // SDN_data_payload * pld = dynamic_cast<SDN_data_payload*> (p->getPayload());
-
-    // you can also change the SDN_data_payload setting
-    // pld->setMsg(string): to set the message transmitted to the destination
-
-    // Besides, you can use packet::packet_generator::generate() to generate a new packet; note that you should fill the header and payload in the packet
-    // moreover, you can use "packet *p2 = packet::packet_generator::replicate(p)" to make a clone p2 of packet p
-    // note that if the packet is generated or replicated manually, you must delete it by packet::discard() manually before recv_handler finishes
-
-    // "IMPORTANT":
-    // You have to "carefully" fill the correct information (e.g., srcID, dstID, ...) in the packet before you send it
-    // Note that if you want to transmit a packet to only one next node (i.e., unicast), then you fill the ID of a specific node to "nexID" in the header
-    // Otherwise, i.e., you want to broadcasts, then you fill "BROCAST_ID" to "nexID" in the header
-    // after that, you can use send() to transmit the packet
-    // usage: send_handler (p);
-
-    // note that packet p will be discarded (deleted) after recv_handler(); you don't need to manually delete it
-}
-
-void SDN_controller::recv_handler(packet* p) {
-
-    if (p == nullptr)
-        return;
-
-    if (p->type() == "SDN_ctrl_new_packet") {
-        SDN_ctrl_new_packet* p5 = nullptr;
-        p5 = dynamic_cast<SDN_ctrl_new_packet*>(p);
-        if (p5->getHeader()->getSrcID() == getNodeID()) {
-            p5->getHeader()->setNexID(p5->getHeader()->getDstID());
-            send_handler(p5);
-        }
-    }
-    else if (p->type() == "SDN_stat_packet") {
-    }
-}
-
-class neightbor {
-public:
-    map<unsigned int, unsigned int> linkWeight;
-};
-
-int main() {
-    // header::header_generator::print(); // print all registered headers
-    // payload::payload_generator::print(); // print all registered payloads
-    // packet::packet_generator::print(); // print all registered packets
-    // node::node_generator::print(); // print all registered nodes
-    // event::event_generator::print(); // print all registered events
-    // link::link_generator::print(); // print all registered links
-    unsigned int nodeNum, nodeCost;
-    unsigned int insTime, updTime, SimDuration;
-    unsigned int source, dest, oldPathLen;
-    unsigned int listInNetwork;
-    unsigned int sendTime;
-    // map<unsigned int, unsigned int> oldTable[nodeNum];
-    map<unsigned int, map<unsigned int, unsigned int>> oldTable;
-    cin >> nodeNum >> nodeCost;
-    cin >> insTime >> updTime >> SimDuration;
-    cin >> source >> dest >> oldPathLen;
-    // read the input and generate switch nodes
-    for (unsigned int id = 0; id < nodeNum; id++) {
-        node::node_generator::generate("SDN_switch", id);
-    }
-    unsigned int con_id = node::getNodeNum();
-    node::node_generator::generate("SDN_controller", con_id);
-    for (unsigned int i = 0; i < nodeNum; i++) {
-        node::id_to_node(i)->add_phy_neighbor(con_id);
-        node::id_to_node(con_id)->add_phy_neighbor(i);
-    }
-    // set switches' neighbors
-    for (unsigned int i = 0; i < oldPathLen; i++) {
-        unsigned int oldLinkID, node1, node2;
-        cin >> oldLinkID >> node1 >> node2;
-        oldTable[node1][dest] = node2;
-        node::id_to_node(node1)->add_phy_neighbor(node2);
-        node::id_to_node(node2)->add_phy_neighbor(node1);
-    }
-
-    // control packet
-    for (unsigned int id = 0; id < nodeNum; id++) {
-        if (id != dest)
-            ctrl_new_packet_event(con_id, id, dest, oldTable[id][dest], insTime);
-    }
-
-    // store the link and weight
-    cin >> listInNetwork;
-    vector<class neightbor> neightbor_list;
-    for (unsigned int id = 0; id < nodeNum; id++) {
-        neightbor temp;
-        neightbor_list.push_back(temp);
-    }
-    for (unsigned int id = 0; id < listInNetwork; id++) {
-        unsigned int linkId, node1, node2, weight;
-        cin >> linkId >> node1 >> node2 >> weight;
-        neightbor_list[node1].linkWeight[node2] = weight;
-        neightbor_list[node2].linkWeight[node1] = weight;
-    }
-    for (unsigned int id = 0; id < nodeNum; id++)
-        stat_packet_event(id, con_id, neightbor_list[id].linkWeight, updTime);
-
-    // data packet
-    while (cin >> sendTime >> source >> dest)
-        data_packet_event(source, dest, sendTime);
-    // read the input and use data_packet_event to add an initial event
-
-    // data_packet_event(src, dst, t);
-
-    // 1st parameter: the source node
-    // 2nd parameter: the destination node
-    // 3rd parameter: time
-    // 4th parameter: msg for debug (optional)
-
-    // dst = 0;
-    /*
-    for (unsigned int id = 0; id < node::getNodeNum(); id++)
-    {
-        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
-        ctrl_packet_event(con_id, id, id, id + 1, 100);
-        // note that we don't need to use msg for network update anymore in hw3
-        // thus, function ctrl_packet_event is updated as follows:
-        // 1st parameter: the node that has to update the rule
-        // 2nd parameter: the target node of the rule (i.e., match ID)
-        // 3rd parameter: the next-hop node toward the target node recorded in the rule (i.e., action ID)
-        // 4th parameter: time (optional)
-        // 5th parameter: msg for debug (optional)
-
-        // !!!! note that you can use "ctrl_packet_event (con_id, id, mat, act)" in SDN_controller's recv_handler
-        // !!!! to generate the new ctrl msg in the next round
-    }
-    */
-    /*
-    for (unsigned int id = 0; id < node::getNodeNum(); id++)
-    {
-        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
-        ctrl_new_packet_event(con_id, id, id, id + 1, 200);
-    }
-    for (unsigned int id = 0; id < node::getNodeNum(); id++)
-    {
-        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
-        ctrl_del_packet_event(con_id, id, id, id + 1, 300);
-    }
-    for (unsigned int id = 0; id < node::getNodeNum(); id++)
-    {
-        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
-        ctrl_upd_packet_event(con_id, id, id, id + 1, 400);
-    }
-    for (unsigned int id = 0; id < node::getNodeNum(); id++)
-    {
-        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
-        map<unsigned int, unsigned int> link_weight;
-        stat_packet_event(id, con_id, link_weight, 0);
-    }
-    */
-    // start simulation!!
-    event::start_simulate(SimDuration);
-    // event::flush_events() ;
-    // cout << packet::getLivePacketNum() << endl;
-    return 0;
-}
+#include <iostream>
+#include <map>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <climits>
+#include <functional>
+#include <iomanip>
+#include <stack>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <charconv>
+#include <string_view>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+using namespace std;
+
+#define SET(func_name, type, var_name, _var_name) \
+    void func_name(type _var_name) { var_name = _var_name; }
+#define GET(func_name, type, var_name) \
+    type func_name() const { return var_name; }
+// new/delete of the class take and give back the memory through its own object_pool
+#define POOLED_NEW_DELETE \
+    static object_pool pool; \
+    static void* operator new(size_t size) { return pool.allocate(size); } \
+    static void operator delete(void* ptr, size_t size) { pool.deallocate(ptr, size); }
+
+// the message of a payload is interned: equal texts share one immutable string, so a copy is a pointer copy and two
+// messages are compared by their pointers. the fixed tags ("default", "update") are static strings, short enough to be
+// kept inside the string itself, and are found without the table, its lock or an allocation; any other text is added
+// to the table the first time it is seen and kept until the end. compare with the tag constants (msg == message::UPDATE),
+// which is a pointer comparison; a text is interned first
+class message {
+    const string* text;
+
+    explicit message(const string* _text) : text(_text) {}
+
+    static const string tags[];
+    static const size_t TAG_NUM;
+    static const string* intern(const char* s, size_t len) {
+        for (size_t i = 0; i < TAG_NUM; i++)
+            if (tags[i].size() == len && memcmp(tags[i].data(), s, len) == 0)
+                return &tags[i];
+        static mutex table_lock;            // the events of the parallel engines may make messages in different threads
+        static unordered_set<string> table; // its strings never move, so the pointers to them stay valid
+        lock_guard<mutex> lock(table_lock);
+        return &*table.emplace(s, len).first;
+    }
+
+public:
+    static const message DEFAULT, UPDATE;
+
+    message() : text(&tags[0]) {} // "default"
+    message(const char* s) : text(intern(s, strlen(s))) {}
+    message(const string& s) : text(intern(s.data(), s.size())) {}
+
+    const string& str() const { return *text; }
+    operator const string&() const { return *text; }
+    bool operator==(const message& m) const { return text == m.text; }
+    bool operator!=(const message& m) const { return text != m.text; }
+    friend ostream& operator<<(ostream& os, const message& m) { return os << *m.text; }
+};
+const string message::tags[] = {"default", "update"};
+const size_t message::TAG_NUM = sizeof(message::tags) / sizeof(message::tags[0]);
+const message message::DEFAULT(&message::tags[0]);
+const message message::UPDATE(&message::tags[1]);
+
+class header;
+class payload;
+class packet;
+class node;
+class event;
+class link; // new
+class scheduler;
+
+// for simplicity, we use a const int to simulate the delay
+// if you want to simulate the more details, you should revise it to be a class
+const unsigned int ONE_HOP_DELAY = 10;
+const unsigned int BROCAST_ID = UINT_MAX;
+
+// BROCAST_ID means that all neighbors are receivers; UINT_MAX is the maximum value of unsigned int
+
+// type ids of the registered classes; they are assigned to the generators at registration
+// dispatching on them needs neither string construction (type()) nor RTTI (dynamic_cast)
+enum header_type_id {
+    SDN_DATA_HEADER,
+    SDN_CTRL_HEADER,
+    SDN_CTRL_NEW_HEADER,
+    SDN_CTRL_DEL_HEADER,
+    SDN_CTRL_UPD_HEADER,
+    SDN_STAT_HEADER,
+    HEADER_TYPE_NUM
+};
+enum payload_type_id {
+    SDN_DATA_PAYLOAD,
+    SDN_CTRL_PAYLOAD,
+    SDN_CTRL_NEW_PAYLOAD,
+    SDN_CTRL_DEL_PAYLOAD,
+    SDN_CTRL_UPD_PAYLOAD,
+    SDN_STAT_PAYLOAD,
+    PAYLOAD_TYPE_NUM
+};
+enum packet_type_id {
+    SDN_DATA_PACKET,
+    SDN_CTRL_PACKET,
+    SDN_CTRL_NEW_PACKET,
+    SDN_CTRL_DEL_PACKET,
+    SDN_CTRL_UPD_PACKET,
+    SDN_STAT_PACKET,
+    PACKET_TYPE_NUM
+};
+enum event_type_id {
+    RECV_EVENT,
+    SEND_EVENT,
+    SDN_DATA_PKT_GEN_EVENT,
+    SDN_CTRL_PKT_GEN_EVENT,
+    SDN_CTRL_NEW_PKT_GEN_EVENT,
+    SDN_CTRL_DEL_PKT_GEN_EVENT,
+    SDN_CTRL_UPD_PKT_GEN_EVENT,
+    SDN_STAT_PKT_GEN_EVENT,
+    EVENT_TYPE_NUM
+};
+
+#ifdef HEAP_COUNT
+// every allocation from the heap is counted, so the benchmark can show the malloc calls left on the hot path
+// it is compiled only with -DHEAP_COUNT, since the count costs an atomic add on every new of the program
+atomic<unsigned long long> heap_alloc_num(0);
+void* operator new(size_t size) {
+    heap_alloc_num.fetch_add(1, memory_order_relaxed);
+    void* ptr = malloc(size);
+    if (ptr == nullptr)
+        throw bad_alloc();
+    return ptr;
+}
+// inlined into a caller, free() after new looks like a mismatched pair to the compiler, but new above is malloc()
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+#pragma GCC diagnostic pop
+#endif
+
+// object_pool keeps the memory of deleted objects of one type in a free list and reuses it for the next new
+// the memory is taken from the heap in slabs of SLAB_OBJ_NUM objects
+class object_pool {
+    object_pool(object_pool&) {} // lock the copy constructor
+    static map<string, object_pool*> pools; // all pools in the program; for print()
+    static const size_t SLAB_OBJ_NUM = 64;
+
+    string name;
+    size_t obj_size;
+    vector<void*> free_list;
+    unsigned long long alloc_num; // the number of new
+    unsigned long long slab_num;  // the number of slabs taken from the heap
+    size_t live_num;              // the number of objects in use
+    size_t max_live_num;          // high-water mark of live_num
+    mutex lock;                   // taken only while threaded is set
+    static bool threaded;         // set while the workers of the parallel engine run
+
+public:
+    object_pool(string _name, size_t _obj_size) : name(_name), alloc_num(0), slab_num(0), live_num(0), max_live_num(0) {
+        obj_size = (_obj_size + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+        pools[name] = this;
+    }
+
+    void* allocate(size_t size) {
+        if (size > obj_size) // a derived class without its own pool
+            return ::operator new(size);
+        unique_lock<mutex> guard(lock, defer_lock);
+        if (threaded)
+            guard.lock();
+        if (free_list.empty()) {
+            char* slab = static_cast<char*>(::operator new(obj_size * SLAB_OBJ_NUM)); // slabs are kept until the program ends
+            for (size_t i = SLAB_OBJ_NUM; i > 0; i--)
+                free_list.push_back(slab + (i - 1) * obj_size);
+            slab_num++;
+        }
+        void* ptr = free_list.back();
+        free_list.pop_back();
+        alloc_num++;
+        if (++live_num > max_live_num)
+            max_live_num = live_num;
+        return ptr;
+    }
+    void deallocate(void* ptr, size_t size) {
+        if (size > obj_size) {
+            ::operator delete(ptr);
+            return;
+        }
+        unique_lock<mutex> guard(lock, defer_lock);
+        if (threaded)
+            guard.lock();
+        free_list.push_back(ptr);
+        live_num--;
+    }
+
+    static void set_threaded(bool _threaded) { threaded = _threaded; }
+
+    // the sums over all pools
+    static void count(unsigned long long& _alloc_num, unsigned long long& _slab_num, unsigned long long& _live_num) {
+        _alloc_num = _slab_num = _live_num = 0;
+        for (map<string, object_pool*>::iterator it = pools.begin(); it != pools.end(); it++) {
+            _alloc_num += it->second->alloc_num;
+            _slab_num += it->second->slab_num;
+            _live_num += it->second->live_num;
+        }
+    }
+
+    static void print() {
+        cout << "object pool statistics: " << endl;
+        cout << setw(24) << "type" << setw(14) << "new" << setw(14) << "slab" << setw(14) << "live" << setw(14) << "high-water" << endl;
+        for (map<string, object_pool*>::iterator it = pools.begin(); it != pools.end(); it++) {
+            object_pool* p = it->second;
+            cout << setw(24) << p->name << setw(14) << p->alloc_num << setw(14) << p->slab_num << setw(14) << p->live_num << setw(14) << p->max_live_num << endl;
+        }
+    }
+};
+map<string, object_pool*> object_pool::pools;
+bool object_pool::threaded = false;
+
+class header {
+public:
+    virtual ~header() {}
+
+    SET(setSrcID, unsigned int, srcID, _srcID);
+    SET(setDstID, unsigned int, dstID, _dstID);
+    SET(setPreID, unsigned int, preID, _preID);
+    SET(setNexID, unsigned int, nexID, _nexID);
+    GET(getSrcID, unsigned int, srcID);
+    GET(getDstID, unsigned int, dstID);
+    GET(getPreID, unsigned int, preID);
+    GET(getNexID, unsigned int, nexID);
+
+    virtual string type() = 0;
+    virtual header_type_id type_id() const = 0;
+
+    // factory concept: generate a header
+    class header_generator {
+        // lock the copy constructor
+        header_generator(header_generator&) {}
+        // store all possible types of header
+        static map<string, header_generator*> prototypes;
+        static header_generator* id_prototypes[HEADER_TYPE_NUM]; // indexed by type id
+
+    protected:
+        // allow derived class to use it
+        header_generator() {}
+        // after you create a new header type, please register the factory of this header type by this function
+        void register_header_type(header_generator* h) {
+            prototypes[h->type()] = h;
+            id_prototypes[h->type_id()] = h;
+        }
+        // you have to implement your own generate() to generate your header
+        virtual header* generate() = 0;
+
+    public:
+        // you have to implement your own type() to return your header type
+        virtual string type() = 0;
+        virtual header_type_id type_id() = 0;
+        // this function is used to generate any type of header derived
+        static header* generate(string type) {
+            if (prototypes.find(type) != prototypes.end()) {                                        // if this type derived exists
+                return prototypes[type]->generate(); // generate it!!
+            }
+            std::cerr << "no such header type" << std::endl; // otherwise
+            return nullptr;
+        }
+        // the typed factory: T is constructed directly, without looking up its generator; T has to befriend header_generator.
+        // the string-keyed generate() is kept for the types chosen at run time
+        template <typename T>
+        static T* generate() { return new T; }
+        // the same as generate(string), but the type is found by its type id without a string lookup
+        static header* generate(header_type_id type) {
+            if (id_prototypes[type] != nullptr) // if this type derived exists
+                return id_prototypes[type]->generate(); // generate it!!
+            std::cerr << "no such header type" << std::endl; // otherwise
+            return nullptr;
+        }
+        static void print() {
+            cout << "registered header types: " << endl;
+            for (map<string, header::header_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
+                cout << it->second->type() << endl;
+        }
+        virtual ~header_generator() {};
+    };
+
+protected:
+    header() : srcID(BROCAST_ID), dstID(BROCAST_ID), preID(BROCAST_ID), nexID(BROCAST_ID) {} // this constructor cannot be directly called by users
+
+private:
+    unsigned int srcID;
+    unsigned int dstID;
+    unsigned int preID;
+    unsigned int nexID;
+    header(header&) {} // this constructor cannot be directly called by users
+};
+map<string, header::header_generator*> header::header_generator::prototypes;
+header::header_generator* header::header_generator::id_prototypes[HEADER_TYPE_NUM];
+
+class SDN_data_header : public header {
+    SDN_data_header(SDN_data_header&) {} // cannot be called by users
+
+protected:
+    SDN_data_header() {} // this constructor cannot be directly called by users
+
+public:
+    ~SDN_data_header() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_data_header"; }
+    header_type_id type_id() const { return SDN_DATA_HEADER; }
+
+    class SDN_data_header_generator;
+    friend class SDN_data_header_generator;
+    friend class header::header_generator; // for the typed factory
+    // SDN_data_header_generator is derived from header_generator to generate a header
+    class SDN_data_header_generator : public header_generator {
+        static SDN_data_header_generator sample;
+        // this constructor is only for sample to register this header type
+        SDN_data_header_generator() { /*cout << "SDN_data_header registered" << endl;*/
+            register_header_type(&sample);
+        }
+
+    protected:
+        virtual header* generate() {
+            // cout << "SDN_data_header generated" << endl;
+            return new SDN_data_header;
+        }
+
+    public:
+        virtual string type() { return "SDN_data_header"; }
+        virtual header_type_id type_id() { return SDN_DATA_HEADER; }
+        ~SDN_data_header_generator() {}
+    };
+};
+SDN_data_header::SDN_data_header_generator SDN_data_header::SDN_data_header_generator::sample;
+object_pool SDN_data_header::pool("SDN_data_header", sizeof(SDN_data_header));
+
+class SDN_ctrl_header : public header {
+    SDN_ctrl_header(SDN_ctrl_header&) {} // cannot be called by users
+
+protected:
+    SDN_ctrl_header() {} // this constructor cannot be directly called by users
+
+public:
+    ~SDN_ctrl_header() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_ctrl_header"; }
+    header_type_id type_id() const { return SDN_CTRL_HEADER; }
+
+    class SDN_ctrl_header_generator;
+    friend class SDN_ctrl_header_generator;
+    friend class header::header_generator; // for the typed factory
+    // SDN_ctrl_header_generator is derived from header_generator to generate a header
+    class SDN_ctrl_header_generator : public header_generator {
+        static SDN_ctrl_header_generator sample;
+        // this constructor is only for sample to register this header type
+        SDN_ctrl_header_generator() { /*cout << "SDN_ctrl_header registered" << endl;*/
+            register_header_type(&sample);
+        }
+
+    protected:
+        virtual header* generate() {
+            // cout << "SDN_ctrl_header generated" << endl;
+            return new SDN_ctrl_header;
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_header"; }
+        virtual header_type_id type_id() { return SDN_CTRL_HEADER; }
+        ~SDN_ctrl_header_generator() {}
+    };
+};
+SDN_ctrl_header::SDN_ctrl_header_generator SDN_ctrl_header::SDN_ctrl_header_generator::sample;
+object_pool SDN_ctrl_header::pool("SDN_ctrl_header", sizeof(SDN_ctrl_header));
+
+class payload {
+    payload(payload&) {} // this constructor cannot be directly called by users
+
+    message msg;
+    atomic<unsigned int> ref_num; // the number of packets sharing this payload; the replicas may live in different threads
+    friend class packet;
+
+protected:
+    payload() : ref_num(1) {}
+    payload& operator=(const payload& p) { // ref_num is not copied
+        msg = p.msg;
+        return *this;
+    }
+
+public:
+    virtual ~payload() {}
+    virtual string type() = 0;
+    virtual payload_type_id type_id() const = 0;
+    // you have to implement your own clone() to copy your payload; it is used for copy-on-write
+    virtual payload* clone() const = 0;
+
+    SET(setMsg, message, msg, _msg);
+    GET(getMsg, message, msg);
+
+    class payload_generator {
+        // lock the copy constructor
+        payload_generator(payload_generator&) {}
+        // store all possible types of header
+        static map<string, payload_generator*> prototypes;
+        static payload_generator* id_prototypes[PAYLOAD_TYPE_NUM]; // indexed by type id
+
+    protected:
+        // allow derived class to use it
+        payload_generator() {}
+        // after you create a new payload type, please register the factory of this payload type by this function
+        void register_payload_type(payload_generator* h) {
+            prototypes[h->type()] = h;
+            id_prototypes[h->type_id()] = h;
+        }
+        // you have to implement your own generate() to generate your payload
+        virtual payload* generate() = 0;
+
+    public:
+        // you have to implement your own type() to return your header type
+        virtual string type() = 0;
+        virtual payload_type_id type_id() = 0;
+        // the typed factory: T is constructed directly, without looking up its generator; T has to befriend payload_generator
+        template <typename T>
+        static T* generate() { return new T; }
+        // this function is used to generate any type of header derived
+        static payload* generate(string type) {
+            if (prototypes.find(type) != prototypes.end()) {                                        // if this type derived exists
+                return prototypes[type]->generate(); // generate it!!
+            }
+            std::cerr << "no such payload type" << std::endl; // otherwise
+            return nullptr;
+        }
+        // the same as generate(string), but the type is found by its type id without a string lookup
+        static payload* generate(payload_type_id type) {
+            if (id_prototypes[type] != nullptr) // if this type derived exists
+                return id_prototypes[type]->generate(); // generate it!!
+            std::cerr << "no such payload type" << std::endl; // otherwise
+            return nullptr;
+        }
+        static void print() {
+            cout << "registered payload types: " << endl;
+            for (map<string, payload::payload_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
+                cout << it->second->type() << endl;
+        }
+        virtual ~payload_generator() {};
+    };
+};
+map<string, payload::payload_generator*> payload::payload_generator::prototypes;
+payload::payload_generator* payload::payload_generator::id_prototypes[PAYLOAD_TYPE_NUM];
+
+class SDN_data_payload : public payload {
+    SDN_data_payload(SDN_data_payload&) {}
+
+protected:
+    SDN_data_payload() {} // this constructor cannot be directly called by users
+public:
+    ~SDN_data_payload() {}
+    POOLED_NEW_DELETE
+
+    string type() { return "SDN_data_payload"; }
+    payload_type_id type_id() const { return SDN_DATA_PAYLOAD; }
+    payload* clone() const {
+        SDN_data_payload* p = new SDN_data_payload;
+        *p = *this;
+        return p;
+    }
+
+    class SDN_data_payload_generator;
+    friend class SDN_data_payload_generator;
+    friend class payload::payload_generator; // for the typed factory
+    // SDN_data_payload is derived from payload_generator to generate a payload
+    class SDN_data_payload_generator : public payload_generator {
+        static SDN_data_payload_generator sample;
+        // this constructor is only for sample to register this payload type
+        SDN_data_payload_generator() { /*cout << "SDN_data_payload registered" << endl;*/
+            register_payload_type(&sample);
+        }
+
+    protected:
+        virtual payload* generate() {
+            // cout << "SDN_data_payload generated" << endl;
+            return new SDN_data_payload;
+        }
+
+    public:
+        virtual string type() { return "SDN_data_payload"; }
+        virtual payload_type_id type_id() { return SDN_DATA_PAYLOAD; }
+        ~SDN_data_payload_generator() {}
+    };
+};
+SDN_data_payload::SDN_data_payload_generator SDN_data_payload::SDN_data_payload_generator::sample;
+object_pool SDN_data_payload::pool("SDN_data_payload", sizeof(SDN_data_payload));
+
+class SDN_ctrl_payload : public payload {
+    SDN_ctrl_payload(SDN_ctrl_payload&) {}
+
+    unsigned int matID; // match: target
+    unsigned int actID; // action: the next hop
+
+protected:
+    SDN_ctrl_payload() {} // this constructor cannot be directly called by users
+public:
+    ~SDN_ctrl_payload() {}
+    POOLED_NEW_DELETE
+
+    string type() { return "SDN_ctrl_payload"; }
+    payload_type_id type_id() const { return SDN_CTRL_PAYLOAD; }
+    payload* clone() const {
+        SDN_ctrl_payload* p = new SDN_ctrl_payload;
+        *p = *this;
+        return p;
+    }
+
+    SET(setMatID, unsigned int, matID, _matID);
+    GET(getMatID, unsigned int, matID);
+    SET(setActID, unsigned int, actID, _actID);
+    GET(getActID, unsigned int, actID);
+
+    class SDN_ctrl_payload_generator;
+    friend class SDN_ctrl_payload_generator;
+    friend class payload::payload_generator; // for the typed factory
+    // SDN_data_payload is derived from payload_generator to generate a payload
+    class SDN_ctrl_payload_generator : public payload_generator {
+        static SDN_ctrl_payload_generator sample;
+        // this constructor is only for sample to register this payload type
+        SDN_ctrl_payload_generator() { /*cout << "SDN_ctrl_payload registered" << endl;*/
+            register_payload_type(&sample);
+        }
+
+    protected:
+        virtual payload* generate() {
+            // cout << "SDN_ctrl_payload generated" << endl;
+            return new SDN_ctrl_payload;
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_payload"; }
+        virtual payload_type_id type_id() { return SDN_CTRL_PAYLOAD; }
+        ~SDN_ctrl_payload_generator() {}
+    };
+};
+SDN_ctrl_payload::SDN_ctrl_payload_generator SDN_ctrl_payload::SDN_ctrl_payload_generator::sample;
+object_pool SDN_ctrl_payload::pool("SDN_ctrl_payload", sizeof(SDN_ctrl_payload));
+
+class packet {
+    // a packet usually contains a header and a payload
+    header* hdr;
+    payload* pld;          // shared by the replicated packets until it is modified
+    unsigned int p_id;
+    unsigned int ref_num;  // the number of owners of this packet (e.g., events); see retain() and discard()
+    static unsigned int last_packet_id;
+    static thread_local unsigned int* id_block; // the ids reserved for the event run by this thread; see use_id_block()
+
+    packet(packet&) {}
+    static atomic<int> live_packet_num;
+
+    static unsigned int new_packet_id() { return id_block != nullptr ? (*id_block)++ : last_packet_id++; }
+
+protected:
+    // these constructors cannot be directly called by users
+    packet() : hdr(nullptr), pld(nullptr), ref_num(1) {
+        p_id = new_packet_id();
+        live_packet_num++;
+    }
+    packet(string _hdr, string _pld, bool rep = false, unsigned int rep_id = 0) : ref_num(1) {
+        if (!rep) // a duplicated packet does not have a new packet id
+            p_id = new_packet_id();
+        else
+            p_id = rep_id;
+        hdr = header::header_generator::generate(_hdr);
+        pld = payload::payload_generator::generate(_pld);
+        live_packet_num++;
+    }
+    // for the typed factory (see packet_generator::generate<T>()): the header and payload are already made
+    packet(header* _hdr, payload* _pld) : hdr(_hdr), pld(_pld), ref_num(1) {
+        p_id = new_packet_id();
+        live_packet_num++;
+    }
+    // for duplicate: the derived class copies the header, and the payload is shared (copy-on-write)
+    packet(packet* p) : pld(p->pld), p_id(p->p_id), ref_num(1) {
+        hdr = header::header_generator::generate(p->hdr->type_id());
+        if (pld != nullptr)
+            pld->ref_num++;
+        live_packet_num++;
+    }
+
+public:
+    virtual ~packet() {
+        // cout << "packet destructor begin" << endl;
+        if (hdr != nullptr)
+            delete hdr;
+        if (pld != nullptr && --pld->ref_num == 0) // the last packet sharing the payload
+            delete pld;
+        live_packet_num--;
+        // cout << "packet destructor end" << endl;
+    }
+
+    SET(setHeader, header*, hdr, _hdr);
+    GET(getHeader, header*, hdr);
+    SET(setPayload, payload*, pld, _pld);
+    // the payload may be shared with the replicated packets, so it is read-only
+    const payload* getPayload() const { return pld; }
+    // copy-on-write: a shared payload is cloned before it is modified
+    payload* getMutablePayload() {
+        if (pld != nullptr && pld->ref_num > 1) {
+            payload* copy = pld->clone();
+            if (--pld->ref_num == 0) // the other owners gave it up in the meantime
+                delete pld;
+            pld = copy;
+        }
+        return pld;
+    }
+    GET(getPacketID, unsigned int, p_id);
+    GET(getRefNum, unsigned int, ref_num);
+
+    // add an owner to packet p; each owner has to discard p once
+    static packet* retain(packet* p) {
+        if (p != nullptr)
+            p->ref_num++;
+        return p;
+    }
+    static void discard(packet*& p) {
+        // cout << "checking" << endl;
+        if (p != nullptr && --p->ref_num == 0) { // the last owner deletes the packet
+            // cout << "discarding" << endl;
+            // cout << p->type() << endl;
+            delete p;
+            // cout << "discarded" << endl;
+        }
+        p = nullptr;
+        // cout << "checked" << endl;
+    }
+    virtual string type() = 0;
+    virtual packet_type_id type_id() const = 0;
+
+    static int getLivePacketNum() { return live_packet_num; }
+
+    // take num packet ids in advance; the packets of an event get the same ids as in the sequential engine
+    // no matter which thread runs the event
+    static unsigned int reserve_ids(unsigned int num) {
+        unsigned int first = last_packet_id;
+        last_packet_id += num;
+        return first;
+    }
+    // the new packets of this thread take their ids from *block (nullptr: from the global counter)
+    static void use_id_block(unsigned int* block) { id_block = block; }
+
+    class packet_generator;
+    friend class packet_generator;
+    class packet_generator {
+        // lock the copy constructor
+        packet_generator(packet_generator&) {}
+        // store all possible types of packet
+        static map<string, packet_generator*> prototypes;
+        static packet_generator* id_prototypes[PACKET_TYPE_NUM]; // indexed by type id
+
+    protected:
+        // allow derived class to use it
+        packet_generator() {}
+        // after you create a new packet type, please register the factory of this payload type by this function
+        void register_packet_type(packet_generator* h) {
+            prototypes[h->type()] = h;
+            id_prototypes[h->type_id()] = h;
+        }
+        // you have to implement your own generate() to generate your payload
+        virtual packet* generate(packet* p = nullptr) = 0;
+
+    public:
+        // you have to implement your own type() to return your packet type
+        virtual string type() = 0;
+        virtual packet_type_id type_id() = 0;
+        // this function is used to generate any type of packet derived
+        static packet* generate(string type) {
+            if (prototypes.find(type) != prototypes.end()) {                                        // if this type derived exists
+                return prototypes[type]->generate(); // generate it!!
+            }
+            std::cerr << "no such packet type" << std::endl; // otherwise
+            return nullptr;
+        }
+        // the typed factory: T, its header (T::header_type) and its payload (T::payload_type) are constructed directly,
+        // without the string lookups of generate(string); T has to befriend packet_generator
+        template <typename T>
+        static T* generate() {
+            return new T(header::header_generator::generate<typename T::header_type>(), payload::payload_generator::generate<typename T::payload_type>());
+        }
+        // the same as generate(string), but the type is found by its type id without a string lookup
+        static packet* generate(packet_type_id type) {
+            if (id_prototypes[type] != nullptr) // if this type derived exists
+                return id_prototypes[type]->generate(); // generate it!!
+            std::cerr << "no such packet type" << std::endl; // otherwise
+            return nullptr;
+        }
+        static packet* replicate(packet* p) {
+            if (id_prototypes[p->type_id()] != nullptr) { // if this type derived exists
+                return id_prototypes[p->type_id()]->generate(p); // generate it!!
+            }
+            std::cerr << "no such packet type" << std::endl; // otherwise
+            return nullptr;
+        }
+        // the type name of the packet type id; used when the trace is rendered
+        static const char* type_name(packet_type_id type) {
+            static string names[PACKET_TYPE_NUM];
+            if (type >= PACKET_TYPE_NUM || id_prototypes[type] == nullptr)
+                return "unknown_packet";
+            if (names[type].empty())
+                names[type] = id_prototypes[type]->type();
+            return names[type].c_str();
+        }
+        static void print() {
+            cout << "registered packet types: " << endl;
+            for (map<string, packet::packet_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
+                cout << it->second->type() << endl;
+        }
+        virtual ~packet_generator() {};
+    };
+};
+map<string, packet::packet_generator*> packet::packet_generator::prototypes;
+packet::packet_generator* packet::packet_generator::id_prototypes[PACKET_TYPE_NUM];
+unsigned int packet::last_packet_id = 0;
+thread_local unsigned int* packet::id_block = nullptr;
+atomic<int> packet::live_packet_num(0);
+
+// this packet is used to tell the destination the msg
+class SDN_data_packet : public packet {
+    SDN_data_packet(SDN_data_packet&) {}
+
+protected:
+    SDN_data_packet() {} // this constructor cannot be directly called by users
+    SDN_data_packet(packet* p) : packet(p) {
+        *(dynamic_cast<SDN_data_header*>(this->getHeader())) = *(dynamic_cast<SDN_data_header*>(p->getHeader()));
+        // DFS_path = (dynamic_cast<SDN_data_header*>(p))->DFS_path;
+        // isVisited = (dynamic_cast<SDN_data_header*>(p))->isVisited;
+    } // for duplicate
+    SDN_data_packet(header* _h, payload* _p) : packet(_h, _p) {}
+
+public:
+    virtual ~SDN_data_packet() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_data_packet"; }
+    typedef SDN_data_header header_type;
+    typedef SDN_data_payload payload_type;
+    packet_type_id type_id() const { return SDN_DATA_PACKET; }
+
+    class SDN_data_packet_generator;
+    friend class SDN_data_packet_generator;
+    friend class packet::packet_generator; // for the typed factory
+    // SDN_data_packet is derived from packet_generator to generate a pub packet
+    class SDN_data_packet_generator : public packet_generator {
+        static SDN_data_packet_generator sample;
+        // this constructor is only for sample to register this packet type
+        SDN_data_packet_generator() { /*cout << "SDN_data_packet registered" << endl;*/
+            register_packet_type(&sample);
+        }
+
+    protected:
+        virtual packet* generate(packet* p = nullptr) {
+            // cout << "SDN_data_packet generated" << endl;
+            if (nullptr == p)
+                return packet_generator::generate<SDN_data_packet>();
+            else
+                return new SDN_data_packet(p); // duplicate; the payload is shared
+        }
+
+    public:
+        virtual string type() { return "SDN_data_packet"; }
+        virtual packet_type_id type_id() { return SDN_DATA_PACKET; }
+        ~SDN_data_packet_generator() {}
+    };
+};
+SDN_data_packet::SDN_data_packet_generator SDN_data_packet::SDN_data_packet_generator::sample;
+object_pool SDN_data_packet::pool("SDN_data_packet", sizeof(SDN_data_packet));
+
+class SDN_ctrl_packet : public packet {
+    SDN_ctrl_packet(SDN_ctrl_packet&) {}
+
+protected:
+    SDN_ctrl_packet() {} // this constructor cannot be directly called by users
+    SDN_ctrl_packet(packet* p) : packet(p) {
+        *(dynamic_cast<SDN_ctrl_header*>(this->getHeader())) = *(dynamic_cast<SDN_ctrl_header*>(p->getHeader()));
+        // DFS_path = (dynamic_cast<SDN_ctrl_header*>(p))->DFS_path;
+        // isVisited = (dynamic_cast<SDN_ctrl_header*>(p))->isVisited;
+    } // for duplicate
+    SDN_ctrl_packet(header* _h, payload* _p) : packet(_h, _p) {}
+
+public:
+    virtual ~SDN_ctrl_packet() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_ctrl_packet"; }
+    typedef SDN_ctrl_header header_type;
+    typedef SDN_ctrl_payload payload_type;
+    packet_type_id type_id() const { return SDN_CTRL_PACKET; }
+
+    class SDN_ctrl_packet_generator;
+    friend class SDN_ctrl_packet_generator;
+    friend class packet::packet_generator; // for the typed factory
+    // SDN_ctrl_packet is derived from packet_generator to generate a pub packet
+    class SDN_ctrl_packet_generator : public packet_generator {
+        static SDN_ctrl_packet_generator sample;
+        // this constructor is only for sample to register this packet type
+        SDN_ctrl_packet_generator() { /*cout << "SDN_ctrl_packet registered" << endl;*/
+            register_packet_type(&sample);
+        }
+
+    protected:
+        virtual packet* generate(packet* p = nullptr) {
+            // cout << "SDN_ctrl_packet generated" << endl;
+            if (nullptr == p)
+                return packet_generator::generate<SDN_ctrl_packet>();
+            else
+                return new SDN_ctrl_packet(p); // duplicate; the payload is shared
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_packet"; }
+        virtual packet_type_id type_id() { return SDN_CTRL_PACKET; }
+        ~SDN_ctrl_packet_generator() {}
+    };
+};
+SDN_ctrl_packet::SDN_ctrl_packet_generator SDN_ctrl_packet::SDN_ctrl_packet_generator::sample;
+object_pool SDN_ctrl_packet::pool("SDN_ctrl_packet", sizeof(SDN_ctrl_packet));
+
+class node {
+    // all nodes created in the program, indexed by node id (nullptr if the id is not used)
+    static vector<node*> id_node_table;
+    static unsigned int node_num;
+
+    unsigned int id;
+    map<unsigned int, bool> phy_neighbors;
+    vector<pair<unsigned int, link*>> nb_links; // the neighbors and the links toward them, sorted by neighbor id; for send()
+
+protected:
+    node(node&) {} // this constructor should not be used
+    node() {}       // this constructor should not be used
+    node(unsigned int _id) : id(_id) {
+        if (id_node_table.size() <= _id)
+            id_node_table.resize(_id + 1, nullptr);
+        id_node_table[_id] = this;
+        node_num++;
+    }
+
+public:
+    virtual ~node() { // erase the node
+        del_node(id);
+    }
+    virtual string type() = 0; // please define it in your derived node class
+
+    void add_phy_neighbor(unsigned int _id, string link_type = "simple_link"); // we only add a directed link from id to _id
+    void del_phy_neighbor(unsigned int _id);                                   // we only delete a directed link from id to _id
+
+    // you can use the function to get the node's neigbhors at this time
+    // but in the project 3, you are not allowed to use this function
+    const map<unsigned int, bool>& getPhyNeighbors() {
+        return phy_neighbors;
+    }
+
+    void recv(packet* p) {
+        packet* tp = p;
+        recv_handler(tp);
+        packet::discard(p);
+    } // the packet will be directly deleted after the handler
+    void send(packet* p);
+
+    // receive the packet and do something; this is a pure virtual function
+    virtual void recv_handler(packet* p) = 0;
+    void send_handler(packet* P);
+
+    static node* id_to_node(unsigned int _id) { return (_id < id_node_table.size()) ? id_node_table[_id] : nullptr; }
+    GET(getNodeID, unsigned int, id);
+
+    static void del_node(unsigned int _id) {
+        if (id_to_node(_id) != nullptr) {
+            id_node_table[_id] = nullptr;
+            node_num--;
+        }
+    }
+    static unsigned int getNodeNum() { return node_num; }
+    static unsigned int getNodeIDBound() { return id_node_table.size(); } // every node id is smaller than it
+
+    class node_generator {
+        // lock the copy constructor
+        node_generator(node_generator&) {}
+        // store all possible types of node
+        static map<string, node_generator*> prototypes;
+
+    protected:
+        // allow derived class to use it
+        node_generator() {}
+        // after you create a new node type, please register the factory of this node type by this function
+        void register_node_type(node_generator* h) { prototypes[h->type()] = h; }
+        // you have to implement your own generate() to generate your node
+        virtual node* generate(unsigned int _id) = 0;
+
+    public:
+        // you have to implement your own type() to return your node type
+        virtual string type() = 0;
+        // this function is used to generate any type of node derived
+        static node* generate(string type, unsigned int _id) {
+            if (id_to_node(_id) != nullptr) {
+                std::cerr << "duplicate node id" << std::endl; // node id is duplicated
+                return nullptr;
+            }
+            else if (BROCAST_ID == _id) {
+                cerr << "BROCAST_ID cannot be used" << endl;
+                return nullptr;
+            }
+            else if (prototypes.find(type) != prototypes.end()) { // if this type derived exists
+                node* created_node = prototypes[type]->generate(_id);
+                return created_node; // generate it!!
+            }
+            std::cerr << "no such node type" << std::endl; // otherwise
+            return nullptr;
+        }
+        static void print() {
+            cout << "registered node types: " << endl;
+            for (map<string, node::node_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
+                cout << it->second->type() << endl;
+        }
+        virtual ~node_generator() {};
+    };
+};
+map<string, node::node_generator*> node::node_generator::prototypes;
+vector<node*> node::id_node_table;
+unsigned int node::node_num = 0;
+
+// forwarding table of a switch: the next hop toward each destination
+// the rules are stored in an array indexed by the destination id, so a lookup is O(1);
+// unlike map::operator[], a lookup of a missing destination never adds a rule
+class forwarding_table {
+public:
+    // a change of a rule: the table, the destination, and the next hop before the change
+    struct change {
+        forwarding_table* table;
+        unsigned int dst;
+        unsigned int next;
+    };
+
+private:
+    vector<unsigned int> next_hop; // BROCAST_ID means that there is no rule for the destination
+    unsigned int rule_num;
+    static thread_local vector<change>* journal; // see log_to()
+
+    // every change of a rule goes through set(), so that it can be logged
+    void set(unsigned int dst, unsigned int next) {
+        if (journal != nullptr)
+            journal->push_back(change{this, dst, next_hop[dst]});
+        if (next_hop[dst] == BROCAST_ID && next != BROCAST_ID)
+            rule_num++;
+        else if (next_hop[dst] != BROCAST_ID && next == BROCAST_ID)
+            rule_num--;
+        next_hop[dst] = next;
+    }
+
+public:
+    forwarding_table() : rule_num(0) {}
+
+    // the old rules of the tables changed by this thread are appended to *changes (nullptr: not logged);
+    // the optimistic engine logs the changes of an event so that a rollback can undo them (incremental state saving)
+    static void log_to(vector<change>* changes) { journal = changes; }
+    // restore the rule before the change; the changes of an event have to be undone in the reverse order
+    static void undo(const change& c) { c.table->set(c.dst, c.next); }
+
+    // add or replace the rule of destination dst; a rule with BROCAST_ID, which marks a destination without a rule in the
+    // table, is rejected: false is returned and the table is not changed
+    bool install(unsigned int dst, unsigned int next) {
+        if (dst == BROCAST_ID || next == BROCAST_ID)
+            return false;
+        if (dst >= next_hop.size())
+            next_hop.resize(dst + 1, BROCAST_ID);
+        set(dst, next);
+        return true;
+    }
+    // add or replace a batch of (destination, next hop) rules, e.g., the rules pushed by the controller at once;
+    // false if a rule is rejected (see above), but the other rules are still installed
+    bool install(const vector<pair<unsigned int, unsigned int>>& rules) {
+        unsigned int max_dst = 0;
+        for (size_t i = 0; i < rules.size(); i++)
+            if (rules[i].first != BROCAST_ID && rules[i].first > max_dst)
+                max_dst = rules[i].first;
+        if (!rules.empty() && max_dst >= next_hop.size())
+            next_hop.resize(max_dst + 1, BROCAST_ID); // grow the table only once
+        bool installed = true;
+        for (size_t i = 0; i < rules.size(); i++)
+            installed = install(rules[i].first, rules[i].second) && installed;
+        return installed;
+    }
+    void remove(unsigned int dst) {
+        if (contains(dst))
+            set(dst, BROCAST_ID);
+    }
+
+    // return false if there is no rule for dst (next is not changed in this case)
+    bool lookup(unsigned int dst, unsigned int& next) const {
+        if (!contains(dst))
+            return false;
+        next = next_hop[dst];
+        return true;
+    }
+    bool contains(unsigned int dst) const { return dst < next_hop.size() && next_hop[dst] != BROCAST_ID; }
+    unsigned int size() const { return rule_num; }
+};
+thread_local vector<forwarding_table::change>* forwarding_table::journal = nullptr;
+
+class SDN_switch : public node {
+    // map<unsigned int,bool> one_hop_neighbors; // you can use this variable to record the node's 1-hop neighbors
+
+    // bool hi; // this is used for example; you can remove it when doing hw2
+
+protected:
+    SDN_switch() {}                             // it should not be used
+    SDN_switch(SDN_switch&) {}                 // it should not be used
+    SDN_switch(unsigned int _id) : node(_id) {} // this constructor cannot be directly called by users
+
+public:
+    ~SDN_switch() {}
+    string type() { return "SDN_switch"; }
+
+    forwarding_table routing_table;
+
+    // please define recv_handler function to deal with the incoming packet
+    virtual void recv_handler(packet* p);
+
+    // void add_one_hop_neighbor (unsigned int n_id) { one_hop_neighbors[n_id] = true; }
+    // unsigned int get_one_hop_neighbor_num () { return one_hop_neighbors.size(); }
+
+    class SDN_switch_generator;
+    friend class SDN_switch_generator;
+    // SDN_switch is derived from node_generator to generate a node
+    class SDN_switch_generator : public node_generator {
+        static SDN_switch_generator sample;
+        // this constructor is only for sample to register this node type
+        SDN_switch_generator() { /*cout << "SDN_switch registered" << endl;*/
+            register_node_type(&sample);
+        }
+
+    protected:
+        virtual node* generate(unsigned int _id) { /*cout << "SDN_switch generated" << endl;*/
+            return new SDN_switch(_id);
+        }
+
+    public:
+        virtual string type() { return "SDN_switch"; }
+        ~SDN_switch_generator() {}
+    };
+};
+SDN_switch::SDN_switch_generator SDN_switch::SDN_switch_generator::sample;
+
+class SDN_controller : public node {
+    // map<unsigned int,bool> one_hop_neighbors; // you can use this variable to record the node's 1-hop neighbors
+
+    // bool hi; // this is used for example; you can remove it when doing hw2
+
+protected:
+    SDN_controller() {}                             // it should not be used
+    SDN_controller(SDN_controller&) {}             // it should not be used
+    SDN_controller(unsigned int _id) : node(_id) {} // this constructor cannot be directly called by users
+
+public:
+    ~SDN_controller() {}
+    string type() { return "SDN_controller"; }
+
+    // please define recv_handler function to deal with the incoming packet
+    virtual void recv_handler(packet* p);
+
+    // void add_one_hop_neighbor (unsigned int n_id) { one_hop_neighbors[n_id] = true; }
+    // unsigned int get_one_hop_neighbor_num () { return one_hop_neighbors.size(); }
+
+    class SDN_controller_generator;
+    friend class SDN_controller_generator;
+    // SDN_controller is derived from node_generator to generate a node
+    class SDN_controller_generator : public node_generator {
+        static SDN_controller_generator sample;
+        // this constructor is only for sample to register this node type
+        SDN_controller_generator() { /*cout << "SDN_controller registered" << endl;*/
+            register_node_type(&sample);
+        }
+
+    protected:
+        virtual node* generate(unsigned int _id) { /*cout << "SDN_controller generated" << endl;*/
+            return new SDN_controller(_id);
+        }
+
+    public:
+        virtual string type() { return "SDN_controller"; }
+        ~SDN_controller_generator() {}
+    };
+};
+SDN_controller::SDN_controller_generator SDN_controller::SDN_controller_generator::sample;
+
+// the log of the simulation; every event::print() fills a trace::record and hands it to trace::write()
+// text mode (default): the records are rendered in the text format and written to cout in big blocks instead of line by line
+// binary mode: the records are kept in their compact binary format; full batches are written to the file by a background thread
+//              and the file can be rendered to the text format later (see trace::render(string))
+// none mode: nothing is recorded, and start_simulate() does not even call print()
+class trace {
+public:
+    enum trace_mode { TEXT, BINARY, NONE };
+    enum record_kind { RECV, SEND, GEN, GEN_RULE };
+    struct record {
+        unsigned int time;
+        unsigned char kind;     // record_kind
+        unsigned char pkt_type; // packet_type_id
+        unsigned short reserved;
+        unsigned int field[6]; // RECV/SEND: node, pktID, srcID, dstID, preID, nexID; GEN/GEN_RULE: srcID, dstID, matID, actID
+    };
+
+private:
+    static const unsigned int VERSION = 1;
+    static const unsigned int BATCH_SIZE = 1 << 16; // records per batch
+    static const unsigned int TEXT_BLOCK = 1 << 16; // bytes of text per write to cout
+
+    static trace_mode mode;
+    static string text; // the rendered text which is not written to cout yet
+    static vector<record> batch; // the batch filled by the simulation
+    static vector<vector<record>> full_batches; // the batches waiting for the writer thread
+    static mutex batch_lock;
+    static condition_variable batch_cv;
+    static bool closing;
+    static thread writer;
+    static FILE* file;
+    static thread_local vector<record>* capture; // see capture_to()
+
+    static void write_batches(); // the loop of the writer thread
+    static void render(const record& r, string& out);
+
+public:
+    // binary mode needs the file to write; returns false if the file cannot be opened
+    static bool open(trace_mode _mode, string file_name = "");
+    static bool open(string _mode, string file_name = "");
+    // hand the buffered records over (to cout or to the writer thread)
+    static void flush();
+    // flush the records and wait until the binary file is completely written
+    static void close();
+    static bool enabled() { return mode != NONE; }
+    // the records written by this thread are appended to *records instead (nullptr: written as usual);
+    // the parallel engine merges the records of its workers in the event order
+    static void capture_to(vector<record>* records) { capture = records; }
+    static void write(const record& r) {
+        if (capture != nullptr) {
+            capture->push_back(r);
+            return;
+        }
+        if (mode == TEXT) {
+            render(r, text);
+            if (text.size() >= TEXT_BLOCK)
+                flush();
+        }
+        else if (mode == BINARY) {
+            batch.push_back(r);
+            if (batch.size() >= BATCH_SIZE)
+                flush();
+        }
+    }
+    // render a binary trace file to cout in the text format; returns false if the file is not a trace file
+    static bool render(string file_name);
+};
+trace::trace_mode trace::mode = trace::TEXT;
+string trace::text;
+vector<trace::record> trace::batch;
+vector<vector<trace::record>> trace::full_batches;
+mutex trace::batch_lock;
+condition_variable trace::batch_cv;
+bool trace::closing = false;
+thread trace::writer;
+FILE* trace::file = nullptr;
+thread_local vector<trace::record>* trace::capture = nullptr;
+
+bool trace::open(trace_mode _mode, string file_name) {
+    close();
+    mode = _mode;
+    if (mode != BINARY)
+        return true;
+    file = fopen(file_name.c_str(), "wb");
+    if (file == nullptr) {
+        cerr << "cannot open the trace file " << file_name << endl;
+        mode = NONE;
+        return false;
+    }
+    // file header: magic, format version, record size
+    unsigned int head[2] = {VERSION, (unsigned int)sizeof(record)};
+    fwrite("SDNTRACE", 1, 8, file);
+    fwrite(head, sizeof(head), 1, file);
+    closing = false;
+    batch.reserve(BATCH_SIZE);
+    writer = thread(write_batches);
+    return true;
+}
+bool trace::open(string _mode, string file_name) {
+    if (_mode == "text")
+        return open(TEXT);
+    if (_mode == "binary")
+        return open(BINARY, file_name);
+    if (_mode == "none")
+        return open(NONE);
+    cerr << "no such trace mode" << endl;
+    return false;
+}
+void trace::flush() {
+    if (mode == TEXT) {
+        cout.write(text.data(), text.size());
+        cout.flush();
+        text.clear();
+    }
+    else if (mode == BINARY && !batch.empty()) {
+        {
+            lock_guard<mutex> guard(batch_lock);
+            full_batches.push_back(move(batch));
+        }
+        batch_cv.notify_one();
+        batch = vector<record>();
+        batch.reserve(BATCH_SIZE);
+    }
+}
+void trace::close() {
+    flush();
+    if (mode == BINARY) {
+        {
+            lock_guard<mutex> guard(batch_lock);
+            closing = true;
+        }
+        batch_cv.notify_one();
+        writer.join();
+        fclose(file);
+        file = nullptr;
+    }
+    mode = TEXT;
+}
+void trace::write_batches() {
+    vector<vector<record>> batches;
+    while (true) {
+        {
+            unique_lock<mutex> guard(batch_lock);
+            batch_cv.wait(guard, [] { return closing || !full_batches.empty(); });
+            batches.swap(full_batches);
+            if (batches.empty() && closing)
+                return;
+        }
+        for (unsigned int i = 0; i < batches.size(); i++)
+            fwrite(batches[i].data(), sizeof(record), batches[i].size(), file);
+        batches.clear();
+    }
+}
+void trace::render(const record& r, string& out) {
+    // the same format as the old event::print() with cout and setw(11)
+    char line[256];
+    const char* pkt_type = packet::packet_generator::type_name((packet_type_id)r.pkt_type);
+    int len = 0;
+    switch (r.kind) {
+    case RECV:
+    case SEND:
+        len = snprintf(line, sizeof(line), "time %11u   %sID%11u   pktID%11u   srcID%11u   dstID%11u   preID%11u   nexID%11u   %s\n",
+            r.time, r.kind == RECV ? "rec" : "sen", r.field[0], r.field[1], r.field[2], r.field[3], r.field[4], r.field[5], pkt_type);
+        break;
+    case GEN:
+        len = snprintf(line, sizeof(line), "time %11u        %11s        %11s   srcID%11u   dstID%11u        %11s        %11s   %s generating\n",
+            r.time, " ", " ", r.field[0], r.field[1], " ", " ", pkt_type);
+        break;
+    case GEN_RULE:
+        len = snprintf(line, sizeof(line), "time %11u        %11s        %11s   srcID%11u   dstID%11u   matID%11u   actID%11u   %s generating\n",
+            r.time, " ", " ", r.field[0], r.field[1], r.field[2], r.field[3], pkt_type);
+        break;
+    }
+    out.append(line, len);
+}
+bool trace::render(string file_name) {
+    FILE* in = fopen(file_name.c_str(), "rb");
+    if (in == nullptr) {
+        cerr << "cannot open the trace file " << file_name << endl;
+        return false;
+    }
+    char magic[8];
+    unsigned int head[2];
+    if (fread(magic, 1, 8, in) != 8 || memcmp(magic, "SDNTRACE", 8) != 0
+        || fread(head, sizeof(head), 1, in) != 1 || head[0] != VERSION || head[1] != sizeof(record)) {
+        cerr << file_name << " is not a trace file of version " << VERSION << endl;
+        fclose(in);
+        return false;
+    }
+    vector<record> records(BATCH_SIZE);
+    string out;
+    size_t num;
+    while ((num = fread(records.data(), sizeof(record), records.size(), in)) > 0) {
+        for (size_t i = 0; i < num; i++)
+            render(records[i], out);
+        cout.write(out.data(), out.size());
+        out.clear();
+    }
+    cout.flush();
+    fclose(in);
+    return true;
+}
+
+// the order of the events: by trigger time, then by the hash of the event (see event::event_priority()), as it has
+// always been, so the traces stay the same; the events of the same time and hash (e.g., two flows of the same source
+// and destination at the same time) are ordered by their sequence numbers (see event::next_seq()), which no two events
+// share, so the order is total, and every engine and scheduler runs tied events in the same order
+struct event_key {
+    unsigned long long key; // (trigger_time << 32) | event_priority()
+    unsigned long long seq;
+    bool operator<(const event_key& k) const { return key != k.key ? key < k.key : seq < k.seq; }
+};
+
+class mycomp {
+    bool reverse;
+
+public:
+    mycomp(const bool& revparam = false) { reverse = revparam; }
+    bool operator()(const event* lhs, const event* rhs) const;
+};
+
+// the scheduler stores the pending events and returns them in the order of mycomp
+class scheduler {
+    // lock the copy constructor
+    scheduler(const scheduler&) = delete;
+
+protected:
+    scheduler() {}
+
+public:
+    virtual ~scheduler() {}
+    virtual string type() = 0;
+
+    virtual void push(event* e) = 0;
+    // push many events at once; a backend may build its structure in one pass instead of pushing them one by one
+    virtual void push(const vector<event*>& es) {
+        for (size_t i = 0; i < es.size(); i++)
+            push(es[i]);
+    }
+    virtual event* pop() = 0; // return nullptr if there is no event
+    virtual size_t size() const = 0;
+    bool empty() const { return size() == 0; }
+
+    class scheduler_generator {
+        // lock the copy constructor
+        scheduler_generator(const scheduler_generator&) = delete;
+        // store all possible types of scheduler
+        static map<string, scheduler_generator*> prototypes;
+
+    protected:
+        // allow derived class to use it
+        scheduler_generator() {}
+        // after you create a new scheduler type, please register the factory of this scheduler type by this function
+        void register_scheduler_type(scheduler_generator* h) { prototypes[h->type()] = h; }
+        // you have to implement your own generate() to generate your scheduler
+        virtual scheduler* generate() = 0;
+
+    public:
+        // you have to implement your own type() to return your scheduler type
+        virtual string type() = 0;
+        // this function is used to generate any type of scheduler derived
+        static scheduler* generate(string type) {
+            if (prototypes.find(type) != prototypes.end()) { // if this type derived exists
+                return prototypes[type]->generate(); // generate it!!
+            }
+            std::cerr << "no such scheduler type" << std::endl; // otherwise
+            return nullptr;
+        }
+        static void print() {
+            cout << "registered scheduler types: " << endl;
+            for (map<string, scheduler::scheduler_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
+                cout << it->second->type() << endl;
+        }
+        virtual ~scheduler_generator() {};
+    };
+};
+map<string, scheduler::scheduler_generator*> scheduler::scheduler_generator::prototypes;
+
+// binary heap; O(log n) per operation
+class heap_scheduler : public scheduler {
+    heap_scheduler(const heap_scheduler&) = delete; // it should not be used
+    vector<event*> events; // a heap ordered by mycomp, as the one of priority_queue; it is kept open for the bulk push
+    mycomp comp;
+
+protected:
+    heap_scheduler() {} // this constructor cannot be directly called by users
+
+public:
+    ~heap_scheduler() {}
+    string type() { return "heap_scheduler"; }
+
+    void push(event* e) {
+        events.push_back(e);
+        push_heap(events.begin(), events.end(), comp);
+    }
+    // heapify in O(n + k) if the new events are at least as many as the pending ones; otherwise O(k log n) pushes are cheaper
+    // the heap differs from the one built by pushes, but no two events have the same key (see event_key), so the events
+    // are popped in the same order
+    void push(const vector<event*>& es);
+    event* pop() {
+        if (events.empty())
+            return nullptr;
+        pop_heap(events.begin(), events.end(), comp);
+        event* e = events.back();
+        events.pop_back();
+        return e;
+    }
+    size_t size() const { return events.size(); }
+
+    class heap_scheduler_generator;
+    friend class heap_scheduler_generator;
+    // heap_scheduler_generator is derived from scheduler_generator to generate a scheduler
+    class heap_scheduler_generator : public scheduler_generator {
+        static heap_scheduler_generator sample;
+        // this constructor is only for sample to register this scheduler type
+        heap_scheduler_generator() { register_scheduler_type(&sample); }
+
+    protected:
+        virtual scheduler* generate() { return new heap_scheduler; }
+
+    public:
+        virtual string type() { return "heap_scheduler"; }
+        ~heap_scheduler_generator() {}
+    };
+};
+heap_scheduler::heap_scheduler_generator heap_scheduler::heap_scheduler_generator::sample;
+
+// calendar queue (R. Brown, 1988): the time axis is cut into buckets of "width" time units and
+// bucket i holds the events whose (trigger_time / width) % bucket number == i
+// since the link delay is a small constant, the events of one time slot fall into one short bucket,
+// so push is O(1) and pop only pays for the events sharing its own slot
+// each bucket is kept as a small binary heap so that the events of one slot still follow mycomp; no two events have the
+// same key (see event_key), so the pop order is the one of heap_scheduler even for the events of the same time
+class calendar_scheduler : public scheduler {
+    calendar_scheduler(const calendar_scheduler&) = delete; // it should not be used
+
+    static const size_t MIN_BUCKET_NUM = 16;
+    static const size_t MAX_BUCKET_NUM = 1 << 16;
+
+    vector<vector<event*>> buckets;
+    unsigned int width;            // the time span covered by a bucket
+    size_t cur_bucket;             // the bucket of the current time slot
+    unsigned long long bucket_top; // the end of the current time slot
+    size_t event_num;
+    mycomp comp;
+
+    size_t bucket_of(unsigned int t) const { return (t / width) & (buckets.size() - 1); }
+    void jump_to(unsigned int t) { // move the current time slot to the slot of time t
+        cur_bucket = bucket_of(t);
+        bucket_top = ((unsigned long long)t / width + 1) * width;
+    }
+    void resize(size_t bucket_num);
+
+protected:
+    calendar_scheduler() : buckets(MIN_BUCKET_NUM), width(ONE_HOP_DELAY), cur_bucket(0), bucket_top(ONE_HOP_DELAY), event_num(0) {} // this constructor cannot be directly called by users
+
+public:
+    ~calendar_scheduler() {}
+    string type() { return "calendar_scheduler"; }
+
+    void push(event* e);
+    void push(const vector<event*>& es);
+    event* pop();
+    size_t size() const { return event_num; }
+
+    class calendar_scheduler_generator;
+    friend class calendar_scheduler_generator;
+    // calendar_scheduler_generator is derived from scheduler_generator to generate a scheduler
+    class calendar_scheduler_generator : public scheduler_generator {
+        static calendar_scheduler_generator sample;
+        // this constructor is only for sample to register this scheduler type
+        calendar_scheduler_generator() { register_scheduler_type(&sample); }
+
+    protected:
+        virtual scheduler* generate() { return new calendar_scheduler; }
+
+    public:
+        virtual string type() { return "calendar_scheduler"; }
+        ~calendar_scheduler_generator() {}
+    };
+};
+calendar_scheduler::calendar_scheduler_generator calendar_scheduler::calendar_scheduler_generator::sample;
+
+// a stream of initial events in the order of their trigger time, e.g., the data packets of a long trace; the engines pull
+// the events of the next window from it while they run, so the pending events are the events in flight, not the whole trace
+class traffic_source {
+public:
+    virtual ~traffic_source() {}
+    // the trigger time of the next event; ULLONG_MAX if the source has no more events
+    virtual unsigned long long next_time() = 0;
+    // append the events whose trigger time is earlier than end to es
+    virtual void pull(unsigned long long end, vector<event*>& es) = 0;
+};
+
+class event {
+    event(event*&) {} // this constructor cannot be directly called by users
+    static scheduler* events; // the pending events; the backend can be changed by set_scheduler()
+    static thread_local unsigned int cur_time; // timer; each worker of the parallel engine has its own
+    static unsigned int end_time;
+    static unsigned int thread_num; // 1: the sequential engine; otherwise the parallel engine with thread_num partitions
+    static bool optimistic;         // the parallel engine is the optimistic one (Time Warp) instead of the conservative one
+    static traffic_source* traffic; // see set_traffic()
+    static unsigned long long run_num; // the events run by the engines so far (committed ones for the optimistic engine)
+    static const unsigned int TRAFFIC_WINDOW = 1024; // the sequential and optimistic engines pull the traffic of this long at a time
+
+    class partition; // a part of the nodes and their events; see start_simulate_parallel()
+    static void start_simulate_parallel();
+    class logical_process; // a part of the nodes run optimistically; see start_simulate_optimistic()
+    static void start_simulate_optimistic();
+
+    // get the next event
+    static event* get_next_event();
+    // get the next event of the sequential engine; the traffic which is not later than it is pulled into the scheduler first
+    static event* pull_next_event();
+    static void add_event(event* e);
+
+    static thread_local const event* running;  // the event triggered by this thread; nullptr out of trigger()
+    static unsigned long long outside_num;     // the events generated out of trigger(), e.g., by main() or a traffic source
+    static vector<unsigned int> generated_num; // the events generated by the events of each node; see next_seq()
+    static unsigned long long next_seq();
+    // the index of the counter in generated_num of the events generated by e
+    static size_t generated_slot(const event* e) { return 2 * (size_t)e->owner() + (e->packet_num() > 0 ? 1 : 0); }
+
+    // the ordering key; computed once when the event is generated
+    event_key order_key;
+    void make_order_key() {
+        order_key.key = ((unsigned long long)trigger_time << 32) | event_priority(); // hash the event only once
+        order_key.seq = next_seq();
+    }
+
+protected:
+    unsigned int trigger_time;
+
+    event() {} // it should not be used
+    event(unsigned int _trigger_time) : trigger_time(_trigger_time) {}
+
+public:
+    virtual void trigger() = 0;
+    virtual ~event() {}
+
+    // the hash which orders the events of the same time; see get_hash_value()
+    virtual unsigned int event_priority() const = 0;
+    // the hash of the decimal strings of the values one after another, i.e., hash<string> of to_string(values[0]) +
+    // to_string(values[1]) + ...; the digits are written into a buffer, so no string is built
+    static unsigned int get_hash_value(initializer_list<unsigned int> values) {
+        char digits[10 * 5]; // 10 digits at most for each of the 5 values at most
+        char* end = digits;
+        for (unsigned int v : values)
+            end = to_chars(end, digits + sizeof(digits), v).ptr;
+        return hash<string_view>()(string_view(digits, end - digits));
+    }
+    virtual event_type_id type_id() const = 0;
+    // the node whose state is read and changed by trigger(); the parallel engine runs the event in the partition of the node
+    virtual unsigned int owner() const = 0;
+    // the number of new packets (i.e., new packet ids) generated by trigger()
+    virtual unsigned int packet_num() const { return 0; }
+    // the type of the packet handled by trigger() (PACKET_TYPE_NUM if none); for the profile of the events
+    virtual packet_type_id packet_type() const { return PACKET_TYPE_NUM; }
+    // a copy to trigger instead of the event if trigger() consumes the event (e.g., its packet);
+    // the optimistic engine keeps the event itself to run it again after a rollback
+    virtual event* clone() const { return nullptr; }
+
+    static void flush_events(); // only for debug
+    static void clear_events() { // delete all pending events
+        event* e;
+        while ((e = get_next_event()) != nullptr)
+            delete e;
+    }
+
+    GET(getTriggerTime, unsigned int, trigger_time);
+    const event_key& getOrderKey() const { return order_key; }
+
+    static void start_simulate(unsigned int _end_time); // the function is used to start the simulation
+
+    // add the events built by event_generator::create() at once, e.g., a bulk initial workload
+    static void add_events(const vector<event*>& es) { events->push(es); }
+    // the engines pull the events of source while the simulation runs (nullptr: no traffic source); the source is not owned
+    static void set_traffic(traffic_source* source) { traffic = source; }
+
+    // select the scheduler backend (e.g., "heap_scheduler" or "calendar_scheduler"); pending events are moved to the new one
+    static bool set_scheduler(string type);
+    // run the simulation with thread_num threads (1 by default: the sequential engine)
+    static void set_thread_num(unsigned int _thread_num) { thread_num = _thread_num > 0 ? _thread_num : 1; }
+    // select the parallel engine, "conservative" (default) or "optimistic"
+    static bool set_engine(string type) {
+        if (type != "conservative" && type != "optimistic") {
+            cerr << "no such engine type" << endl;
+            return false;
+        }
+        optimistic = (type == "optimistic");
+        return true;
+    }
+    // measure the events/sec of a scheduler backend with a synthetic hold workload
+    static void benchmark_scheduler(string type, unsigned int event_num);
+
+    static unsigned long long getRunNum() { return run_num; }
+    static string scheduler_type() { return events->type(); }
+    static string engine_type() { return thread_num == 1 ? "sequential" : (optimistic ? "optimistic" : "conservative"); }
+    static unsigned int getThreadNum() { return thread_num; }
+
+    static unsigned int getCurTime() { return cur_time; }
+    static void getCurTime(unsigned int _cur_time) { cur_time = _cur_time; }
+    // static unsigned int getEndTime() { return end_time ; }
+    // static void getEndTime(unsigned int _end_time) { end_time = _end_time; }
+
+    virtual void print() const = 0; // the function is used to print the event information
+
+    class event_generator {
+        // lock the copy constructor
+        event_generator(event_generator&) {}
+        // store all possible types of event
+        static map<string, event_generator*> prototypes;
+        static event_generator* id_prototypes[EVENT_TYPE_NUM]; // indexed by type id
+
+    protected:
+        // allow derived class to use it
+        event_generator() {}
+        // after you create a new event type, please register the factory of this event type by this function
+        void register_event_type(event_generator* h) {
+            prototypes[h->type()] = h;
+            id_prototypes[h->type_id()] = h;
+        }
+        // you have to implement your own generate() to generate your event
+        virtual event* generate(unsigned int _trigger_time, void* data) = 0;
+
+    public:
+        // you have to implement your own type() to return your event type
+        virtual string type() = 0;
+        virtual event_type_id type_id() = 0;
+        // this function is used to generate any type of event derived
+        static event* generate(string type, unsigned int _trigger_time, void* data) {
+            if (prototypes.find(type) != prototypes.end()) { // if this type derived exists
+                event* e = prototypes[type]->generate(_trigger_time, data);
+                e->make_order_key();
+                add_event(e);
+                return e; // generate it!!
+            }
+            std::cerr << "no such event type" << std::endl; // otherwise
+            return nullptr;
+        }
+        // the same as generate(string), but the type is found by its type id without a string lookup
+        static event* generate(event_type_id type, unsigned int _trigger_time, void* data) {
+            event* e = create(type, _trigger_time, data);
+            if (e != nullptr)
+                add_event(e);
+            return e;
+        }
+        // the typed factory: T is constructed directly, without looking up its generator; T has to befriend event_generator.
+        // the data is forwarded to T's typed constructor, e.g. generate<recv_event>(t, move(e_data)), so its fields are moved
+        // into the event rather than copied out of a void*. the string-keyed generate() is kept for the types chosen at run time
+        template <typename T, typename Data>
+        static T* generate(unsigned int _trigger_time, Data&& data) {
+            T* e = create<T>(_trigger_time, forward<Data>(data));
+            add_event(e);
+            return e;
+        }
+        template <typename T, typename Data>
+        static T* create(unsigned int _trigger_time, Data&& data) {
+            T* e = new T(_trigger_time, forward<Data>(data));
+            e->make_order_key();
+            return e;
+        }
+        // the same as generate(event_type_id), but the event is not added to the scheduler; see event::add_events()
+        static event* create(event_type_id type, unsigned int _trigger_time, void* data) {
+            if (id_prototypes[type] != nullptr) { // if this type derived exists
+                event* e = id_prototypes[type]->generate(_trigger_time, data);
+                e->make_order_key();
+                return e; // generate it!!
+            }
+            std::cerr << "no such event type" << std::endl; // otherwise
+            return nullptr;
+        }
+        // the type name of the event type id; used by the profile of the events
+        static const char* type_name(event_type_id type) {
+            static string names[EVENT_TYPE_NUM];
+            if (type >= EVENT_TYPE_NUM || id_prototypes[type] == nullptr)
+                return "unknown_event";
+            if (names[type].empty())
+                names[type] = id_prototypes[type]->type();
+            return names[type].c_str();
+        }
+        static void print() {
+            cout << "registered event types: " << endl;
+            for (map<string, event::event_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
+                cout << it->second->type() << endl;
+        }
+        virtual ~event_generator() {}
+    };
+};
+map<string, event::event_generator*> event::event_generator::prototypes;
+event::event_generator* event::event_generator::id_prototypes[EVENT_TYPE_NUM];
+thread_local const event* event::running = nullptr;
+unsigned long long event::outside_num = 0;
+vector<unsigned int> event::generated_num;
+
+thread_local unsigned int event::cur_time = 0;
+unsigned int event::end_time = 0;
+unsigned int event::thread_num = 1;
+bool event::optimistic = false;
+traffic_source* event::traffic = nullptr;
+unsigned long long event::run_num = 0;
+
+#ifdef EVENT_PROFILE
+// the profile of the sequential engine, by (event type, packet type): the count of the events and the time of their steps
+// (pop, print, trigger and delete); the percentiles of trigger() are estimated by a histogram with 4 buckets per power of 2
+// of nanoseconds. it is compiled only with -DEVENT_PROFILE; start_simulate() prints the table to cerr at the end
+class event_profile {
+public:
+    enum step { POP, PRINT, TRIGGER, DELETE, STEP_NUM };
+    typedef chrono::steady_clock clock;
+
+private:
+    static const unsigned int BUCKET_NUM = 64 * 4;
+    struct row {
+        unsigned long long count;
+        unsigned long long ns[STEP_NUM];
+        unsigned long long trigger_hist[BUCKET_NUM];
+    };
+    static row rows[EVENT_TYPE_NUM][PACKET_TYPE_NUM + 1]; // PACKET_TYPE_NUM: no packet
+
+    static unsigned int bucket_of(unsigned long long ns) {
+        if (ns < 4)
+            return ns;
+        unsigned int b = 63 - __builtin_clzll(ns);
+        return b * 4 + ((ns >> (b - 2)) & 3);
+    }
+    static unsigned long long bucket_top(unsigned int bucket) {
+        if (bucket < 4)
+            return bucket;
+        return (4ULL + bucket % 4 + 1) << (bucket / 4 - 2);
+    }
+    static unsigned long long percentile(const row& r, double p) {
+        unsigned long long rank = (unsigned long long)(p * r.count), seen = 0;
+        for (unsigned int i = 0; i < BUCKET_NUM; i++) {
+            seen += r.trigger_hist[i];
+            if (seen > rank)
+                return bucket_top(i);
+        }
+        return bucket_top(BUCKET_NUM - 1);
+    }
+    static void print_times(const row& r) {
+        cerr << fixed << setprecision(2);
+        for (unsigned int s = 0; s < STEP_NUM; s++)
+            cerr << setw(11) << r.ns[s] / 1e6;
+        cerr.unsetf(ios::fixed);
+    }
+
+public:
+    // measures the steps of the events of the loop; the time from the last step to begin() is the pop of the event
+    class probe {
+        row* cur;
+        clock::time_point last;
+
+    public:
+        probe() : cur(nullptr), last(clock::now()) {}
+        void begin(const event* e) {
+            cur = &rows[e->type_id()][e->packet_type()];
+            cur->count++;
+            lap(POP);
+        }
+        void lap(step s) {
+            clock::time_point now = clock::now();
+            unsigned long long ns = chrono::duration_cast<chrono::nanoseconds>(now - last).count();
+            last = now;
+            cur->ns[s] += ns;
+            if (s == TRIGGER)
+                cur->trigger_hist[bucket_of(ns)]++;
+        }
+    };
+
+    static void print() {
+        cerr << "event profile (times in ms; percentiles of trigger() in ns):" << endl;
+        cerr << setw(28) << "event type" << setw(22) << "packet type" << setw(12) << "count" << setw(11) << "pop" << setw(11) << "print"
+             << setw(11) << "trigger" << setw(11) << "delete" << setw(9) << "p50" << setw(9) << "p90" << setw(9) << "p99" << endl;
+        row total = {};
+        for (unsigned int t = 0; t < EVENT_TYPE_NUM; t++) {
+            for (unsigned int p = 0; p <= PACKET_TYPE_NUM; p++) {
+                const row& r = rows[t][p];
+                if (r.count == 0)
+                    continue;
+                cerr << setw(28) << event::event_generator::type_name((event_type_id)t)
+                     << setw(22) << (p == PACKET_TYPE_NUM ? "-" : packet::packet_generator::type_name((packet_type_id)p)) << setw(12) << r.count;
+                print_times(r);
+                cerr << setw(9) << percentile(r, 0.5) << setw(9) << percentile(r, 0.9) << setw(9) << percentile(r, 0.99) << endl;
+                total.count += r.count;
+                for (unsigned int s = 0; s < STEP_NUM; s++)
+                    total.ns[s] += r.ns[s];
+            }
+        }
+        cerr << setw(28) << "total" << setw(22) << "" << setw(12) << total.count;
+        print_times(total);
+        cerr << endl;
+    }
+};
+event_profile::row event_profile::rows[EVENT_TYPE_NUM][PACKET_TYPE_NUM + 1];
+#define PROFILE(statement) statement
+#else
+#define PROFILE(statement)
+#endif
+
+void event::flush_events() {
+    cout << "**flush begin" << endl;
+    event* e;
+    while ((e = get_next_event()) != nullptr) {
+        cout << setw(11) << e->trigger_time << ": " << setw(11) << (unsigned int)e->order_key.key << " " << setw(20) << e->order_key.seq << endl;
+        delete e;
+    }
+    cout << "**flush end" << endl;
+}
+// the events generated out of trigger() are numbered in the order they are generated, which is the same in every engine
+// (main() and the traffic sources generate them in the order of the input); an event generated by trigger() is numbered
+// by the owner of the running event, whose events run in the same order in every engine. the ones of the events
+// generating packets are counted apart, since the conservative engine runs those events in a partition of their own
+unsigned long long event::next_seq() {
+    if (running == nullptr)
+        return outside_num++;
+    unsigned long long slot = generated_slot(running);
+    if (slot >= generated_num.size()) // the events of a node that does not exist generate no event
+        return (slot + 1) << 32;
+    return ((slot + 1) << 32) | generated_num[slot]++;
+}
+event* event::get_next_event() {
+    // cout << events->size() << " events remains" << endl;
+    return events->pop(); // nullptr if there is no event
+}
+event* event::pull_next_event() {
+    event* e = events->pop();
+    unsigned long long t = (traffic != nullptr) ? traffic->next_time() : ULLONG_MAX;
+    if (t == ULLONG_MAX || (e != nullptr && e->trigger_time < t))
+        return e;
+    // a traffic event at the same time may come first (its key is smaller), so e goes back before the window is pulled
+    if (e != nullptr)
+        events->push(e);
+    vector<event*> es;
+    traffic->pull(t + TRAFFIC_WINDOW, es);
+    events->push(es);
+    return events->pop();
+}
+void event::start_simulate(unsigned int _end_time) {
+    if (_end_time < 0) {
+        cerr << "you should give a possitive value of _end_time" << endl;
+        return;
+    }
+    end_time = _end_time;
+    generated_num.assign(2 * (size_t)node::getNodeNum(), 0);
+    if (thread_num > 1) {
+        if (optimistic)
+            start_simulate_optimistic();
+        else
+            start_simulate_parallel();
+        return;
+    }
+    event* e;
+    PROFILE(event_profile::probe probe);
+    e = event::pull_next_event();
+    while (e != nullptr && e->trigger_time <= end_time) {
+        PROFILE(probe.begin(e));
+        if (cur_time <= e->trigger_time)
+            cur_time = e->trigger_time;
+        else {
+            cerr << "cur_time = " << cur_time << ", event trigger_time = " << e->trigger_time << endl;
+            break;
+        }
+
+        // cout << "event trigger_time = " << e->trigger_time << endl;
+        if (trace::enabled())
+            e->print(); // for log
+        PROFILE(probe.lap(event_profile::PRINT));
+        // cout << " event begin" << endl;
+        running = e;
+        e->trigger();
+        running = nullptr;
+        PROFILE(probe.lap(event_profile::TRIGGER));
+        run_num++;
+        // cout << " event end" << endl;
+        delete e;
+        PROFILE(probe.lap(event_profile::DELETE));
+        e = event::pull_next_event();
+    }
+    // cout << "no more event" << endl;
+    trace::flush();
+    PROFILE(event_profile::print());
+}
+
+bool mycomp::operator()(const event* lhs, const event* rhs) const {
+    // the key orders by trigger time first; see event_key
+    if (reverse)
+        return lhs->getOrderKey() < rhs->getOrderKey();
+    else
+        return rhs->getOrderKey() < lhs->getOrderKey();
+}
+
+// the heap is built on copies of the keys next to the events, so that the comparisons do not read the events scattered
+// in memory; then each event is put in the place of its key
+void heap_scheduler::push(const vector<event*>& es) {
+    if (es.size() < events.size()) {
+        for (size_t i = 0; i < es.size(); i++)
+            push(es[i]);
+        return;
+    }
+    vector<pair<event_key, event*>> keyed;
+    keyed.reserve(events.size() + es.size());
+    for (size_t i = 0; i < events.size(); i++)
+        keyed.push_back(make_pair(events[i]->getOrderKey(), events[i]));
+    for (size_t i = 0; i < es.size(); i++)
+        keyed.push_back(make_pair(es[i]->getOrderKey(), es[i]));
+    // the order of mycomp: the earliest key on top
+    make_heap(keyed.begin(), keyed.end(), [](const pair<event_key, event*>& a, const pair<event_key, event*>& b) { return b.first < a.first; });
+    events.resize(keyed.size());
+    for (size_t i = 0; i < keyed.size(); i++)
+        events[i] = keyed[i].second;
+}
+
+void calendar_scheduler::push(event* e) {
+    unsigned int t = e->getTriggerTime();
+    if (event_num == 0 || t + (unsigned long long)width < bucket_top) // the event is earlier than the current time slot
+        jump_to(t);
+    vector<event*>& b = buckets[bucket_of(t)];
+    b.push_back(e);
+    push_heap(b.begin(), b.end(), comp);
+    event_num++;
+    if (event_num > 2 * buckets.size() && buckets.size() < MAX_BUCKET_NUM)
+        resize(buckets.size() * 2);
+}
+// the same as pushing them one by one, but the calendar is resized only once and each bucket is heapified once; as in
+// heap_scheduler, the pop order does not depend on how a bucket is built since the keys are unique
+void calendar_scheduler::push(const vector<event*>& es) {
+    if (es.empty())
+        return;
+    unsigned int first = es[0]->getTriggerTime();
+    for (size_t i = 1; i < es.size(); i++)
+        first = min(first, es[i]->getTriggerTime());
+    if (event_num == 0 || first + (unsigned long long)width < bucket_top) // the earliest event is earlier than the current time slot
+        jump_to(first);
+    size_t bucket_num = buckets.size();
+    while (event_num + es.size() > 2 * bucket_num && bucket_num < MAX_BUCKET_NUM)
+        bucket_num *= 2;
+    if (bucket_num != buckets.size())
+        resize(bucket_num);
+    vector<bool> touched(buckets.size(), false);
+    for (size_t i = 0; i < es.size(); i++) {
+        size_t b = bucket_of(es[i]->getTriggerTime());
+        buckets[b].push_back(es[i]);
+        touched[b] = true;
+    }
+    for (size_t b = 0; b < buckets.size(); b++) {
+        if (touched[b])
+            make_heap(buckets[b].begin(), buckets[b].end(), comp);
+    }
+    event_num += es.size();
+}
+event* calendar_scheduler::pop() {
+    if (event_num == 0)
+        return nullptr;
+    // scan one year at most; the first event that belongs to the current time slot is the earliest one
+    for (size_t i = 0; i < buckets.size(); i++) {
+        vector<event*>& b = buckets[cur_bucket];
+        if (!b.empty() && b.front()->getTriggerTime() < bucket_top)
+            break;
+        cur_bucket = (cur_bucket + 1) & (buckets.size() - 1);
+        bucket_top += width;
+    }
+    vector<event*>& b = buckets[cur_bucket];
+    if (b.empty() || b.front()->getTriggerTime() >= bucket_top) {
+        // the next event is more than one year later; search it directly
+        event* first = nullptr;
+        for (size_t i = 0; i < buckets.size(); i++) {
+            if (!buckets[i].empty() && (first == nullptr || comp(first, buckets[i].front())))
+                first = buckets[i].front();
+        }
+        jump_to(first->getTriggerTime());
+    }
+    vector<event*>& cur = buckets[cur_bucket];
+    pop_heap(cur.begin(), cur.end(), comp);
+    event* e = cur.back();
+    cur.pop_back();
+    event_num--;
+    if (event_num < buckets.size() / 2 && buckets.size() > MIN_BUCKET_NUM)
+        resize(buckets.size() / 2);
+    return e;
+}
+void calendar_scheduler::resize(size_t bucket_num) {
+    vector<vector<event*>> old_buckets(bucket_num);
+    old_buckets.swap(buckets);
+    unsigned long long slot_begin = bucket_top - width; // keep the current time slot
+    for (size_t i = 0; i < old_buckets.size(); i++) {
+        for (size_t j = 0; j < old_buckets[i].size(); j++) {
+            event* e = old_buckets[i][j];
+            vector<event*>& b = buckets[bucket_of(e->getTriggerTime())];
+            b.push_back(e);
+            push_heap(b.begin(), b.end(), comp);
+        }
+    }
+    jump_to(slot_begin);
+}
+
+// the default scheduler is the binary heap; it is defined after the scheduler types are registered
+scheduler* event::events = scheduler::scheduler_generator::generate("heap_scheduler");
+
+// the parallel engine (conservative): the node ids are cut into thread_num blocks, and each block (partition) has
+// its own scheduler and thread
+// an event only changes its owner node, and it reaches another node only through a link, which takes at least
+// lookahead = link::min_latency() time units; hence the events in [T, T + lookahead), where T is the time of the earliest
+// pending event, do not affect the other partitions, so the partitions run this window at the same time and meet at its end
+// the result is the same as the one of the sequential engine:
+// - each partition runs its events in the order of mycomp, as the sequential engine does; the events of a node run in
+//   the same order as in the sequential engine, so the events they generate get the same sequence numbers, and the
+//   order keys are the same (see event_key)
+// - the trace records of the window are merged in the order of the order keys, in which the sequential engine prints them
+// - the events generating packets (packet_num() > 0) wait in a common queue; when their window begins, their packet ids
+//   are reserved in the order of mycomp, and each partition hands the ids out in the order it runs the events,
+//   so the packets get the same ids
+class event::partition {
+    static vector<partition*> parts;
+    static partition* gen_queue; // the events generating packets
+    static unsigned int block;   // the number of node ids of a partition
+
+    // the synchronization of the windows
+    static mutex lock;
+    static condition_variable start_cv; // a window begins or the engine stops
+    static condition_variable done_cv;  // all partitions finish the window
+    static unsigned long long window_num;
+    static unsigned int running; // the partitions that have not finished the window
+    static bool stopping;
+
+    scheduler* events;
+    event* next;                                      // the earliest pending event; it is already popped from events
+    vector<event*> outbox;                            // the events of the other partitions; delivered at the end of the window
+    vector<trace::record> records;                    // the trace of the window
+    vector<pair<event_key, size_t>> printed;          // (order key, end of its records) of each printed event of the window
+    vector<unsigned int> packet_ids;                  // the first packet id of each event generating packets in the window
+    size_t packet_id_at;                              // the first packet id that is not used yet
+    unsigned long long window_end;
+    unsigned int last_time;     // the time of the last event run by the partition
+    unsigned long long run_num; // the events run by the partition
+    string error;               // why the partition stopped; empty if it did not
+
+    partition(string type) : events(scheduler::scheduler_generator::generate(type)), next(nullptr), packet_id_at(0), window_end(0), last_time(0), run_num(0) {}
+    ~partition() { delete events; }
+
+    static partition* of_node(unsigned int id) { return id / block < parts.size() ? parts[id / block] : parts[0]; }
+    static partition* of(event* e) { return e->packet_num() > 0 ? gen_queue : of_node(e->owner()); }
+
+    event* peek() {
+        if (next == nullptr)
+            next = events->pop();
+        return next;
+    }
+    event* pop() {
+        event* e = peek();
+        next = nullptr;
+        return e;
+    }
+    void push(event* e) {
+        if (next != nullptr) { // next may not be the earliest one anymore
+            events->push(next);
+            next = nullptr;
+        }
+        events->push(e);
+    }
+    void run(); // run the events before window_end
+    static void work(unsigned int i); // the loop of the thread of parts[i]
+    static void run_window(unsigned long long end);
+    static void merge_trace();
+
+public:
+    static thread_local partition* current; // the partition run by this thread; nullptr out of the parallel engine
+
+    // an event generated by the event running in this partition
+    void add(event* e) {
+        partition* p = of(e);
+        if (p == this) {
+            push(e);
+            return;
+        }
+        if (e->trigger_time < window_end && error.empty())
+            error = "the event of node " + to_string(e->owner()) + " at " + to_string(e->trigger_time) + " is earlier than the end of the window " + to_string(window_end);
+        outbox.push_back(e);
+    }
+
+    friend class event;
+};
+vector<event::partition*> event::partition::parts;
+event::partition* event::partition::gen_queue = nullptr;
+unsigned int event::partition::block = 1;
+mutex event::partition::lock;
+condition_variable event::partition::start_cv;
+condition_variable event::partition::done_cv;
+unsigned long long event::partition::window_num = 0;
+unsigned int event::partition::running = 0;
+bool event::partition::stopping = false;
+thread_local event::partition* event::partition::current = nullptr;
+
+void event::partition::run() {
+    current = this;
+    trace::capture_to(&records);
+    event* e;
+    while (error.empty() && (e = peek()) != nullptr && e->trigger_time < window_end) {
+        if (cur_time > e->trigger_time) {
+            error = "cur_time = " + to_string(cur_time) + ", event trigger_time = " + to_string(e->trigger_time);
+            break;
+        }
+        pop();
+        cur_time = last_time = e->trigger_time;
+        if (trace::enabled()) {
+            e->print();
+            printed.push_back(pair<event_key, size_t>(e->order_key, records.size()));
+        }
+        unsigned int first_id = (e->packet_num() > 0) ? packet_ids[packet_id_at++] : 0;
+        unsigned int id = first_id;
+        packet::use_id_block(&id);
+        event::running = e; // the events it generates are numbered by its owner as in the sequential engine; see next_seq()
+        e->trigger();
+        event::running = nullptr;
+        packet::use_id_block(nullptr);
+        run_num++;
+        if (id - first_id != e->packet_num())
+            error = "the event at " + to_string(e->trigger_time) + " generated " + to_string(id - first_id) + " packets instead of " + to_string(e->packet_num());
+        delete e;
+    }
+    packet_ids.clear();
+    packet_id_at = 0;
+    trace::capture_to(nullptr);
+    current = nullptr;
+}
+void event::partition::work(unsigned int i) {
+    unsigned long long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            start_cv.wait(guard, [&seen] { return stopping || window_num != seen; });
+            if (stopping)
+                return;
+            seen = window_num;
+        }
+        parts[i]->run();
+        lock_guard<mutex> guard(lock);
+        if (--running == 0)
+            done_cv.notify_one();
+    }
+}
+void event::partition::run_window(unsigned long long end) {
+    {
+        lock_guard<mutex> guard(lock);
+        for (unsigned int i = 0; i < parts.size(); i++)
+            parts[i]->window_end = end;
+        running = parts.size() - 1;
+        window_num++;
+    }
+    start_cv.notify_all();
+    parts[0]->run(); // this thread runs the first partition
+    unique_lock<mutex> guard(lock);
+    done_cv.wait(guard, [] { return running == 0; });
+}
+void event::partition::merge_trace() {
+    // the sequential engine always runs the earliest pending event; within a window the pending events of a partition
+    // depend only on the partition, so it runs the first not merged event of the partitions whose order key is the smallest
+    vector<size_t> at(parts.size(), 0); // the first not merged event of each partition
+    while (true) {
+        unsigned int first = parts.size();
+        for (unsigned int i = 0; i < parts.size(); i++) {
+            if (at[i] < parts[i]->printed.size() && (first == parts.size() || parts[i]->printed[at[i]].first < parts[first]->printed[at[first]].first))
+                first = i;
+        }
+        if (first == parts.size())
+            break;
+        partition* p = parts[first];
+        for (size_t r = (at[first] == 0 ? 0 : p->printed[at[first] - 1].second); r < p->printed[at[first]].second; r++)
+            trace::write(p->records[r]);
+        at[first]++;
+    }
+    for (unsigned int i = 0; i < parts.size(); i++) {
+        parts[i]->records.clear();
+        parts[i]->printed.clear();
+    }
+}
+
+// the optimistic engine (Time Warp, Jefferson 1985): the node ids are cut into thread_num blocks as in the conservative
+// engine, and each block (logical process) runs its events without waiting for the others
+// an event from another logical process may arrive later than the events run after its order key (a straggler);
+// then the logical process rolls back: the events run after it are undone and wait to run again, the changes of the
+// forwarding tables made by them are undone by their logs, and the events generated by them are cancelled
+// (anti-messages for the events sent to the other logical processes, which may roll back in turn)
+// the logical processes meet after every round of ROUND_EVENT_NUM events; the global virtual time (GVT) is the earliest
+// pending event after the anti-messages of the round are handled, and the events before the GVT can never be rolled back,
+// so they are committed: their trace records are merged in the order of the sequential engine and they are deleted
+// (fossil collection)
+// the packet ids and the trace are the same as the ones of the sequential engine for the same reasons as in the
+// conservative engine; the state of a node is assumed to be its forwarding_table, the only state logged for a rollback
+class event::logical_process {
+    static const unsigned int ROUND_EVENT_NUM = 1024; // the events a logical process runs in a round at most
+
+    static vector<logical_process*> lps;
+    static unsigned int block; // the number of node ids of a logical process
+
+    // the synchronization of the rounds
+    static mutex lock;
+    static condition_variable start_cv; // a round begins or the engine stops
+    static condition_variable done_cv;  // all logical processes finish the round
+    static unsigned long long round_num;
+    static unsigned int running; // the logical processes that have not finished the round
+    static bool stopping;
+    static unsigned long long window_end; // the events before it are handed to the logical processes; see start_simulate_optimistic()
+
+    // an event that is run but not committed yet
+    struct processed_event {
+        event* e;
+        unsigned int prev_time;                  // the time before e
+        size_t packet_id_at;                     // packet_id_at before e
+        unsigned int generated_num;              // the counter of the events generated by the owner of e before e
+        vector<forwarding_table::change> changes; // the changes of the tables made by e
+        vector<trace::record> records;            // the trace of e
+        vector<event*> sent;                      // the events generated by e
+    };
+    // an event sent to this logical process, or the anti-message that cancels it
+    struct message {
+        event* e;
+        bool anti;
+    };
+
+    scheduler* events;
+    event* next;                       // the earliest pending event; it is already popped from events
+    unordered_set<event*> cancelled;   // the pending events that are cancelled; they are deleted when they are popped
+    deque<processed_event> processed;  // in the order they ran; their times do not decrease
+    vector<unsigned int> packet_ids;   // the first packet id of each event generating packets, in the order of mycomp
+    size_t packet_id_at;               // the first packet id that is not used yet
+    vector<message> inbox;
+    mutex inbox_lock;
+    atomic<bool> has_mail;
+    unsigned int time;                 // the time of the last event run
+    unsigned long long run_num;        // the events run, including the ones rolled back
+    unsigned long long rollback_num;   // the events rolled back
+    string error;                      // why the logical process stopped; empty if it did not
+
+    logical_process(string type) : events(scheduler::scheduler_generator::generate(type)), next(nullptr), packet_id_at(0),
+                                   has_mail(false), time(0), run_num(0), rollback_num(0) {}
+    ~logical_process() { delete events; }
+
+    static logical_process* of_node(unsigned int id) { return id / block < lps.size() ? lps[id / block] : lps[0]; }
+
+    event* peek() {
+        while (next == nullptr) {
+            next = events->pop();
+            if (next == nullptr)
+                break;
+            if (cancelled.erase(next) > 0) { // annihilated by its anti-message
+                delete next;
+                next = nullptr;
+            }
+        }
+        return next;
+    }
+    event* pop() {
+        event* e = peek();
+        next = nullptr;
+        return e;
+    }
+    void push(event* e) {
+        if (next != nullptr) { // next may not be the earliest one anymore
+            events->push(next);
+            next = nullptr;
+        }
+        events->push(e);
+    }
+    void post(event* e, bool anti) {
+        lock_guard<mutex> guard(inbox_lock);
+        inbox.push_back(message{e, anti});
+        has_mail = true;
+    }
+    void read_mail();
+    void receive(const message& m);
+    void roll_back(size_t from); // undo processed[from] and the events run after it
+    void run();                  // run a round
+    static void work(unsigned int i); // the loop of the thread of lps[i]
+    static void run_round();
+    static void commit(unsigned long long gvt);
+
+public:
+    static thread_local logical_process* current; // the logical process run by this thread; nullptr out of the optimistic engine
+
+    // an event generated by the event running in this logical process
+    void add(event* e) {
+        if (e->packet_num() > 0 && error.empty()) // its packet ids are not reserved
+            error = "the optimistic engine cannot run the event generating packets at " + to_string(e->trigger_time) + " which is generated during the simulation";
+        processed.back().sent.push_back(e);
+        logical_process* p = of_node(e->owner());
+        if (p == this)
+            push(e);
+        else
+            p->post(e, false);
+    }
+
+    friend class event;
+};
+vector<event::logical_process*> event::logical_process::lps;
+unsigned int event::logical_process::block = 1;
+mutex event::logical_process::lock;
+condition_variable event::logical_process::start_cv;
+condition_variable event::logical_process::done_cv;
+unsigned long long event::logical_process::round_num = 0;
+unsigned int event::logical_process::running = 0;
+bool event::logical_process::stopping = false;
+unsigned long long event::logical_process::window_end = 0;
+thread_local event::logical_process* event::logical_process::current = nullptr;
+
+void event::logical_process::read_mail() {
+    vector<message> mail;
+    {
+        lock_guard<mutex> guard(inbox_lock);
+        mail.swap(inbox);
+        has_mail = false;
+    }
+    for (size_t i = 0; i < mail.size(); i++)
+        receive(mail[i]);
+}
+void event::logical_process::receive(const message& m) {
+    if (!m.anti) {
+        // the events run after m.e in the sequential engine: the first processed event whose order key is larger and the
+        // events after it; the times of processed do not decrease, so only the events at the time of m.e are compared
+        size_t from = lower_bound(processed.begin(), processed.end(), m.e->trigger_time,
+                                  [](const processed_event& pe, unsigned int t) { return pe.e->trigger_time < t; }) - processed.begin();
+        while (from < processed.size() && !(m.e->order_key < processed[from].e->order_key))
+            from++;
+        roll_back(from);
+        push(m.e);
+        return;
+    }
+    for (size_t i = processed.size(); i > 0; i--) { // the event may have been run already
+        if (processed[i - 1].e == m.e) {
+            roll_back(i - 1);
+            break;
+        }
+    }
+    cancelled.insert(m.e);
+}
+void event::logical_process::roll_back(size_t from) {
+    while (processed.size() > from) {
+        processed_event& pe = processed.back();
+        for (size_t i = pe.changes.size(); i > 0; i--)
+            forwarding_table::undo(pe.changes[i - 1]);
+        for (size_t i = 0; i < pe.sent.size(); i++) {
+            logical_process* p = of_node(pe.sent[i]->owner());
+            if (p == this) // it is pending since the events run after pe are undone already
+                cancelled.insert(pe.sent[i]);
+            else
+                p->post(pe.sent[i], true);
+        }
+        packet_id_at = pe.packet_id_at;
+        time = pe.prev_time;
+        size_t slot = generated_slot(pe.e); // the events generated again get the same sequence numbers
+        if (slot < event::generated_num.size())
+            event::generated_num[slot] = pe.generated_num;
+        push(pe.e);
+        processed.pop_back();
+        rollback_num++;
+    }
+}
+void event::logical_process::run() {
+    current = this;
+    for (unsigned int n = 0; n < ROUND_EVENT_NUM && error.empty(); n++) {
+        if (has_mail)
+            read_mail();
+        event* e = peek();
+        if (e == nullptr || e->trigger_time >= window_end) // the events after the window may not be handed out yet
+            break;
+        pop();
+        size_t slot = generated_slot(e);
+        unsigned int generated = slot < event::generated_num.size() ? event::generated_num[slot] : 0;
+        processed.push_back(processed_event{e, time, packet_id_at, generated, {}, {}, {}});
+        processed_event& pe = processed.back();
+        cur_time = time = e->trigger_time;
+        if (trace::enabled()) {
+            trace::capture_to(&pe.records);
+            e->print();
+            trace::capture_to(nullptr);
+        }
+        unsigned int first_id = (e->packet_num() > 0) ? packet_ids[packet_id_at++] : 0;
+        unsigned int id = first_id;
+        event* c = e->clone(); // e is kept to run it again after a rollback
+        packet::use_id_block(&id);
+        forwarding_table::log_to(&pe.changes);
+        event::running = e; // not c: the events generated are numbered by the owner of e; see next_seq()
+        (c != nullptr ? c : e)->trigger();
+        event::running = nullptr;
+        forwarding_table::log_to(nullptr);
+        packet::use_id_block(nullptr);
+        delete c;
+        run_num++;
+        if (id - first_id != e->packet_num())
+            error = "the event at " + to_string(e->trigger_time) + " generated " + to_string(id - first_id) + " packets instead of " + to_string(e->packet_num());
+    }
+    current = nullptr;
+}
+void event::logical_process::work(unsigned int i) {
+    unsigned long long seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            start_cv.wait(guard, [&seen] { return stopping || round_num != seen; });
+            if (stopping)
+                return;
+            seen = round_num;
+        }
+        lps[i]->run();
+        lock_guard<mutex> guard(lock);
+        if (--running == 0)
+            done_cv.notify_one();
+    }
+}
+void event::logical_process::run_round() {
+    {
+        lock_guard<mutex> guard(lock);
+        running = lps.size() - 1;
+        round_num++;
+    }
+    start_cv.notify_all();
+    lps[0]->run(); // this thread runs the first logical process
+    unique_lock<mutex> guard(lock);
+    done_cv.wait(guard, [] { return running == 0; });
+}
+void event::logical_process::commit(unsigned long long gvt) {
+    // the events before gvt are merged in the order of the sequential engine as in partition::merge_trace()
+    vector<size_t> end(lps.size(), 0); // the events to commit of each logical process
+    for (unsigned int i = 0; i < lps.size(); i++) {
+        while (end[i] < lps[i]->processed.size() && lps[i]->processed[end[i]].e->trigger_time < gvt)
+            end[i]++;
+    }
+    vector<size_t> at(lps.size(), 0);
+    while (true) {
+        unsigned int first = lps.size();
+        for (unsigned int i = 0; i < lps.size(); i++) {
+            if (at[i] < end[i] && (first == lps.size() || lps[i]->processed[at[i]].e->order_key < lps[first]->processed[at[first]].e->order_key))
+                first = i;
+        }
+        if (first == lps.size())
+            break;
+        processed_event& pe = lps[first]->processed[at[first]++];
+        for (size_t r = 0; r < pe.records.size(); r++)
+            trace::write(pe.records[r]);
+    }
+    for (unsigned int i = 0; i < lps.size(); i++) {
+        event::run_num += end[i]; // the committed events
+        for (size_t j = 0; j < end[i]; j++)
+            delete lps[i]->processed[j].e;
+        lps[i]->processed.erase(lps[i]->processed.begin(), lps[i]->processed.begin() + end[i]);
+    }
+}
+
+void event::add_event(event* e) {
+    if (partition::current != nullptr) // generated by an event of the parallel engine
+        partition::current->add(e);
+    else if (logical_process::current != nullptr)
+        logical_process::current->add(e);
+    else
+        events->push(e);
+}
+bool event::set_scheduler(string type) {
+    scheduler* s = scheduler::scheduler_generator::generate(type);
+    if (s == nullptr)
+        return false;
+    event* e;
+    while ((e = events->pop()) != nullptr) // move the pending events to the new scheduler
+        s->push(e);
+    delete events;
+    events = s;
+    return true;
+}
+
+class recv_event : public event {
+public:
+    class recv_data; // forward declaration
+
+private:
+    recv_event(recv_event&) {} // this constructor cannot be used
+    recv_event() {}             // we don't allow users to new a recv_event by themselv
+    unsigned int senderID;      // the sender
+    unsigned int receiverID;    // the receiver; the packet will be given to the receiver
+    packet* pkt;                // the packet
+
+protected:
+    // this constructor cannot be directly called by users; only by generator
+    recv_event(unsigned int _trigger_time, void* data) : event(_trigger_time), senderID(BROCAST_ID), receiverID(BROCAST_ID), pkt(nullptr) {
+        recv_data* data_ptr = (recv_data*)data;
+        senderID = data_ptr->s_id;
+        receiverID = data_ptr->r_id; // the packet will be given to the receiver
+        pkt = data_ptr->_pkt;
+    }
+    // the typed constructor; see event_generator::generate<T>()
+    recv_event(unsigned int _trigger_time, recv_data&& data) : event(_trigger_time), senderID(data.s_id), receiverID(data.r_id), pkt(data._pkt) {}
+
+public:
+    virtual ~recv_event() { packet::discard(pkt); } // the packet is given to the receiver by trigger(); otherwise it is dropped here
+    POOLED_NEW_DELETE
+    // recv_event will trigger the recv function
+    virtual void trigger();
+
+    unsigned int event_priority() const;
+    event_type_id type_id() const { return RECV_EVENT; }
+    unsigned int owner() const { return receiverID; }
+    packet_type_id packet_type() const { return pkt != nullptr ? pkt->type_id() : PACKET_TYPE_NUM; }
+    event* clone() const {
+        recv_data data = {senderID, receiverID, packet::packet_generator::replicate(pkt)};
+        return new recv_event(trigger_time, move(data));
+    }
+
+    class recv_event_generator;
+    friend class recv_event_generator;
+    friend class event::event_generator; // for the typed factory
+    // recv_event is derived from event_generator to generate a event
+    class recv_event_generator : public event_generator {
+        static recv_event_generator sample;
+        // this constructor is only for sample to register this event type
+        recv_event_generator() { /*cout << "recv_event registered" << endl;*/
+            register_event_type(&sample);
+        }
+
+    protected:
+        virtual event* generate(unsigned int _trigger_time, void* data) {
+            // cout << "recv_event generated" << endl;
+            return new recv_event(_trigger_time, data);
+        }
+
+    public:
+        virtual string type() { return "recv_event"; }
+        virtual event_type_id type_id() { return RECV_EVENT; }
+        ~recv_event_generator() {}
+    };
+    // this class is used to initialize the recv_event
+    class recv_data {
+    public:
+        unsigned int s_id;
+        unsigned int r_id;
+        packet* _pkt;
+    };
+
+    void print() const;
+};
+recv_event::recv_event_generator recv_event::recv_event_generator::sample;
+object_pool recv_event::pool("recv_event", sizeof(recv_event));
+
+void recv_event::trigger() {
+    if (pkt == nullptr) {
+        cerr << "recv_event error: no pkt!" << endl;
+        return;
+    }
+    else if (node::id_to_node(receiverID) == nullptr) {
+        cerr << "recv_event error: no node " << receiverID << "!" << endl;
+        packet::discard(pkt);
+        return;
+    }
+    node::id_to_node(receiverID)->recv(pkt);
+    pkt = nullptr; // the receiver owns it now
+}
+unsigned int recv_event::event_priority() const {
+    return get_hash_value({getTriggerTime(), senderID, receiverID, pkt->getPacketID()});
+}
+// the recv_event::print() function is used for log file
+void recv_event::print() const {
+    trace::record r = {event::getCurTime(), trace::RECV, (unsigned char)pkt->type_id(), 0,
+        {receiverID, pkt->getPacketID(), pkt->getHeader()->getSrcID(), pkt->getHeader()->getDstID(), pkt->getHeader()->getPreID(), pkt->getHeader()->getNexID()}};
+    trace::write(r);
+    // cout << pkt->type()
+    //      << "   time "       << setw(11) << event::getCurTime()
+    //      << "   recID "      << setw(11) << receiverID
+    //      << "   pktID"       << setw(11) << pkt->getPacketID()
+    //      << "   srcID "      << setw(11) << pkt->getHeader()->getSrcID()
+    //      << "   dstID"       << setw(11) << pkt->getHeader()->getDstID()
+    //      << "   preID"       << setw(11) << pkt->getHeader()->getPreID()
+    //      << "   nexID"       << setw(11) << pkt->getHeader()->getNexID()
+    //      << endl;
+}
+
+class send_event : public event {
+public:
+    class send_data; // forward declaration
+
+private:
+    send_event(send_event&) {}
+    send_event() {} // we don't allow users to new a recv_event by themselves
+    // this constructor cannot be directly called by users; only by generator
+    unsigned int senderID;   // the sender
+    unsigned int receiverID; // the receiver
+    packet* pkt;             // the packet
+
+protected:
+    send_event(unsigned int _trigger_time, void* data) : event(_trigger_time), senderID(BROCAST_ID), receiverID(BROCAST_ID), pkt(nullptr) {
+        send_data* data_ptr = (send_data*)data;
+        senderID = data_ptr->s_id;
+        receiverID = data_ptr->r_id;
+        pkt = data_ptr->_pkt;
+    }
+    // the typed constructor; see event_generator::generate<T>()
+    send_event(unsigned int _trigger_time, send_data&& data) : event(_trigger_time), senderID(data.s_id), receiverID(data.r_id), pkt(data._pkt) {}
+
+public:
+    virtual ~send_event() { packet::discard(pkt); } // the packet is given to the sender by trigger(); otherwise it is dropped here
+    POOLED_NEW_DELETE
+    // send_event will trigger the send function
+    virtual void trigger();
+
+    unsigned int event_priority() const;
+    event_type_id type_id() const { return SEND_EVENT; }
+    unsigned int owner() const { return senderID; }
+    packet_type_id packet_type() const { return pkt != nullptr ? pkt->type_id() : PACKET_TYPE_NUM; }
+    event* clone() const {
+        send_data data = {senderID, receiverID, packet::packet_generator::replicate(pkt), trigger_time};
+        return new send_event(trigger_time, move(data));
+    }
+
+    class send_event_generator;
+    friend class send_event_generator;
+    friend class event::event_generator; // for the typed factory
+    // send_event is derived from event_generator to generate a event
+    class send_event_generator : public event_generator {
+        static send_event_generator sample;
+        // this constructor is only for sample to register this event type
+        send_event_generator() { /*cout << "send_event registered" << endl;*/
+            register_event_type(&sample);
+        }
+
+    protected:
+        virtual event* generate(unsigned int _trigger_time, void* data) {
+            // cout << "send_event generated" << endl;
+            return new send_event(_trigger_time, data);
+        }
+
+    public:
+        virtual string type() { return "send_event"; }
+        virtual event_type_id type_id() { return SEND_EVENT; }
+        ~send_event_generator() {}
+    };
+    // this class is used to initialize the send_event
+    class send_data {
+    public:
+        unsigned int s_id;
+        unsigned int r_id;
+        packet* _pkt;
+        unsigned int t;
+    };
+
+    void print() const;
+};
+send_event::send_event_generator send_event::send_event_generator::sample;
+object_pool send_event::pool("send_event", sizeof(send_event));
+
+void send_event::trigger() {
+    if (pkt == nullptr) {
+        cerr << "send_event error: no pkt!" << endl;
+        return;
+    }
+    else if (node::id_to_node(senderID) == nullptr) {
+        cerr << "send_event error: no node " << senderID << "!" << endl;
+        packet::discard(pkt);
+        return;
+    }
+    node::id_to_node(senderID)->send(pkt);
+    pkt = nullptr; // the sender owns it now
+}
+unsigned int send_event::event_priority() const {
+    return get_hash_value({getTriggerTime(), senderID, receiverID, pkt->getPacketID()});
+}
+// the send_event::print() function is used for log file
+void send_event::print() const {
+    trace::record r = {event::getCurTime(), trace::SEND, (unsigned char)pkt->type_id(), 0,
+        {senderID, pkt->getPacketID(), pkt->getHeader()->getSrcID(), pkt->getHeader()->getDstID(), pkt->getHeader()->getPreID(), pkt->getHeader()->getNexID()}};
+    trace::write(r);
+    // cout << pkt->type()
+    //      << "   time "       << setw(11) << event::getCurTime()
+    //      << "   senID "      << setw(11) << senderID
+    //      << "   pktID"       << setw(11) << pkt->getPacketID()
+    //      << "   srcID "      << setw(11) << pkt->getHeader()->getSrcID()
+    //      << "   dstID"       << setw(11) << pkt->getHeader()->getDstID()
+    //      << "   preID"       << setw(11) << pkt->getHeader()->getPreID()
+    //      << "   nexID"       << setw(11) << pkt->getHeader()->getNexID()
+    //      << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+class SDN_data_pkt_gen_event : public event {
+public:
+    class pkt_gen_data; // forward declaration
+
+private:
+    SDN_data_pkt_gen_event(SDN_data_pkt_gen_event&) {}
+    SDN_data_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
+    // this constructor cannot be directly called by users; only by generator
+    unsigned int src; // the src
+    unsigned int dst; // the dst
+    // packet *pkt; // the packet
+    message msg;
+
+protected:
+    SDN_data_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
+        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
+        src = data_ptr->src_id;
+        dst = data_ptr->dst_id;
+        // pkt = data_ptr->_pkt;
+        msg = data_ptr->msg;
+    }
+    // the typed constructor; see event_generator::generate<T>()
+    SDN_data_pkt_gen_event(unsigned int _trigger_time, pkt_gen_data&& data) : event(_trigger_time), src(data.src_id), dst(data.dst_id) {
+        msg = move(data.msg);
+    }
+
+public:
+    virtual ~SDN_data_pkt_gen_event() {}
+    POOLED_NEW_DELETE
+    // SDN_data_pkt_gen_event will trigger the packet gen function
+    virtual void trigger();
+
+    unsigned int event_priority() const;
+    event_type_id type_id() const { return SDN_DATA_PKT_GEN_EVENT; }
+    unsigned int owner() const { return src; } // the packet starts from src
+    unsigned int packet_num() const { return 1; }
+    packet_type_id packet_type() const { return SDN_DATA_PACKET; }
+
+    class SDN_data_pkt_gen_event_generator;
+    friend class SDN_data_pkt_gen_event_generator;
+    friend class event::event_generator; // for the typed factory
+    // SDN_data_pkt_gen_event_generator is derived from event_generator to generate an event
+    class SDN_data_pkt_gen_event_generator : public event_generator {
+        static SDN_data_pkt_gen_event_generator sample;
+        // this constructor is only for sample to register this event type
+        SDN_data_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
+            register_event_type(&sample);
+        }
+
+    protected:
+        virtual event* generate(unsigned int _trigger_time, void* data) {
+            // cout << "send_event generated" << endl;
+            return new SDN_data_pkt_gen_event(_trigger_time, data);
+        }
+
+    public:
+        virtual string type() { return "SDN_data_pkt_gen_event"; }
+        virtual event_type_id type_id() { return SDN_DATA_PKT_GEN_EVENT; }
+        ~SDN_data_pkt_gen_event_generator() {}
+    };
+    // this class is used to initialize the SDN_data_pkt_gen_event
+    class pkt_gen_data {
+    public:
+        unsigned int src_id;
+        unsigned int dst_id;
+        message msg;
+        // packet *_pkt;
+
+        pkt_gen_data() = default;
+        pkt_gen_data(pkt_gen_data&&) = default; // moved into the event, never copied
+        pkt_gen_data& operator=(pkt_gen_data&&) = default;
+    };
+
+    void print() const;
+};
+SDN_data_pkt_gen_event::SDN_data_pkt_gen_event_generator SDN_data_pkt_gen_event::SDN_data_pkt_gen_event_generator::sample;
+object_pool SDN_data_pkt_gen_event::pool("SDN_data_pkt_gen_event", sizeof(SDN_data_pkt_gen_event));
+
+void SDN_data_pkt_gen_event::trigger() {
+    if (node::id_to_node(src) == nullptr) {
+        cerr << "SDN_data_pkt_gen_event error: no node " << src << "!" << endl;
+        return;
+    }
+    else if (dst != BROCAST_ID && node::id_to_node(dst) == nullptr) {
+        cerr << "SDN_data_pkt_gen_event error: no node " << dst << "!" << endl;
+        return;
+    }
+
+    SDN_data_packet* pkt = packet::packet_generator::generate<SDN_data_packet>();
+    if (pkt == nullptr) {
+        cerr << "packet type is incorrect" << endl;
+        return;
+    }
+    SDN_data_header* hdr = dynamic_cast<SDN_data_header*>(pkt->getHeader());
+    SDN_data_payload* pld = dynamic_cast<SDN_data_payload*>(pkt->getMutablePayload());
+
+    if (hdr == nullptr) {
+        cerr << "header type is incorrect" << endl;
+        return;
+    }
+    if (pld == nullptr) {
+        cerr << "payload type is incorrect" << endl;
+        return;
+    }
+
+    hdr->setSrcID(src);
+    hdr->setDstID(dst);
+    hdr->setPreID(src); // this column is not important when the packet is first received by the src (i.e., just generated)
+    hdr->setNexID(src); // this column is not important when the packet is first received by the src (i.e., just generated)
+
+    pld->setMsg(msg);
+
+    recv_event::recv_data e_data;
+    e_data.s_id = src;
+    e_data.r_id = src; // to make the packet start from the src
+    e_data._pkt = pkt;
+
+    recv_event* e = event::event_generator::generate<recv_event>(trigger_time, move(e_data));
+}
+unsigned int SDN_data_pkt_gen_event::event_priority() const {
+    return get_hash_value({getTriggerTime(), src, dst});
+}
+// the SDN_data_pkt_gen_event::print() function is used for log file
+void SDN_data_pkt_gen_event::print() const {
+    trace::record r = {event::getCurTime(), trace::GEN, SDN_DATA_PACKET, 0, {src, dst}};
+    trace::write(r);
+}
+
+// the hold model: event_num events are kept pending, and every popped event is put back
+// ONE_HOP_DELAY to 3 * ONE_HOP_DELAY later, so the events cluster at a few time slots as in the simulation
+void event::benchmark_scheduler(string type, unsigned int event_num) {
+    if (!set_scheduler(type))
+        return;
+    mt19937 rng(0); // fixed seed; every scheduler gets the same workload
+    for (unsigned int i = 0; i < event_num; i++) {
+        SDN_data_pkt_gen_event::pkt_gen_data e_data; // moved into each event
+        e_data.src_id = rng() % 1024;
+        e_data.dst_id = rng() % 1024;
+        e_data.msg = message::DEFAULT;
+        event_generator::generate<SDN_data_pkt_gen_event>((rng() % 4) * ONE_HOP_DELAY, move(e_data));
+    }
+
+    unsigned long long hold_num = 8ULL * event_num;
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    for (unsigned long long i = 0; i < hold_num; i++) {
+        event* e = get_next_event();
+        e->trigger_time += (1 + rng() % 3) * ONE_HOP_DELAY; // reuse the event to measure only the scheduler
+        e->order_key.key = ((unsigned long long)e->trigger_time << 32) | (unsigned int)e->order_key.key; // the hash is kept
+        add_event(e);
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    event* e;
+    while ((e = get_next_event()) != nullptr)
+        delete e;
+    cout << setw(20) << type << ": " << hold_num << " events in " << fixed << setprecision(3) << sec << " s, "
+         << setprecision(0) << hold_num / sec << " events/sec" << endl;
+    cout.unsetf(ios::fixed);
+}
+
+class SDN_ctrl_pkt_gen_event : public event {
+public:
+    class pkt_gen_data; // forward declaration
+
+private:
+    SDN_ctrl_pkt_gen_event(SDN_ctrl_pkt_gen_event&) {}
+    SDN_ctrl_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
+    // this constructor cannot be directly called by users; only by generator
+    unsigned int src; // the src
+    unsigned int dst; // the dst
+    unsigned int mat;
+    unsigned int act;
+    // packet *pkt; // the packet
+    message msg;
+
+protected:
+    SDN_ctrl_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
+        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
+        src = data_ptr->src_id;
+        dst = data_ptr->dst_id;
+        // pkt = data_ptr->_pkt;
+        mat = data_ptr->mat_id;
+        act = data_ptr->act_id;
+        msg = data_ptr->msg;
+    }
+    // the typed constructor; see event_generator::generate<T>()
+    SDN_ctrl_pkt_gen_event(unsigned int _trigger_time, pkt_gen_data&& data) : event(_trigger_time), src(data.src_id), dst(data.dst_id) {
+        mat = data.mat_id;
+        act = data.act_id;
+        msg = move(data.msg);
+    }
+
+public:
+    virtual ~SDN_ctrl_pkt_gen_event() {}
+    POOLED_NEW_DELETE
+    // SDN_ctrl_pkt_gen_event will trigger the packet gen function
+    virtual void trigger();
+
+    unsigned int event_priority() const;
+    event_type_id type_id() const { return SDN_CTRL_PKT_GEN_EVENT; }
+    unsigned int owner() const { return src; } // the packet starts from src
+    unsigned int packet_num() const { return 1; }
+    packet_type_id packet_type() const { return SDN_CTRL_PACKET; }
+
+    class SDN_ctrl_pkt_gen_event_generator;
+    friend class SDN_ctrl_pkt_gen_event_generator;
+    friend class event::event_generator; // for the typed factory
+    // SDN_ctrl_pkt_gen_event_generator is derived from event_generator to generate an event
+    class SDN_ctrl_pkt_gen_event_generator : public event_generator {
+        static SDN_ctrl_pkt_gen_event_generator sample;
+        // this constructor is only for sample to register this event type
+        SDN_ctrl_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
+            register_event_type(&sample);
+        }
+
+    protected:
+        virtual event* generate(unsigned int _trigger_time, void* data) {
+            // cout << "send_event generated" << endl;
+            return new SDN_ctrl_pkt_gen_event(_trigger_time, data);
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_pkt_gen_event"; }
+        virtual event_type_id type_id() { return SDN_CTRL_PKT_GEN_EVENT; }
+        ~SDN_ctrl_pkt_gen_event_generator() {}
+    };
+    // this class is used to initialize the SDN_ctrl_pkt_gen_event
+    class pkt_gen_data {
+    public:
+        unsigned int src_id; // the controller
+        unsigned int dst_id; // the node that should update its rule
+        unsigned int mat_id; // the target of the rule
+        unsigned int act_id; // the next hop toward the target recorded in the rule
+        message msg;
+        // packet *_pkt;
+
+        pkt_gen_data() = default;
+        pkt_gen_data(pkt_gen_data&&) = default; // moved into the event, never copied
+        pkt_gen_data& operator=(pkt_gen_data&&) = default;
+    };
+
+    void print() const;
+};
+SDN_ctrl_pkt_gen_event::SDN_ctrl_pkt_gen_event_generator SDN_ctrl_pkt_gen_event::SDN_ctrl_pkt_gen_event_generator::sample;
+object_pool SDN_ctrl_pkt_gen_event::pool("SDN_ctrl_pkt_gen_event", sizeof(SDN_ctrl_pkt_gen_event));
+
+void SDN_ctrl_pkt_gen_event::trigger() {
+    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
+        cerr << "SDN_ctrl_pkt_gen_event error: no node " << dst << "!" << endl;
+        return;
+    }
+
+    SDN_ctrl_packet* pkt = packet::packet_generator::generate<SDN_ctrl_packet>();
+    if (pkt == nullptr) {
+        cerr << "packet type is incorrect" << endl;
+        return;
+    }
+    SDN_ctrl_header* hdr = dynamic_cast<SDN_ctrl_header*>(pkt->getHeader());
+    SDN_ctrl_payload* pld = dynamic_cast<SDN_ctrl_payload*>(pkt->getMutablePayload());
+
+    if (hdr == nullptr) {
+        cerr << "header type is incorrect" << endl;
+        return;
+    }
+    if (pld == nullptr) {
+        cerr << "payload type is incorrect" << endl;
+        return;
+    }
+
+    hdr->setSrcID(src);
+    hdr->setDstID(dst);
+    hdr->setPreID(src);
+    hdr->setNexID(src); // in hw3, you should set NexID to src
+    // payload
+    pld->setMsg(msg);
+    pld->setMatID(mat);
+    pld->setActID(act);
+
+    recv_event::recv_data e_data;
+    e_data.s_id = src;
+    e_data.r_id = src; // in hw3, you should set r_id it src
+    e_data._pkt = pkt;
+
+    recv_event* e = event::event_generator::generate<recv_event>(trigger_time, move(e_data));
+}
+unsigned int SDN_ctrl_pkt_gen_event::event_priority() const {
+    return get_hash_value({getTriggerTime(), src, dst, mat, act});
+}
+// the SDN_ctrl_pkt_gen_event::print() function is used for log file
+void SDN_ctrl_pkt_gen_event::print() const {
+    trace::record r = {event::getCurTime(), trace::GEN_RULE, SDN_CTRL_PACKET, 0, {src, dst, mat, act}};
+    trace::write(r);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+class link {
+    // all links created in the program: id_id_link_table[id1] lists (id2, link) sorted by id2
+    static vector<vector<pair<unsigned int, link*>>> id_id_link_table;
+    static unsigned int link_num;
+
+    unsigned int id1; // from
+    unsigned int id2; // to
+
+    // the position of (_id1, _id2) in id_id_link_table[_id1], or the position to insert it
+    static vector<pair<unsigned int, link*>>::iterator find_link(unsigned int _id1, unsigned int _id2) {
+        vector<pair<unsigned int, link*>>& links = id_id_link_table[_id1];
+        return lower_bound(links.begin(), links.end(), pair<unsigned int, link*>(_id2, nullptr),
+                           [](const pair<unsigned int, link*>& a, const pair<unsigned int, link*>& b) { return a.first < b.first; });
+    }
+
+protected:
+    link(link&) {} // this constructor should not be used
+    link() {}       // this constructor should not be used
+    link(unsigned int _id1, unsigned int _id2) : id1(_id1), id2(_id2) {
+        if (id_id_link_table.size() <= _id1)
+            id_id_link_table.resize(_id1 + 1);
+        id_id_link_table[_id1].insert(find_link(_id1, _id2), pair<unsigned int, link*>(_id2, this));
+        link_num++;
+    }
+
+public:
+    virtual ~link() {
+        del_link(id1, id2); // erase the link
+    }
+
+    static link* id_id_to_link(unsigned int _id1, unsigned int _id2) {
+        if (_id1 >= id_id_link_table.size())
+            return nullptr;
+        vector<pair<unsigned int, link*>>::iterator it = find_link(_id1, _id2);
+        return (it != id_id_link_table[_id1].end() && it->first == _id2) ? it->second : nullptr;
+    }
+
+    virtual double getLatency() = 0; // you must implement your own latency
+
+    static void del_link(unsigned int _id1, unsigned int _id2) {
+        if (id_id_to_link(_id1, _id2) != nullptr) {
+            id_id_link_table[_id1].erase(find_link(_id1, _id2));
+            link_num--;
+        }
+    }
+
+    static unsigned int getLinkNum() { return link_num; }
+    // the smallest latency of all links (0 if there is no link); no packet reaches another node sooner
+    static double min_latency() {
+        double latency = 0;
+        bool found = false;
+        for (unsigned int i = 0; i < id_id_link_table.size(); i++) {
+            for (unsigned int j = 0; j < id_id_link_table[i].size(); j++) {
+                double l = id_id_link_table[i][j].second->getLatency();
+                if (!found || l < latency)
+                    latency = l;
+                found = true;
+            }
+        }
+        return latency;
+    }
+
+    class link_generator {
+        // lock the copy constructor
+        link_generator(link_generator&) {}
+        // store all possible types of link
+        static map<string, link_generator*> prototypes;
+
+    protected:
+        // allow derived class to use it
+        link_generator() {}
+        // after you create a new link type, please register the factory of this link type by this function
+        void register_link_type(link_generator* h) { prototypes[h->type()] = h; }
+        // you have to implement your own generate() to generate your link
+        virtual link* generate(unsigned int _id1, unsigned int _id2) = 0;
+
+    public:
+        // you have to implement your own type() to return your link type
+        virtual string type() = 0;
+        // this function is used to generate any type of link derived
+        static link* generate(string type, unsigned int _id1, unsigned int _id2) {
+            if (id_id_to_link(_id1, _id2) != nullptr) {
+                std::cerr << "duplicate link id" << std::endl; // link id is duplicated
+                return nullptr;
+            }
+            else if (BROCAST_ID == _id1 || BROCAST_ID == _id2) {
+                cerr << "BROCAST_ID cannot be used" << endl;
+                return nullptr;
+            }
+            else if (prototypes.find(type) != prototypes.end()) { // if this type derived exists
+                link* created_link = prototypes[type]->generate(_id1, _id2);
+                return created_link; // generate it!!
+            }
+            std::cerr << "no such link type" << std::endl; // otherwise
+            return nullptr;
+        }
+        static void print() {
+            cout << "registered link types: " << endl;
+            for (map<string, link::link_generator*>::iterator it = prototypes.begin(); it != prototypes.end(); it++)
+                cout << it->second->type() << endl;
+        }
+        virtual ~link_generator() {};
+    };
+};
+map<string, link::link_generator*> link::link_generator::prototypes;
+vector<vector<pair<unsigned int, link*>>> link::id_id_link_table;
+unsigned int link::link_num = 0;
+
+void node::add_phy_neighbor(unsigned int _id, string link_type) {
+    if (id == _id)
+        return; // if the two nodes are the same...
+    if (id_to_node(_id) == nullptr)
+        return; // if this node does not exist
+    if (phy_neighbors.find(_id) != phy_neighbors.end())
+        return; // if this neighbor has been added
+    phy_neighbors[_id] = true;
+
+    link* l = link::link_generator::generate(link_type, id, _id);
+    if (l == nullptr) // the link may be kept after del_phy_neighbor()
+        l = link::id_id_to_link(id, _id);
+    // nb_links is sorted by the neighbor id; the neighbors are usually added in the increasing order (e.g., all switches
+    // of the controller), so the binary search and the insertion at the end keep the setup of a large topology linear
+    vector<pair<unsigned int, link*>>::iterator it = lower_bound(nb_links.begin(), nb_links.end(), _id,
+        [](const pair<unsigned int, link*>& nb, unsigned int nb_id) { return nb.first < nb_id; });
+    nb_links.insert(it, pair<unsigned int, link*>(_id, l));
+}
+void node::del_phy_neighbor(unsigned int _id) {
+    phy_neighbors.erase(_id);
+    for (vector<pair<unsigned int, link*>>::iterator it = nb_links.begin(); it != nb_links.end(); it++) {
+        if (it->first == _id) {
+            nb_links.erase(it);
+            break;
+        }
+    }
+}
+
+class simple_link : public link {
+protected:
+    simple_link() {}                                                        // it should not be used outside the class
+    simple_link(simple_link&) {}                                           // it should not be used
+    simple_link(unsigned int _id1, unsigned int _id2) : link(_id1, _id2) {} // this constructor cannot be directly called by users
+
+public:
+    virtual ~simple_link() {}
+    virtual double getLatency() { return ONE_HOP_DELAY; } // you can implement your own latency
+
+    class simple_link_generator;
+    friend class simple_link_generator;
+    // simple_link is derived from link_generator to generate a link
+    class simple_link_generator : public link_generator {
+        static simple_link_generator sample;
+        // this constructor is only for sample to register this link type
+        simple_link_generator() { /*cout << "simple_link registered" << endl;*/
+            register_link_type(&sample);
+        }
+
+    protected:
+        virtual link* generate(unsigned int _id1, unsigned int _id2) { /*cout << "simple_link generated" << endl;*/
+            return new simple_link(_id1, _id2);
+        }
+
+    public:
+        virtual string type() { return "simple_link"; }
+        ~simple_link_generator() {}
+    };
+};
+simple_link::simple_link_generator simple_link::simple_link_generator::sample;
+
+// it is defined after link since the lookahead comes from the links
+void event::start_simulate_parallel() {
+    double lookahead = link::min_latency();
+    if (lookahead < 1) { // the partitions cannot run ahead of each other; use the sequential engine
+        unsigned int n = thread_num;
+        thread_num = 1;
+        start_simulate(end_time);
+        thread_num = n;
+        return;
+    }
+
+    string type = events->type();
+    partition::block = (node::getNodeIDBound() + thread_num - 1) / thread_num;
+    if (partition::block == 0)
+        partition::block = 1;
+    for (unsigned int i = 0; i < thread_num; i++)
+        partition::parts.push_back(new partition(type));
+    partition::gen_queue = new partition(type);
+    event* e;
+    while ((e = events->pop()) != nullptr)
+        partition::of(e)->push(e);
+
+    object_pool::set_threaded(true);
+    partition::stopping = false;
+    vector<thread> workers;
+    for (unsigned int i = 1; i < thread_num; i++)
+        workers.push_back(thread(partition::work, i));
+
+    while (true) {
+        // the window begins at the earliest pending event
+        unsigned long long begin = (traffic != nullptr) ? traffic->next_time() : ULLONG_MAX;
+        for (unsigned int i = 0; i <= thread_num; i++) {
+            partition* p = (i < thread_num) ? partition::parts[i] : partition::gen_queue;
+            if (p->peek() != nullptr && p->peek()->trigger_time < begin)
+                begin = p->peek()->trigger_time;
+        }
+        if (begin > end_time)
+            break;
+        unsigned long long window_end = min(begin + (unsigned long long)lookahead, (unsigned long long)end_time + 1);
+
+        // the traffic of the window joins the pending events (the events generating packets go to gen_queue)
+        if (traffic != nullptr) {
+            vector<event*> es;
+            traffic->pull(window_end, es);
+            for (size_t i = 0; i < es.size(); i++)
+                partition::of(es[i])->push(es[i]);
+        }
+        // reserve the packet ids of the window in the order of mycomp, i.e., the order of the sequential engine
+        while ((e = partition::gen_queue->peek()) != nullptr && e->trigger_time < window_end) {
+            partition::gen_queue->pop();
+            partition* p = partition::of_node(e->owner());
+            p->packet_ids.push_back(packet::reserve_ids(e->packet_num()));
+            p->push(e);
+        }
+
+        partition::run_window(window_end);
+        if (trace::enabled())
+            partition::merge_trace();
+
+        string error;
+        for (unsigned int i = 0; i < thread_num; i++) {
+            partition* p = partition::parts[i];
+            for (unsigned int j = 0; j < p->outbox.size(); j++)
+                partition::of(p->outbox[j])->push(p->outbox[j]);
+            p->outbox.clear();
+            if (error.empty())
+                error = p->error;
+        }
+        if (!error.empty()) {
+            cerr << error << endl;
+            break;
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(partition::lock);
+        partition::stopping = true;
+    }
+    partition::start_cv.notify_all();
+    for (unsigned int i = 0; i < workers.size(); i++)
+        workers[i].join();
+    object_pool::set_threaded(false);
+
+    // the pending events go back to the scheduler of the sequential engine
+    for (unsigned int i = 0; i <= thread_num; i++) {
+        partition* p = (i < thread_num) ? partition::parts[i] : partition::gen_queue;
+        while ((e = p->pop()) != nullptr)
+            events->push(e);
+        if (p->last_time > cur_time)
+            cur_time = p->last_time;
+        event::run_num += p->run_num;
+        delete p;
+    }
+    partition::parts.clear();
+    partition::gen_queue = nullptr;
+    trace::flush();
+}
+
+void event::start_simulate_optimistic() {
+    if (link::min_latency() < 1) { // an event may reach another node at the same time; use the sequential engine
+        unsigned int n = thread_num;
+        thread_num = 1;
+        start_simulate(end_time);
+        thread_num = n;
+        return;
+    }
+
+    string type = events->type();
+    logical_process::block = (node::getNodeIDBound() + thread_num - 1) / thread_num;
+    if (logical_process::block == 0)
+        logical_process::block = 1;
+    for (unsigned int i = 0; i < thread_num; i++)
+        logical_process::lps.push_back(new logical_process(type));
+    logical_process::window_end = 0;
+
+    object_pool::set_threaded(true);
+    logical_process::stopping = false;
+    vector<thread> workers;
+    for (unsigned int i = 1; i < thread_num; i++)
+        workers.push_back(thread(logical_process::work, i));
+
+    event* e;
+    unsigned long long gvt = 0;
+    while (true) {
+        // the window ends TRAFFIC_WINDOW after the GVT; the traffic of the window is pulled and the events of the window
+        // that are not handed out yet are popped in the order of mycomp, so the packet ids are reserved in the order of the
+        // sequential engine; no logical process has run beyond the last window, so the events handed out are no stragglers
+        unsigned long long window_end = min(gvt + TRAFFIC_WINDOW, (unsigned long long)end_time + 1);
+        if (window_end > logical_process::window_end) {
+            logical_process::window_end = window_end;
+            if (traffic != nullptr) {
+                vector<event*> es;
+                traffic->pull(window_end, es);
+                events->push(es);
+            }
+            while ((e = events->pop()) != nullptr && e->trigger_time < window_end) {
+                logical_process* p = logical_process::of_node(e->owner());
+                if (e->packet_num() > 0)
+                    p->packet_ids.push_back(packet::reserve_ids(e->packet_num()));
+                p->push(e);
+            }
+            if (e != nullptr)
+                events->push(e);
+        }
+
+        logical_process::run_round();
+
+        // handle the messages in transit, including the anti-messages sent by the rollbacks they cause
+        bool mail = true;
+        while (mail) {
+            mail = false;
+            for (unsigned int i = 0; i < thread_num; i++) {
+                if (logical_process::lps[i]->has_mail) {
+                    logical_process::lps[i]->read_mail();
+                    mail = true;
+                }
+            }
+        }
+
+        // the events not handed out yet count for the GVT as well
+        gvt = (traffic != nullptr) ? traffic->next_time() : ULLONG_MAX;
+        if ((e = events->pop()) != nullptr) {
+            gvt = min(gvt, (unsigned long long)e->trigger_time);
+            events->push(e);
+        }
+        string error;
+        for (unsigned int i = 0; i < thread_num; i++) {
+            logical_process* p = logical_process::lps[i];
+            if (p->peek() != nullptr && p->peek()->trigger_time < gvt)
+                gvt = p->peek()->trigger_time;
+            if (error.empty())
+                error = p->error;
+        }
+        if (!error.empty()) {
+            cerr << error << endl;
+            break;
+        }
+        if (gvt > end_time) { // everything is run
+            logical_process::commit(ULLONG_MAX);
+            break;
+        }
+        logical_process::commit(gvt);
+    }
+
+    {
+        lock_guard<mutex> guard(logical_process::lock);
+        logical_process::stopping = true;
+    }
+    logical_process::start_cv.notify_all();
+    for (unsigned int i = 0; i < workers.size(); i++)
+        workers[i].join();
+    object_pool::set_threaded(false);
+
+    // the pending events go back to the scheduler of the sequential engine
+    for (unsigned int i = 0; i < thread_num; i++) {
+        logical_process* p = logical_process::lps[i];
+        while ((e = p->pop()) != nullptr)
+            events->push(e);
+        for (size_t j = 0; j < p->processed.size(); j++) // left by an error
+            delete p->processed[j].e;
+        if (p->time > cur_time)
+            cur_time = p->time;
+        delete p;
+    }
+    logical_process::lps.clear();
+    trace::flush();
+}
+
+///////////////// Final Exam ////////////////
+// ctrl new packet
+class SDN_ctrl_new_header : public header {
+    SDN_ctrl_new_header(SDN_ctrl_new_header&) {} // cannot be called by users
+
+protected:
+    SDN_ctrl_new_header() {} // this constructor cannot be directly called by users
+
+public:
+    ~SDN_ctrl_new_header() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_ctrl_new_header"; }
+    header_type_id type_id() const { return SDN_CTRL_NEW_HEADER; }
+
+    class SDN_ctrl_new_header_generator;
+    friend class SDN_ctrl_new_header_generator;
+    friend class header::header_generator; // for the typed factory
+    // SDN_ctrl_new_header_generator is derived from header_generator to generate a header
+    class SDN_ctrl_new_header_generator : public header_generator {
+        static SDN_ctrl_new_header_generator sample;
+        // this constructor is only for sample to register this header type
+        SDN_ctrl_new_header_generator() { /*cout << "SDN_ctrl_new_header registered" << endl;*/
+            register_header_type(&sample);
+        }
+
+    protected:
+        virtual header* generate() {
+            // cout << "SDN_ctrl_new_header generated" << endl;
+            return new SDN_ctrl_new_header;
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_new_header"; }
+        virtual header_type_id type_id() { return SDN_CTRL_NEW_HEADER; }
+        ~SDN_ctrl_new_header_generator() {}
+    };
+};
+SDN_ctrl_new_header::SDN_ctrl_new_header_generator SDN_ctrl_new_header::SDN_ctrl_new_header_generator::sample;
+object_pool SDN_ctrl_new_header::pool("SDN_ctrl_new_header", sizeof(SDN_ctrl_new_header));
+
+class SDN_ctrl_new_payload : public payload {
+    SDN_ctrl_new_payload(SDN_ctrl_new_payload&) {}
+
+    unsigned int matID; // match: target
+    unsigned int actID; // action: the next hop
+    vector<pair<unsigned int, unsigned int>> rules; // the (target, next hop) rules of a batch push, the first being
+                                                    // (matID, actID); empty if the packet carries only one rule
+
+protected:
+    SDN_ctrl_new_payload() {} // this constructor cannot be directly called by users
+public:
+    ~SDN_ctrl_new_payload() {}
+    POOLED_NEW_DELETE
+
+    string type() { return "SDN_ctrl_new_payload"; }
+    payload_type_id type_id() const { return SDN_CTRL_NEW_PAYLOAD; }
+    payload* clone() const {
+        SDN_ctrl_new_payload* p = new SDN_ctrl_new_payload;
+        *p = *this;
+        return p;
+    }
+
+    SET(setMatID, unsigned int, matID, _matID);
+    GET(getMatID, unsigned int, matID);
+    SET(setActID, unsigned int, actID, _actID);
+    GET(getActID, unsigned int, actID);
+    void setRules(const vector<pair<unsigned int, unsigned int>>& _rules) { rules = _rules; }
+    const vector<pair<unsigned int, unsigned int>>& getRules() const { return rules; }
+
+    class SDN_ctrl_new_payload_generator;
+    friend class SDN_ctrl_new_payload_generator;
+    friend class payload::payload_generator; // for the typed factory
+    // SDN_data_payload is derived from payload_generator to generate a payload
+    class SDN_ctrl_new_payload_generator : public payload_generator {
+        static SDN_ctrl_new_payload_generator sample;
+        // this constructor is only for sample to register this payload type
+        SDN_ctrl_new_payload_generator() { /*cout << "SDN_ctrl_new_payload registered" << endl;*/
+            register_payload_type(&sample);
+        }
+
+    protected:
+        virtual payload* generate() {
+            // cout << "SDN_ctrl_new_payload generated" << endl;
+            return new SDN_ctrl_new_payload;
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_new_payload"; }
+        virtual payload_type_id type_id() { return SDN_CTRL_NEW_PAYLOAD; }
+        ~SDN_ctrl_new_payload_generator() {}
+    };
+};
+SDN_ctrl_new_payload::SDN_ctrl_new_payload_generator SDN_ctrl_new_payload::SDN_ctrl_new_payload_generator::sample;
+object_pool SDN_ctrl_new_payload::pool("SDN_ctrl_new_payload", sizeof(SDN_ctrl_new_payload));
+
+class SDN_ctrl_new_packet : public packet {
+    SDN_ctrl_new_packet(SDN_ctrl_new_packet&) {}
+
+protected:
+    SDN_ctrl_new_packet() {} // this constructor cannot be directly called by users
+    SDN_ctrl_new_packet(packet* p) : packet(p) {
+        *(dynamic_cast<SDN_ctrl_new_header*>(this->getHeader())) = *(dynamic_cast<SDN_ctrl_new_header*>(p->getHeader()));
+        // DFS_path = (dynamic_cast<SDN_ctrl_new_header*>(p))->DFS_path;
+        // isVisited = (dynamic_cast<SDN_ctrl_new_header*>(p))->isVisited;
+    } // for duplicate
+    SDN_ctrl_new_packet(header* _h, payload* _p) : packet(_h, _p) {}
+
+public:
+    virtual ~SDN_ctrl_new_packet() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_ctrl_new_packet"; }
+    typedef SDN_ctrl_new_header header_type;
+    typedef SDN_ctrl_new_payload payload_type;
+    packet_type_id type_id() const { return SDN_CTRL_NEW_PACKET; }
+
+    class SDN_ctrl_new_packet_generator;
+    friend class SDN_ctrl_new_packet_generator;
+    friend class packet::packet_generator; // for the typed factory
+    // SDN_ctrl_new_packet is derived from packet_generator to generate a pub packet
+    class SDN_ctrl_new_packet_generator : public packet_generator {
+        static SDN_ctrl_new_packet_generator sample;
+        // this constructor is only for sample to register this packet type
+        SDN_ctrl_new_packet_generator() { /*cout << "SDN_ctrl_new_packet registered" << endl;*/
+            register_packet_type(&sample);
+        }
+
+    protected:
+        virtual packet* generate(packet* p = nullptr) {
+            // cout << "SDN_ctrl_new_packet generated" << endl;
+            if (nullptr == p)
+                return packet_generator::generate<SDN_ctrl_new_packet>();
+            else
+                return new SDN_ctrl_new_packet(p); // duplicate; the payload is shared
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_new_packet"; }
+        virtual packet_type_id type_id() { return SDN_CTRL_NEW_PACKET; }
+        ~SDN_ctrl_new_packet_generator() {}
+    };
+};
+SDN_ctrl_new_packet::SDN_ctrl_new_packet_generator SDN_ctrl_new_packet::SDN_ctrl_new_packet_generator::sample;
+object_pool SDN_ctrl_new_packet::pool("SDN_ctrl_new_packet", sizeof(SDN_ctrl_new_packet));
+
+class SDN_ctrl_new_pkt_gen_event : public event {
+public:
+    class pkt_gen_data; // forward declaration
+
+private:
+    SDN_ctrl_new_pkt_gen_event(SDN_ctrl_new_pkt_gen_event&) {}
+    SDN_ctrl_new_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
+    // this constructor cannot be directly called by users; only by generator
+    unsigned int src; // the src
+    unsigned int dst; // the dst
+    unsigned int mat;
+    unsigned int act;
+    vector<pair<unsigned int, unsigned int>> rules; // see SDN_ctrl_new_payload
+    // packet *pkt; // the packet
+    message msg;
+
+protected:
+    SDN_ctrl_new_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
+        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
+        src = data_ptr->src_id;
+        dst = data_ptr->dst_id;
+        // pkt = data_ptr->_pkt;
+        mat = data_ptr->mat_id;
+        act = data_ptr->act_id;
+        rules = data_ptr->rules;
+        msg = data_ptr->msg;
+    }
+    // the typed constructor; see event_generator::generate<T>()
+    SDN_ctrl_new_pkt_gen_event(unsigned int _trigger_time, pkt_gen_data&& data) : event(_trigger_time), src(data.src_id), dst(data.dst_id) {
+        mat = data.mat_id;
+        act = data.act_id;
+        rules = move(data.rules);
+        msg = move(data.msg);
+    }
+
+public:
+    virtual ~SDN_ctrl_new_pkt_gen_event() {}
+    POOLED_NEW_DELETE
+    // SDN_ctrl_new_pkt_gen_event will trigger the packet gen function
+    virtual void trigger();
+
+    unsigned int event_priority() const;
+    event_type_id type_id() const { return SDN_CTRL_NEW_PKT_GEN_EVENT; }
+    unsigned int owner() const { return src; } // the packet starts from src
+    unsigned int packet_num() const { return 1; }
+    packet_type_id packet_type() const { return SDN_CTRL_NEW_PACKET; }
+
+    class SDN_ctrl_new_pkt_gen_event_generator;
+    friend class SDN_ctrl_new_pkt_gen_event_generator;
+    friend class event::event_generator; // for the typed factory
+    // SDN_ctrl_new_pkt_gen_event_generator is derived from event_generator to generate an event
+    class SDN_ctrl_new_pkt_gen_event_generator : public event_generator {
+        static SDN_ctrl_new_pkt_gen_event_generator sample;
+        // this constructor is only for sample to register this event type
+        SDN_ctrl_new_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
+            register_event_type(&sample);
+        }
+
+    protected:
+        virtual event* generate(unsigned int _trigger_time, void* data) {
+            // cout << "send_event generated" << endl;
+            return new SDN_ctrl_new_pkt_gen_event(_trigger_time, data);
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_new_pkt_gen_event"; }
+        virtual event_type_id type_id() { return SDN_CTRL_NEW_PKT_GEN_EVENT; }
+        ~SDN_ctrl_new_pkt_gen_event_generator() {}
+    };
+    // this class is used to initialize the SDN_ctrl_new_pkt_gen_event
+    class pkt_gen_data {
+    public:
+        unsigned int src_id; // the controller
+        unsigned int dst_id; // the node that should update its rule
+        unsigned int mat_id; // the target of the rule
+        unsigned int act_id; // the next hop toward the target recorded in the rule
+        vector<pair<unsigned int, unsigned int>> rules; // all the rules of a batch push; empty for one rule
+        message msg;
+        // packet *_pkt;
+
+        pkt_gen_data() = default;
+        pkt_gen_data(pkt_gen_data&&) = default; // moved into the event, never copied
+        pkt_gen_data& operator=(pkt_gen_data&&) = default;
+    };
+
+    void print() const;
+};
+SDN_ctrl_new_pkt_gen_event::SDN_ctrl_new_pkt_gen_event_generator SDN_ctrl_new_pkt_gen_event::SDN_ctrl_new_pkt_gen_event_generator::sample;
+object_pool SDN_ctrl_new_pkt_gen_event::pool("SDN_ctrl_new_pkt_gen_event", sizeof(SDN_ctrl_new_pkt_gen_event));
+void SDN_ctrl_new_pkt_gen_event::trigger() {
+    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
+        cerr << "SDN_ctrl_new_pkt_gen_event error: no node " << dst << "!" << endl;
+        return;
+    }
+
+    SDN_ctrl_new_packet* pkt = packet::packet_generator::generate<SDN_ctrl_new_packet>();
+    if (pkt == nullptr) {
+        cerr << "packet type is incorrect" << endl;
+        return;
+    }
+    SDN_ctrl_new_header* hdr = dynamic_cast<SDN_ctrl_new_header*>(pkt->getHeader());
+    SDN_ctrl_new_payload* pld = dynamic_cast<SDN_ctrl_new_payload*>(pkt->getMutablePayload());
+
+    if (hdr == nullptr) {
+        cerr << "header type is incorrect" << endl;
+        return;
+    }
+    if (pld == nullptr) {
+        cerr << "payload type is incorrect" << endl;
+        return;
+    }
+
+    hdr->setSrcID(src);
+    hdr->setDstID(dst);
+    hdr->setPreID(src);
+    hdr->setNexID(src); // in hw3, you should set NexID to src
+    // payload
+    pld->setMsg(msg);
+    pld->setMatID(mat);
+    pld->setActID(act);
+    pld->setRules(rules); // copied: the optimistic engine may trigger the event again
+
+    recv_event::recv_data e_data;
+    e_data.s_id = src;
+    e_data.r_id = src; // in hw3, you should set r_id it src
+    e_data._pkt = pkt;
+
+    recv_event* e = event::event_generator::generate<recv_event>(trigger_time, move(e_data));
+}
+unsigned int SDN_ctrl_new_pkt_gen_event::event_priority() const {
+    return get_hash_value({getTriggerTime(), src, dst, mat, act});
+}
+// the SDN_ctrl_new_pkt_gen_event::print() function is used for log file
+void SDN_ctrl_new_pkt_gen_event::print() const {
+    trace::record r = {event::getCurTime(), trace::GEN_RULE, SDN_CTRL_NEW_PACKET, 0, {src, dst, mat, act}};
+    trace::write(r);
+}
+void ctrl_new_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), message msg = message::DEFAULT) {
+    // void ctrl_new_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
+    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
+        cerr << "id is incorrect" << endl;
+        return;
+    }
+
+    unsigned int src = con_id;
+    SDN_ctrl_new_pkt_gen_event::pkt_gen_data e_data;
+    e_data.src_id = src;
+    e_data.dst_id = id;
+    e_data.mat_id = mat;
+    e_data.act_id = act;
+    e_data.msg = msg;
+
+    SDN_ctrl_new_pkt_gen_event* e = event::event_generator::generate<SDN_ctrl_new_pkt_gen_event>(t, move(e_data));
+    if (e == nullptr)
+        cerr << "event type is incorrect" << endl;
+}
+// the same, but the controller pushes a batch of (target, next hop) rules to the switch in one packet, and the switch
+// installs them at once; the trace shows the first rule
+void ctrl_new_packet_event(unsigned int con_id, unsigned int id, vector<pair<unsigned int, unsigned int>> rules, unsigned int t = event::getCurTime(), message msg = message::DEFAULT) {
+    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
+        cerr << "id is incorrect" << endl;
+        return;
+    }
+    if (rules.empty())
+        return;
+
+    SDN_ctrl_new_pkt_gen_event::pkt_gen_data e_data;
+    e_data.src_id = con_id;
+    e_data.dst_id = id;
+    e_data.mat_id = rules[0].first;
+    e_data.act_id = rules[0].second;
+    if (rules.size() > 1)
+        e_data.rules = move(rules);
+    e_data.msg = msg;
+
+    SDN_ctrl_new_pkt_gen_event* e = event::event_generator::generate<SDN_ctrl_new_pkt_gen_event>(t, move(e_data));
+    if (e == nullptr)
+        cerr << "event type is incorrect" << endl;
+}
+// ctrl delete packet
+class SDN_ctrl_del_header : public header {
+    SDN_ctrl_del_header(SDN_ctrl_del_header&) {} // cannot be called by users
+
+protected:
+    SDN_ctrl_del_header() {} // this constructor cannot be directly called by users
+
+public:
+    ~SDN_ctrl_del_header() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_ctrl_del_header"; }
+    header_type_id type_id() const { return SDN_CTRL_DEL_HEADER; }
+
+    class SDN_ctrl_del_header_generator;
+    friend class SDN_ctrl_del_header_generator;
+    friend class header::header_generator; // for the typed factory
+    // SDN_ctrl_del_header_generator is derived from header_generator to generate a header
+    class SDN_ctrl_del_header_generator : public header_generator {
+        static SDN_ctrl_del_header_generator sample;
+        // this constructor is only for sample to register this header type
+        SDN_ctrl_del_header_generator() { /*cout << "SDN_ctrl_del_header registered" << endl;*/
+            register_header_type(&sample);
+        }
+
+    protected:
+        virtual header* generate() {
+            // cout << "SDN_ctrl_del_header generated" << endl;
+            return new SDN_ctrl_del_header;
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_del_header"; }
+        virtual header_type_id type_id() { return SDN_CTRL_DEL_HEADER; }
+        ~SDN_ctrl_del_header_generator() {}
+    };
+};
+SDN_ctrl_del_header::SDN_ctrl_del_header_generator SDN_ctrl_del_header::SDN_ctrl_del_header_generator::sample;
+object_pool SDN_ctrl_del_header::pool("SDN_ctrl_del_header", sizeof(SDN_ctrl_del_header));
+
+class SDN_ctrl_del_payload : public payload {
+    SDN_ctrl_del_payload(SDN_ctrl_del_payload&) {}
+
+    unsigned int matID; // match: target
+    unsigned int actID; // action: the next hop
+
+protected:
+    SDN_ctrl_del_payload() {} // this constructor cannot be directly called by users
+public:
+    ~SDN_ctrl_del_payload() {}
+    POOLED_NEW_DELETE
+
+    string type() { return "SDN_ctrl_del_payload"; }
+    payload_type_id type_id() const { return SDN_CTRL_DEL_PAYLOAD; }
+    payload* clone() const {
+        SDN_ctrl_del_payload* p = new SDN_ctrl_del_payload;
+        *p = *this;
+        return p;
+    }
+
+    SET(setMatID, unsigned int, matID, _matID);
+    GET(getMatID, unsigned int, matID);
+    SET(setActID, unsigned int, actID, _actID);
+    GET(getActID, unsigned int, actID);
+
+    class SDN_ctrl_del_payload_generator;
+    friend class SDN_ctrl_del_payload_generator;
+    friend class payload::payload_generator; // for the typed factory
+    // SDN_data_payload is derived from payload_generator to generate a payload
+    class SDN_ctrl_del_payload_generator : public payload_generator {
+        static SDN_ctrl_del_payload_generator sample;
+        // this constructor is only for sample to register this payload type
+        SDN_ctrl_del_payload_generator() { /*cout << "SDN_ctrl_del_payload registered" << endl;*/
+            register_payload_type(&sample);
+        }
+
+    protected:
+        virtual payload* generate() {
+            // cout << "SDN_ctrl_del_payload generated" << endl;
+            return new SDN_ctrl_del_payload;
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_del_payload"; }
+        virtual payload_type_id type_id() { return SDN_CTRL_DEL_PAYLOAD; }
+        ~SDN_ctrl_del_payload_generator() {}
+    };
+};
+SDN_ctrl_del_payload::SDN_ctrl_del_payload_generator SDN_ctrl_del_payload::SDN_ctrl_del_payload_generator::sample;
+object_pool SDN_ctrl_del_payload::pool("SDN_ctrl_del_payload", sizeof(SDN_ctrl_del_payload));
+
+class SDN_ctrl_del_packet : public packet {
+    SDN_ctrl_del_packet(SDN_ctrl_del_packet&) {}
+
+protected:
+    SDN_ctrl_del_packet() {} // this constructor cannot be directly called by users
+    SDN_ctrl_del_packet(packet* p) : packet(p) {
+        *(dynamic_cast<SDN_ctrl_del_header*>(this->getHeader())) = *(dynamic_cast<SDN_ctrl_del_header*>(p->getHeader()));
+        // DFS_path = (dynamic_cast<SDN_ctrl_del_header*>(p))->DFS_path;
+        // isVisited = (dynamic_cast<SDN_ctrl_del_header*>(p))->isVisited;
+    } // for duplicate
+    SDN_ctrl_del_packet(header* _h, payload* _p) : packet(_h, _p) {}
+
+public:
+    virtual ~SDN_ctrl_del_packet() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_ctrl_del_packet"; }
+    typedef SDN_ctrl_del_header header_type;
+    typedef SDN_ctrl_del_payload payload_type;
+    packet_type_id type_id() const { return SDN_CTRL_DEL_PACKET; }
+
+    class SDN_ctrl_del_packet_generator;
+    friend class SDN_ctrl_del_packet_generator;
+    friend class packet::packet_generator; // for the typed factory
+    // SDN_ctrl_del_packet is derived from packet_generator to generate a pub packet
+    class SDN_ctrl_del_packet_generator : public packet_generator {
+        static SDN_ctrl_del_packet_generator sample;
+        // this constructor is only for sample to register this packet type
+        SDN_ctrl_del_packet_generator() { /*cout << "SDN_ctrl_del_packet registered" << endl;*/
+            register_packet_type(&sample);
+        }
+
+    protected:
+        virtual packet* generate(packet* p = nullptr) {
+            // cout << "SDN_ctrl_del_packet generated" << endl;
+            if (nullptr == p)
+                return packet_generator::generate<SDN_ctrl_del_packet>();
+            else
+                return new SDN_ctrl_del_packet(p); // duplicate; the payload is shared
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_del_packet"; }
+        virtual packet_type_id type_id() { return SDN_CTRL_DEL_PACKET; }
+        ~SDN_ctrl_del_packet_generator() {}
+    };
+};
+SDN_ctrl_del_packet::SDN_ctrl_del_packet_generator SDN_ctrl_del_packet::SDN_ctrl_del_packet_generator::sample;
+object_pool SDN_ctrl_del_packet::pool("SDN_ctrl_del_packet", sizeof(SDN_ctrl_del_packet));
+
+class SDN_ctrl_del_pkt_gen_event : public event {
+public:
+    class pkt_gen_data; // forward declaration
+
+private:
+    SDN_ctrl_del_pkt_gen_event(SDN_ctrl_del_pkt_gen_event&) {}
+    SDN_ctrl_del_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
+    // this constructor cannot be directly called by users; only by generator
+    unsigned int src; // the src
+    unsigned int dst; // the dst
+    unsigned int mat;
+    unsigned int act;
+    // packet *pkt; // the packet
+    message msg;
+
+protected:
+    SDN_ctrl_del_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
+        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
+        src = data_ptr->src_id;
+        dst = data_ptr->dst_id;
+        // pkt = data_ptr->_pkt;
+        mat = data_ptr->mat_id;
+        act = data_ptr->act_id;
+        msg = data_ptr->msg;
+    }
+    // the typed constructor; see event_generator::generate<T>()
+    SDN_ctrl_del_pkt_gen_event(unsigned int _trigger_time, pkt_gen_data&& data) : event(_trigger_time), src(data.src_id), dst(data.dst_id) {
+        mat = data.mat_id;
+        act = data.act_id;
+        msg = move(data.msg);
+    }
+
+public:
+    virtual ~SDN_ctrl_del_pkt_gen_event() {}
+    POOLED_NEW_DELETE
+    // SDN_ctrl_del_pkt_gen_event will trigger the packet gen function
+    virtual void trigger();
+
+    unsigned int event_priority() const;
+    event_type_id type_id() const { return SDN_CTRL_DEL_PKT_GEN_EVENT; }
+    unsigned int owner() const { return src; } // the packet starts from src
+    unsigned int packet_num() const { return 1; }
+    packet_type_id packet_type() const { return SDN_CTRL_DEL_PACKET; }
+
+    class SDN_ctrl_del_pkt_gen_event_generator;
+    friend class SDN_ctrl_del_pkt_gen_event_generator;
+    friend class event::event_generator; // for the typed factory
+    // SDN_ctrl_del_pkt_gen_event_generator is derived from event_generator to generate an event
+    class SDN_ctrl_del_pkt_gen_event_generator : public event_generator {
+        static SDN_ctrl_del_pkt_gen_event_generator sample;
+        // this constructor is only for sample to register this event type
+        SDN_ctrl_del_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
+            register_event_type(&sample);
+        }
+
+    protected:
+        virtual event* generate(unsigned int _trigger_time, void* data) {
+            // cout << "send_event generated" << endl;
+            return new SDN_ctrl_del_pkt_gen_event(_trigger_time, data);
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_del_pkt_gen_event"; }
+        virtual event_type_id type_id() { return SDN_CTRL_DEL_PKT_GEN_EVENT; }
+        ~SDN_ctrl_del_pkt_gen_event_generator() {}
+    };
+    // this class is used to initialize the SDN_ctrl_del_pkt_gen_event
+    class pkt_gen_data {
+    public:
+        unsigned int src_id; // the controller
+        unsigned int dst_id; // the node that should update its rule
+        unsigned int mat_id; // the target of the rule
+        unsigned int act_id; // the next hop toward the target recorded in the rule
+        message msg;
+        // packet *_pkt;
+
+        pkt_gen_data() = default;
+        pkt_gen_data(pkt_gen_data&&) = default; // moved into the event, never copied
+        pkt_gen_data& operator=(pkt_gen_data&&) = default;
+    };
+
+    void print() const;
+};
+SDN_ctrl_del_pkt_gen_event::SDN_ctrl_del_pkt_gen_event_generator SDN_ctrl_del_pkt_gen_event::SDN_ctrl_del_pkt_gen_event_generator::sample;
+object_pool SDN_ctrl_del_pkt_gen_event::pool("SDN_ctrl_del_pkt_gen_event", sizeof(SDN_ctrl_del_pkt_gen_event));
+void SDN_ctrl_del_pkt_gen_event::trigger() {
+    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
+        cerr << "SDN_ctrl_del_pkt_gen_event error: no node " << dst << "!" << endl;
+        return;
+    }
+
+    SDN_ctrl_del_packet* pkt = packet::packet_generator::generate<SDN_ctrl_del_packet>();
+    if (pkt == nullptr) {
+        cerr << "packet type is incorrect" << endl;
+        return;
+    }
+    SDN_ctrl_del_header* hdr = dynamic_cast<SDN_ctrl_del_header*>(pkt->getHeader());
+    SDN_ctrl_del_payload* pld = dynamic_cast<SDN_ctrl_del_payload*>(pkt->getMutablePayload());
+
+    if (hdr == nullptr) {
+        cerr << "header type is incorrect" << endl;
+        return;
+    }
+    if (pld == nullptr) {
+        cerr << "payload type is incorrect" << endl;
+        return;
+    }
+
+    hdr->setSrcID(src);
+    hdr->setDstID(dst);
+    hdr->setPreID(src);
+    hdr->setNexID(src); // in hw3, you should set NexID to src
+    // payload
+    pld->setMsg(msg);
+    pld->setMatID(mat);
+    pld->setActID(act);
+
+    recv_event::recv_data e_data;
+    e_data.s_id = src;
+    e_data.r_id = src; // in hw3, you should set r_id it src
+    e_data._pkt = pkt;
+
+    recv_event* e = event::event_generator::generate<recv_event>(trigger_time, move(e_data));
+}
+unsigned int SDN_ctrl_del_pkt_gen_event::event_priority() const {
+    return get_hash_value({getTriggerTime(), src, dst, mat, act});
+}
+// the SDN_ctrl_del_pkt_gen_event::print() function is used for log file
+void SDN_ctrl_del_pkt_gen_event::print() const {
+    trace::record r = {event::getCurTime(), trace::GEN_RULE, SDN_CTRL_DEL_PACKET, 0, {src, dst, mat, act}};
+    trace::write(r);
+}
+void ctrl_del_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), message msg = message::DEFAULT) {
+    // void ctrl_del_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
+    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
+        cerr << "id is incorrect" << endl;
+        return;
+    }
+
+    unsigned int src = con_id;
+    SDN_ctrl_del_pkt_gen_event::pkt_gen_data e_data;
+    e_data.src_id = src;
+    e_data.dst_id = id;
+    e_data.mat_id = mat;
+    e_data.act_id = act;
+    e_data.msg = msg;
+
+    SDN_ctrl_del_pkt_gen_event* e = event::event_generator::generate<SDN_ctrl_del_pkt_gen_event>(t, move(e_data));
+    if (e == nullptr)
+        cerr << "event type is incorrect" << endl;
+}
+// ctrl update packet
+class SDN_ctrl_upd_header : public header {
+    SDN_ctrl_upd_header(SDN_ctrl_upd_header&) {} // cannot be called by users
+
+protected:
+    SDN_ctrl_upd_header() {} // this constructor cannot be directly called by users
+
+public:
+    ~SDN_ctrl_upd_header() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_ctrl_upd_header"; }
+    header_type_id type_id() const { return SDN_CTRL_UPD_HEADER; }
+
+    class SDN_ctrl_upd_header_generator;
+    friend class SDN_ctrl_upd_header_generator;
+    friend class header::header_generator; // for the typed factory
+    // SDN_ctrl_upd_header_generator is derived from header_generator to generate a header
+    class SDN_ctrl_upd_header_generator : public header_generator {
+        static SDN_ctrl_upd_header_generator sample;
+        // this constructor is only for sample to register this header type
+        SDN_ctrl_upd_header_generator() { /*cout << "SDN_ctrl_upd_header registered" << endl;*/
+            register_header_type(&sample);
+        }
+
+    protected:
+        virtual header* generate() {
+            // cout << "SDN_ctrl_upd_header generated" << endl;
+            return new SDN_ctrl_upd_header;
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_upd_header"; }
+        virtual header_type_id type_id() { return SDN_CTRL_UPD_HEADER; }
+        ~SDN_ctrl_upd_header_generator() {}
+    };
+};
+SDN_ctrl_upd_header::SDN_ctrl_upd_header_generator SDN_ctrl_upd_header::SDN_ctrl_upd_header_generator::sample;
+object_pool SDN_ctrl_upd_header::pool("SDN_ctrl_upd_header", sizeof(SDN_ctrl_upd_header));
+
+class SDN_ctrl_upd_payload : public payload {
+    SDN_ctrl_upd_payload(SDN_ctrl_upd_payload&) {}
+
+    unsigned int matID; // match: target
+    unsigned int actID; // action: the next hop
+
+protected:
+    SDN_ctrl_upd_payload() {} // this constructor cannot be directly called by users
+public:
+    ~SDN_ctrl_upd_payload() {}
+    POOLED_NEW_DELETE
+
+    string type() { return "SDN_ctrl_upd_payload"; }
+    payload_type_id type_id() const { return SDN_CTRL_UPD_PAYLOAD; }
+    payload* clone() const {
+        SDN_ctrl_upd_payload* p = new SDN_ctrl_upd_payload;
+        *p = *this;
+        return p;
+    }
+
+    SET(setMatID, unsigned int, matID, _matID);
+    GET(getMatID, unsigned int, matID);
+    SET(setActID, unsigned int, actID, _actID);
+    GET(getActID, unsigned int, actID);
+
+    class SDN_ctrl_upd_payload_generator;
+    friend class SDN_ctrl_upd_payload_generator;
+    friend class payload::payload_generator; // for the typed factory
+    // SDN_data_payload is derived from payload_generator to generate a payload
+    class SDN_ctrl_upd_payload_generator : public payload_generator {
+        static SDN_ctrl_upd_payload_generator sample;
+        // this constructor is only for sample to register this payload type
+        SDN_ctrl_upd_payload_generator() { /*cout << "SDN_ctrl_upd_payload registered" << endl;*/
+            register_payload_type(&sample);
+        }
+
+    protected:
+        virtual payload* generate() {
+            // cout << "SDN_ctrl_upd_payload generated" << endl;
+            return new SDN_ctrl_upd_payload;
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_upd_payload"; }
+        virtual payload_type_id type_id() { return SDN_CTRL_UPD_PAYLOAD; }
+        ~SDN_ctrl_upd_payload_generator() {}
+    };
+};
+SDN_ctrl_upd_payload::SDN_ctrl_upd_payload_generator SDN_ctrl_upd_payload::SDN_ctrl_upd_payload_generator::sample;
+object_pool SDN_ctrl_upd_payload::pool("SDN_ctrl_upd_payload", sizeof(SDN_ctrl_upd_payload));
+
+class SDN_ctrl_upd_packet : public packet {
+    SDN_ctrl_upd_packet(SDN_ctrl_upd_packet&) {}
+
+protected:
+    SDN_ctrl_upd_packet() {} // this constructor cannot be directly called by users
+    SDN_ctrl_upd_packet(packet* p) : packet(p) {
+        *(dynamic_cast<SDN_ctrl_upd_header*>(this->getHeader())) = *(dynamic_cast<SDN_ctrl_upd_header*>(p->getHeader()));
+        // DFS_path = (dynamic_cast<SDN_ctrl_upd_header*>(p))->DFS_path;
+        // isVisited = (dynamic_cast<SDN_ctrl_upd_header*>(p))->isVisited;
+    } // for duplicate
+    SDN_ctrl_upd_packet(header* _h, payload* _p) : packet(_h, _p) {}
+
+public:
+    virtual ~SDN_ctrl_upd_packet() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_ctrl_upd_packet"; }
+    typedef SDN_ctrl_upd_header header_type;
+    typedef SDN_ctrl_upd_payload payload_type;
+    packet_type_id type_id() const { return SDN_CTRL_UPD_PACKET; }
+
+    class SDN_ctrl_upd_packet_generator;
+    friend class SDN_ctrl_upd_packet_generator;
+    friend class packet::packet_generator; // for the typed factory
+    // SDN_ctrl_upd_packet is derived from packet_generator to generate a pub packet
+    class SDN_ctrl_upd_packet_generator : public packet_generator {
+        static SDN_ctrl_upd_packet_generator sample;
+        // this constructor is only for sample to register this packet type
+        SDN_ctrl_upd_packet_generator() { /*cout << "SDN_ctrl_upd_packet registered" << endl;*/
+            register_packet_type(&sample);
+        }
+
+    protected:
+        virtual packet* generate(packet* p = nullptr) {
+            // cout << "SDN_ctrl_upd_packet generated" << endl;
+            if (nullptr == p)
+                return packet_generator::generate<SDN_ctrl_upd_packet>();
+            else
+                return new SDN_ctrl_upd_packet(p); // duplicate; the payload is shared
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_upd_packet"; }
+        virtual packet_type_id type_id() { return SDN_CTRL_UPD_PACKET; }
+        ~SDN_ctrl_upd_packet_generator() {}
+    };
+};
+SDN_ctrl_upd_packet::SDN_ctrl_upd_packet_generator SDN_ctrl_upd_packet::SDN_ctrl_upd_packet_generator::sample;
+object_pool SDN_ctrl_upd_packet::pool("SDN_ctrl_upd_packet", sizeof(SDN_ctrl_upd_packet));
+
+class SDN_ctrl_upd_pkt_gen_event : public event {
+public:
+    class pkt_gen_data; // forward declaration
+
+private:
+    SDN_ctrl_upd_pkt_gen_event(SDN_ctrl_upd_pkt_gen_event&) {}
+    SDN_ctrl_upd_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
+    // this constructor cannot be directly called by users; only by generator
+    unsigned int src; // the src
+    unsigned int dst; // the dst
+    unsigned int mat;
+    unsigned int act;
+    // packet *pkt; // the packet
+    message msg;
+
+protected:
+    SDN_ctrl_upd_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
+        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
+        src = data_ptr->src_id;
+        dst = data_ptr->dst_id;
+        // pkt = data_ptr->_pkt;
+        mat = data_ptr->mat_id;
+        act = data_ptr->act_id;
+        msg = data_ptr->msg;
+    }
+    // the typed constructor; see event_generator::generate<T>()
+    SDN_ctrl_upd_pkt_gen_event(unsigned int _trigger_time, pkt_gen_data&& data) : event(_trigger_time), src(data.src_id), dst(data.dst_id) {
+        mat = data.mat_id;
+        act = data.act_id;
+        msg = move(data.msg);
+    }
+
+public:
+    virtual ~SDN_ctrl_upd_pkt_gen_event() {}
+    POOLED_NEW_DELETE
+    // SDN_ctrl_upd_pkt_gen_event will trigger the packet gen function
+    virtual void trigger();
+
+    unsigned int event_priority() const;
+    event_type_id type_id() const { return SDN_CTRL_UPD_PKT_GEN_EVENT; }
+    unsigned int owner() const { return src; } // the packet starts from src
+    unsigned int packet_num() const { return 1; }
+    packet_type_id packet_type() const { return SDN_CTRL_UPD_PACKET; }
+
+    class SDN_ctrl_upd_pkt_gen_event_generator;
+    friend class SDN_ctrl_upd_pkt_gen_event_generator;
+    friend class event::event_generator; // for the typed factory
+    // SDN_ctrl_upd_pkt_gen_event_generator is derived from event_generator to generate an event
+    class SDN_ctrl_upd_pkt_gen_event_generator : public event_generator {
+        static SDN_ctrl_upd_pkt_gen_event_generator sample;
+        // this constructor is only for sample to register this event type
+        SDN_ctrl_upd_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
+            register_event_type(&sample);
+        }
+
+    protected:
+        virtual event* generate(unsigned int _trigger_time, void* data) {
+            // cout << "send_event generated" << endl;
+            return new SDN_ctrl_upd_pkt_gen_event(_trigger_time, data);
+        }
+
+    public:
+        virtual string type() { return "SDN_ctrl_upd_pkt_gen_event"; }
+        virtual event_type_id type_id() { return SDN_CTRL_UPD_PKT_GEN_EVENT; }
+        ~SDN_ctrl_upd_pkt_gen_event_generator() {}
+    };
+    // this class is used to initialize the SDN_ctrl_upd_pkt_gen_event
+    class pkt_gen_data {
+    public:
+        unsigned int src_id; // the controller
+        unsigned int dst_id; // the node that should update its rule
+        unsigned int mat_id; // the target of the rule
+        unsigned int act_id; // the next hop toward the target recorded in the rule
+        message msg;
+        // packet *_pkt;
+
+        pkt_gen_data() = default;
+        pkt_gen_data(pkt_gen_data&&) = default; // moved into the event, never copied
+        pkt_gen_data& operator=(pkt_gen_data&&) = default;
+    };
+
+    void print() const;
+};
+SDN_ctrl_upd_pkt_gen_event::SDN_ctrl_upd_pkt_gen_event_generator SDN_ctrl_upd_pkt_gen_event::SDN_ctrl_upd_pkt_gen_event_generator::sample;
+object_pool SDN_ctrl_upd_pkt_gen_event::pool("SDN_ctrl_upd_pkt_gen_event", sizeof(SDN_ctrl_upd_pkt_gen_event));
+void SDN_ctrl_upd_pkt_gen_event::trigger() {
+    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
+        cerr << "SDN_ctrl_upd_pkt_gen_event error: no node " << dst << "!" << endl;
+        return;
+    }
+
+    SDN_ctrl_upd_packet* pkt = packet::packet_generator::generate<SDN_ctrl_upd_packet>();
+    if (pkt == nullptr) {
+        cerr << "packet type is incorrect" << endl;
+        return;
+    }
+    SDN_ctrl_upd_header* hdr = dynamic_cast<SDN_ctrl_upd_header*>(pkt->getHeader());
+    SDN_ctrl_upd_payload* pld = dynamic_cast<SDN_ctrl_upd_payload*>(pkt->getMutablePayload());
+
+    if (hdr == nullptr) {
+        cerr << "header type is incorrect" << endl;
+        return;
+    }
+    if (pld == nullptr) {
+        cerr << "payload type is incorrect" << endl;
+        return;
+    }
+
+    hdr->setSrcID(src);
+    hdr->setDstID(dst);
+    hdr->setPreID(src);
+    hdr->setNexID(src); // in hw3, you should set NexID to src
+    // payload
+    pld->setMsg(msg);
+    pld->setMatID(mat);
+    pld->setActID(act);
+
+    recv_event::recv_data e_data;
+    e_data.s_id = src;
+    e_data.r_id = src; // in hw3, you should set r_id it src
+    e_data._pkt = pkt;
+
+    recv_event* e = event::event_generator::generate<recv_event>(trigger_time, move(e_data));
+}
+unsigned int SDN_ctrl_upd_pkt_gen_event::event_priority() const {
+    return get_hash_value({getTriggerTime(), src, dst, mat, act});
+}
+// the SDN_ctrl_upd_pkt_gen_event::print() function is used for log file
+void SDN_ctrl_upd_pkt_gen_event::print() const {
+    trace::record r = {event::getCurTime(), trace::GEN_RULE, SDN_CTRL_UPD_PACKET, 0, {src, dst, mat, act}};
+    trace::write(r);
+}
+void ctrl_upd_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), message msg = message::DEFAULT) {
+    // void ctrl_upd_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
+    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
+        cerr << "id is incorrect" << endl;
+        return;
+    }
+
+    unsigned int src = con_id;
+    SDN_ctrl_upd_pkt_gen_event::pkt_gen_data e_data;
+    e_data.src_id = src;
+    e_data.dst_id = id;
+    e_data.mat_id = mat;
+    e_data.act_id = act;
+    e_data.msg = msg;
+
+    SDN_ctrl_upd_pkt_gen_event* e = event::event_generator::generate<SDN_ctrl_upd_pkt_gen_event>(t, move(e_data));
+    if (e == nullptr)
+        cerr << "event type is incorrect" << endl;
+}
+class SDN_stat_header : public header {
+    SDN_stat_header(SDN_stat_header&) {} // cannot be called by users
+
+protected:
+    SDN_stat_header() {} // this constructor cannot be directly called by users
+
+public:
+    ~SDN_stat_header() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_stat_header"; }
+    header_type_id type_id() const { return SDN_STAT_HEADER; }
+
+    class SDN_stat_header_generator;
+    friend class SDN_stat_header_generator;
+    friend class header::header_generator; // for the typed factory
+    // SDN_stat_header_generator is derived from header_generator to generate a header
+    class SDN_stat_header_generator : public header_generator {
+        static SDN_stat_header_generator sample;
+        // this constructor is only for sample to register this header type
+        SDN_stat_header_generator() { /*cout << "SDN_stat_header registered" << endl;*/
+            register_header_type(&sample);
+        }
+
+    protected:
+        virtual header* generate() {
+            // cout << "SDN_stat_header generated" << endl;
+            return new SDN_stat_header;
+        }
+
+    public:
+        virtual string type() { return "SDN_stat_header"; }
+        virtual header_type_id type_id() { return SDN_STAT_HEADER; }
+        ~SDN_stat_header_generator() {}
+    };
+};
+SDN_stat_header::SDN_stat_header_generator SDN_stat_header::SDN_stat_header_generator::sample;
+object_pool SDN_stat_header::pool("SDN_stat_header", sizeof(SDN_stat_header));
+
+class SDN_stat_payload : public payload {
+    SDN_stat_payload(SDN_stat_payload&) {}
+
+    shared_ptr<const map<unsigned int, unsigned int>> LinkWeight; // shared by the replicas of the payload
+    int aaa;
+
+protected:
+    SDN_stat_payload() {} // this constructor cannot be directly called by users
+public:
+    ~SDN_stat_payload() {}
+    POOLED_NEW_DELETE
+
+    string type() { return "SDN_stat_payload"; }
+    payload_type_id type_id() const { return SDN_STAT_PAYLOAD; }
+    payload* clone() const {
+        SDN_stat_payload* p = new SDN_stat_payload;
+        *p = *this;
+        return p;
+    }
+
+    void setLinkWeight(shared_ptr<const map<unsigned int, unsigned int>> _LinkWeight) { LinkWeight = move(_LinkWeight); }
+    const map<unsigned int, unsigned int>& getLinkWeight() const {
+        static const map<unsigned int, unsigned int> none;
+        return LinkWeight != nullptr ? *LinkWeight : none;
+    }
+
+    class SDN_stat_payload_generator;
+    friend class SDN_stat_payload_generator;
+    friend class payload::payload_generator; // for the typed factory
+    // SDN_data_payload is derived from payload_generator to generate a payload
+    class SDN_stat_payload_generator : public payload_generator {
+        static SDN_stat_payload_generator sample;
+        // this constructor is only for sample to register this payload type
+        SDN_stat_payload_generator() { /*cout << "SDN_stat_payload registered" << endl;*/
+            register_payload_type(&sample);
+        }
+
+    protected:
+        virtual payload* generate() {
+            // cout << "SDN_stat_payload generated" << endl;
+            return new SDN_stat_payload;
+        }
+
+    public:
+        virtual string type() { return "SDN_stat_payload"; }
+        virtual payload_type_id type_id() { return SDN_STAT_PAYLOAD; }
+        ~SDN_stat_payload_generator() {}
+    };
+};
+SDN_stat_payload::SDN_stat_payload_generator SDN_stat_payload::SDN_stat_payload_generator::sample;
+object_pool SDN_stat_payload::pool("SDN_stat_payload", sizeof(SDN_stat_payload));
+
+class SDN_stat_packet : public packet {
+    SDN_stat_packet(SDN_stat_packet&) {}
+
+protected:
+    SDN_stat_packet() {} // this constructor cannot be directly called by users
+    SDN_stat_packet(packet* p) : packet(p) {
+        *(dynamic_cast<SDN_stat_header*>(this->getHeader())) = *(dynamic_cast<SDN_stat_header*>(p->getHeader()));
+        // DFS_path = (dynamic_cast<SDN_stat_header*>(p))->DFS_path;
+        // isVisited = (dynamic_cast<SDN_stat_header*>(p))->isVisited;
+    } // for duplicate
+    SDN_stat_packet(header* _h, payload* _p) : packet(_h, _p) {}
+
+public:
+    virtual ~SDN_stat_packet() {}
+    POOLED_NEW_DELETE
+    string type() { return "SDN_stat_packet"; }
+    typedef SDN_stat_header header_type;
+    typedef SDN_stat_payload payload_type;
+    packet_type_id type_id() const { return SDN_STAT_PACKET; }
+
+    class SDN_stat_packet_generator;
+    friend class SDN_stat_packet_generator;
+    friend class packet::packet_generator; // for the typed factory
+    // SDN_stat_packet is derived from packet_generator to generate a pub packet
+    class SDN_stat_packet_generator : public packet_generator {
+        static SDN_stat_packet_generator sample;
+        // this constructor is only for sample to register this packet type
+        SDN_stat_packet_generator() { /*cout << "SDN_stat_packet registered" << endl;*/
+            register_packet_type(&sample);
+        }
+
+    protected:
+        virtual packet* generate(packet* p = nullptr) {
+            // cout << "SDN_stat_packet generated" << endl;
+            if (nullptr == p)
+                return packet_generator::generate<SDN_stat_packet>();
+            else
+                return new SDN_stat_packet(p); // duplicate; the payload is shared
+        }
+
+    public:
+        virtual string type() { return "SDN_stat_packet"; }
+        virtual packet_type_id type_id() { return SDN_STAT_PACKET; }
+        ~SDN_stat_packet_generator() {}
+    };
+};
+SDN_stat_packet::SDN_stat_packet_generator SDN_stat_packet::SDN_stat_packet_generator::sample;
+object_pool SDN_stat_packet::pool("SDN_stat_packet", sizeof(SDN_stat_packet));
+
+class SDN_stat_pkt_gen_event : public event {
+public:
+    class pkt_gen_data; // forward declaration
+
+private:
+    SDN_stat_pkt_gen_event(SDN_stat_pkt_gen_event&) {}
+    SDN_stat_pkt_gen_event() {} // we don't allow users to new a recv_event by themselves
+    // this constructor cannot be directly called by users; only by generator
+    unsigned int src; // the src
+    unsigned int dst; // the dst
+    shared_ptr<const map<unsigned int, unsigned int>> LinkWeight; // kept (not moved out) by trigger(), which may run again after a rollback
+    // packet *pkt; // the packet
+    message msg;
+
+protected:
+    SDN_stat_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
+        pkt_gen_data* data_ptr = (pkt_gen_data*)data;
+        src = data_ptr->src_id;
+        dst = data_ptr->dst_id;
+        LinkWeight = make_shared<const map<unsigned int, unsigned int>>(data_ptr->LinkWeight);
+        msg = data_ptr->msg;
+    }
+    // the typed constructor; see event_generator::generate<T>()
+    SDN_stat_pkt_gen_event(unsigned int _trigger_time, pkt_gen_data&& data) : event(_trigger_time), src(data.src_id), dst(data.dst_id) {
+        LinkWeight = make_shared<const map<unsigned int, unsigned int>>(move(data.LinkWeight)); // the adjacency is built once and shared from here on
+        msg = move(data.msg);
+    }
+
+public:
+    virtual ~SDN_stat_pkt_gen_event() {}
+    POOLED_NEW_DELETE
+    // SDN_stat_pkt_gen_event will trigger the packet gen function
+    virtual void trigger();
+
+    unsigned int event_priority() const;
+    event_type_id type_id() const { return SDN_STAT_PKT_GEN_EVENT; }
+    unsigned int owner() const { return src; } // the packet starts from src
+    unsigned int packet_num() const { return 1; }
+    packet_type_id packet_type() const { return SDN_STAT_PACKET; }
+
+    class SDN_stat_pkt_gen_event_generator;
+    friend class SDN_stat_pkt_gen_event_generator;
+    friend class event::event_generator; // for the typed factory
+    // SDN_stat_pkt_gen_event_generator is derived from event_generator to generate an event
+    class SDN_stat_pkt_gen_event_generator : public event_generator {
+        static SDN_stat_pkt_gen_event_generator sample;
+        // this constructor is only for sample to register this event type
+        SDN_stat_pkt_gen_event_generator() { /*cout << "send_event registered" << endl;*/
+            register_event_type(&sample);
+        }
+
+    protected:
+        virtual event* generate(unsigned int _trigger_time, void* data) {
+            // cout << "send_event generated" << endl;
+            return new SDN_stat_pkt_gen_event(_trigger_time, data);
+        }
+
+    public:
+        virtual string type() { return "SDN_stat_pkt_gen_event"; }
+        virtual event_type_id type_id() { return SDN_STAT_PKT_GEN_EVENT; }
+        ~SDN_stat_pkt_gen_event_generator() {}
+    };
+    // this class is used to initialize the SDN_stat_pkt_gen_event
+    class pkt_gen_data {
+    public:
+        unsigned int src_id; // the controller
+        unsigned int dst_id; // the node that should update its rule
+        map<unsigned int, unsigned int> LinkWeight;
+        message msg;
+        // packet *_pkt;
+
+        pkt_gen_data() = default;
+        pkt_gen_data(pkt_gen_data&&) = default; // moved into the event, never copied
+        pkt_gen_data& operator=(pkt_gen_data&&) = default;
+    };
+
+    void print() const;
+};
+SDN_stat_pkt_gen_event::SDN_stat_pkt_gen_event_generator SDN_stat_pkt_gen_event::SDN_stat_pkt_gen_event_generator::sample;
+object_pool SDN_stat_pkt_gen_event::pool("SDN_stat_pkt_gen_event", sizeof(SDN_stat_pkt_gen_event));
+void SDN_stat_pkt_gen_event::trigger() {
+    if (dst == BROCAST_ID || node::id_to_node(dst) == nullptr) {
+        cerr << "SDN_stat_pkt_gen_event error: no node " << dst << "!" << endl;
+        return;
+    }
+
+    SDN_stat_packet* pkt = packet::packet_generator::generate<SDN_stat_packet>();
+    if (pkt == nullptr) {
+        cerr << "packet type is incorrect" << endl;
+        return;
+    }
+    SDN_stat_header* hdr = dynamic_cast<SDN_stat_header*>(pkt->getHeader());
+    SDN_stat_payload* pld = dynamic_cast<SDN_stat_payload*>(pkt->getMutablePayload());
+
+    if (hdr == nullptr) {
+        cerr << "header type is incorrect" << endl;
+        return;
+    }
+    if (pld == nullptr) {
+        cerr << "payload type is incorrect" << endl;
+        return;
+    }
+
+    hdr->setSrcID(src);
+    hdr->setDstID(dst);
+    hdr->setPreID(src);
+    hdr->setNexID(src); // in hw3, you should set NexID to src
+    // payload
+    pld->setMsg(msg);
+    pld->setLinkWeight(LinkWeight);
+
+    recv_event::recv_data e_data;
+    e_data.s_id = src;
+    e_data.r_id = src; // in hw3, you should set r_id it src
+    e_data._pkt = pkt;
+
+    recv_event* e = event::event_generator::generate<recv_event>(trigger_time, move(e_data));
+}
+unsigned int SDN_stat_pkt_gen_event::event_priority() const {
+    return get_hash_value({getTriggerTime(), src, dst});
+}
+// the SDN_stat_pkt_gen_event::print() function is used for log file
+void SDN_stat_pkt_gen_event::print() const {
+    trace::record r = {event::getCurTime(), trace::GEN, SDN_STAT_PACKET, 0, {src, dst}};
+    trace::write(r);
+}
+// LinkWeight is moved through the event into the payload, so pass it with move() when it is not needed afterwards
+void stat_packet_event(unsigned int src_id, unsigned int dst_id, map<unsigned int, unsigned int> LinkWeight, unsigned int t = event::getCurTime(), message msg = message::DEFAULT) {
+    // void stat_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
+    if (dst_id == BROCAST_ID || node::id_to_node(dst_id) == nullptr) {
+        cerr << "dst_id is incorrect" << endl;
+        return;
+    }
+
+    unsigned int src = src_id;
+    SDN_stat_pkt_gen_event::pkt_gen_data e_data;
+    e_data.src_id = src_id;
+    e_data.dst_id = dst_id;
+    e_data.LinkWeight = move(LinkWeight);
+    e_data.msg = move(msg);
+
+    SDN_stat_pkt_gen_event* e = event::event_generator::generate<SDN_stat_pkt_gen_event>(t, move(e_data));
+    if (e == nullptr)
+        cerr << "event type is incorrect" << endl;
+}
+/////////////////////////////////////////////
+
+// the data_packet_event function is used to add an initial event
+void data_packet_event(unsigned int src, unsigned int dst, unsigned int t = 0, message msg = message::DEFAULT) {
+    if (node::id_to_node(src) == nullptr || (dst != BROCAST_ID && node::id_to_node(dst) == nullptr)) {
+        cerr << "src or dst is incorrect" << endl;
+        return;
+        return;
+    }
+
+    SDN_data_pkt_gen_event::pkt_gen_data e_data;
+    e_data.src_id = src;
+    e_data.dst_id = dst;
+    e_data.msg = msg;
+
+    // recv_event *e = dynamic_cast<recv_event*> ( event::event_generator::generate("recv_event",t, (void *)&e_data) );
+    SDN_data_pkt_gen_event* e = event::event_generator::generate<SDN_data_pkt_gen_event>(t, move(e_data));
+    if (e == nullptr)
+        cerr << "event type is incorrect" << endl;
+}
+
+// a data packet of the input: it is sent from src to dst at time
+struct flow {
+    unsigned int time;
+    unsigned int src;
+    unsigned int dst;
+};
+
+// the bulk version of data_packet_event: the events of all flows are built in one pass without the string lookup of the
+// event type, and the scheduler takes them at once (the heap is built in O(n) instead of n pushes)
+void data_packet_events(const flow* flows, size_t flow_num, vector<event*>& es, message msg = message::DEFAULT) {
+    if (es.empty())
+        es.reserve(flow_num); // a non-empty es grows geometrically, since main appends chunk after chunk
+    for (size_t i = 0; i < flow_num; i++) {
+        if (node::id_to_node(flows[i].src) == nullptr || (flows[i].dst != BROCAST_ID && node::id_to_node(flows[i].dst) == nullptr)) {
+            cerr << "src or dst is incorrect" << endl;
+            continue;
+        }
+        SDN_data_pkt_gen_event::pkt_gen_data e_data; // moved into each event
+        e_data.src_id = flows[i].src;
+        e_data.dst_id = flows[i].dst;
+        e_data.msg = msg;
+        es.push_back(event::event_generator::create<SDN_data_pkt_gen_event>(flows[i].time, move(e_data)));
+    }
+}
+void data_packet_events(const vector<flow>& flows, vector<event*>& es, message msg = message::DEFAULT) {
+    data_packet_events(flows.data(), flows.size(), es, msg);
+}
+// the events are added to the scheduler
+void data_packet_events(const vector<flow>& flows, message msg = message::DEFAULT) {
+    vector<event*> es;
+    data_packet_events(flows, es, msg);
+    event::add_events(es);
+}
+
+// compare the time to load flow_num random flows by data_packet_event() and by data_packet_events() with each scheduler
+// the benchmark generates the nodes 0 to 1023 if they do not exist
+void benchmark_load(unsigned int flow_num) {
+    const unsigned int NODE_NUM = 1024;
+    for (unsigned int id = 0; id < NODE_NUM; id++) {
+        if (node::id_to_node(id) == nullptr)
+            node::node_generator::generate("SDN_switch", id);
+    }
+    mt19937 rng(0); // fixed seed; every run loads the same flows
+    vector<flow> flows(flow_num);
+    for (unsigned int i = 0; i < flow_num; i++) {
+        flows[i].time = rng() % 100000;
+        flows[i].src = rng() % NODE_NUM;
+        flows[i].dst = rng() % NODE_NUM;
+    }
+
+    data_packet_events(flows); // warm up the memory allocator, so that the first measurement does not pay for the page faults
+    event::clear_events();
+
+    string types[2] = {"heap_scheduler", "calendar_scheduler"};
+    for (unsigned int t = 0; t < 2; t++) {
+        if (!event::set_scheduler(types[t]))
+            continue;
+        for (unsigned int bulk = 0; bulk < 2; bulk++) {
+            chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+            if (bulk)
+                data_packet_events(flows);
+            else {
+                for (unsigned int i = 0; i < flow_num; i++)
+                    data_packet_event(flows[i].src, flows[i].dst, flows[i].time);
+            }
+            double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            cout << setw(20) << types[t] << ": " << flow_num << " flows loaded " << (bulk ? "at once    " : "one by one") << " in "
+                 << fixed << setprecision(3) << sec << " s" << endl;
+            cout.unsetf(ios::fixed);
+            event::clear_events();
+        }
+    }
+}
+
+// the ctrl_packet_event function is used to add an initial event
+void ctrl_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), message msg = message::DEFAULT) {
+    // void ctrl_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
+    if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
+        cerr << "id is incorrect" << endl;
+        return;
+    }
+
+    unsigned int src = con_id;
+    SDN_ctrl_pkt_gen_event::pkt_gen_data e_data;
+    e_data.src_id = src;
+    e_data.dst_id = id;
+    e_data.mat_id = mat;
+    e_data.act_id = act;
+    e_data.msg = msg;
+
+    SDN_ctrl_pkt_gen_event* e = event::event_generator::generate<SDN_ctrl_pkt_gen_event>(t, move(e_data));
+    if (e == nullptr)
+        cerr << "event type is incorrect" << endl;
+}
+
+// send_handler function is used to transmit packet p based on the information in the header
+// Note that the packet p will not be discard after send_handler ()
+// p is shared with the send_event instead of being copied, so p should not be modified after send_handler ()
+
+void node::send_handler(packet* p) {
+    packet* _p = packet::retain(p);
+    send_event::send_data e_data;
+    e_data.s_id = _p->getHeader()->getPreID();
+    e_data.r_id = _p->getHeader()->getNexID();
+    e_data._pkt = _p;
+    send_event* e = event::event_generator::generate<send_event>(event::getCurTime(), move(e_data));
+    if (e == nullptr)
+        cerr << "event type is incorrect" << endl;
+}
+
+void node::send(packet* p) { // this function is called by event; not for the user
+    if (p == nullptr)
+        return;
+
+    unsigned int _nexID = p->getHeader()->getNexID();
+    vector<pair<unsigned int, link*>>::iterator it = nb_links.begin();
+    if (BROCAST_ID != _nexID) { // unicast: binary search for the next hop
+        it = lower_bound(nb_links.begin(), nb_links.end(), pair<unsigned int, link*>(_nexID, nullptr),
+                         [](const pair<unsigned int, link*>& a, const pair<unsigned int, link*>& b) { return a.first < b.first; });
+        if (it != nb_links.end() && it->first != _nexID)
+            it = nb_links.end(); // the next hop is not a neighbor
+    }
+    for (; it != nb_links.end(); it++) {
+        unsigned int nb_id = it->first; // neighbor id
+
+        unsigned int trigger_time = event::getCurTime() + it->second->getLatency(); // we simply assume that the delay is fixed
+        // cout << "node " << id << " send to node " <<  nb_id << endl;
+        recv_event::recv_data e_data;
+        e_data.s_id = id;    // set the sender   (i.e., preID)
+        e_data.r_id = nb_id; // set the receiver (i.e., nexID)
+
+        // the receiver changes the header, so every receiver but the last one gets a replica (sharing the payload);
+        // the last receiver takes p itself if nobody else owns it, i.e., a unicast packet is moved without copying
+        bool last = (BROCAST_ID != _nexID || it + 1 == nb_links.end());
+        if (last && p->getRefNum() == 1) {
+            e_data._pkt = p;
+            p = nullptr;
+        }
+        else
+            e_data._pkt = packet::packet_generator::replicate(p);
+
+        recv_event* e = event::event_generator::generate<recv_event>(trigger_time, move(e_data)); // send the packet to the neighbor
+        if (e == nullptr)
+            cerr << "event type is incorrect" << endl;
+        if (last)
+            break;
+    }
+    packet::discard(p);
+}
+
+// you have to write the code in recv_handler of SDN_switch
+void SDN_switch::recv_handler(packet* p) {
+    // in this function, you are "not" allowed to use node::id_to_node(id) !!!!!!!!(getNodeID())
+
+    // this is a simple example
+    // node 0 broadcasts its message to every node and every node relays the packet "only once"
+    // the variable hi is used to examine whether the packet has been received before
+    // you can remove the variable hi and create your own variables in class SDN_switch
+    if (p == nullptr)
+        return;
+
+    // the packet type is checked by its type id, so the static_casts below are safe
+    switch (p->type_id()) {
+    case SDN_DATA_PACKET: { // the switch receives a packet from the other switch
+        // cout << "node " << getNodeID() << " send the packet" << endl;
+        SDN_data_packet* p2 = nullptr;
+        p2 = static_cast<SDN_data_packet*>(p);
+        unsigned int nexID;
+        if (getNodeID() == p2->getHeader()->getDstID())
+            return;
+        if (!routing_table.lookup(p2->getHeader()->getDstID(), nexID))
+            return; // no rule for the destination yet: drop the packet
+        p2->getHeader()->setPreID(getNodeID());
+        p2->getHeader()->setNexID(nexID);
+        //p2->getHeader()->setSrcID(p2->getHeader()->getSrcID());
+        //p2->getHeader()->setDstID(p2->getHeader()->getDstID());
+        send_handler(p2);
+        break;
+    }
+    case SDN_CTRL_NEW_PACKET: { // the switch receives a packet from the controller
+        SDN_ctrl_new_packet* p3 = nullptr;
+        p3 = static_cast<SDN_ctrl_new_packet*>(p);
+        const SDN_ctrl_new_payload* l3 = nullptr;
+        l3 = static_cast<const SDN_ctrl_new_payload*>(p3->getPayload());
+        unsigned mat = l3->getMatID();
+        unsigned act = l3->getActID();
+        bool installed = l3->getRules().empty() ? routing_table.install(mat, act) : routing_table.install(l3->getRules());
+        if (!installed)
+            cerr << "SDN_switch error: node " << getNodeID() << " rejects a rule with BROCAST_ID" << endl;
+        p3->getHeader()->setDstID(p3->getHeader()->getSrcID());
+        p3->getHeader()->setSrcID(getNodeID());
+        p3->getHeader()->setPreID(getNodeID());
+        p3->getHeader()->setNexID(p3->getHeader()->getDstID());
+        send_handler(p3);
+        // message msg = l3->getMsg(); // get the msg; compare it with == (e.g., msg == message::UPDATE)
+        break;
+    }
+    case SDN_STAT_PACKET: {
+        SDN_stat_packet* p4 = nullptr;
+        p4 = static_cast<SDN_stat_packet*>(p);
+        p4->getHeader()->setNexID(p4->getHeader()->getDstID());
+        send_handler(p4);
+        break;
+    }
+    default:
+        break;
+    }
+    // you should implement the SDN's distributed algorithm in recv_handler
+    // getNodeID() returns the id of the current node
+
+    // The current node's neighbors are already stored in the following variable
+    // map<unsigned int,bool> node::
+    // however, this variable is private in the class node
+    // You have to use node::getPhyNeighbors to get the variable
+    // for example, if you want to print all the neighbors of this node
+    // const map<unsigned int,bool> &nblist = getPhyNeighbors();
+    // cout << "node " << getNodeID() << "'s nblist: ";
+    // for (map<unsigned int,bool>::const_iterator it = nblist.begin(); it != nblist.end(); it ++) {
+    //     cout << it->first << ", " ;
+    // }
+    // cout << endl;
+
+    // you can use p->getHeader()->setSrcID() or getSrcID()
+    //             p->getHeader()->setDstID() or getDstID()
+    //             p->getHeader()->setPreID() or getPreID()
+    //             p->getHeader()->setNexID() or getNexID() to change or read the packet header
+
+    // In addition, you can get the packet, header, and payload with the correct type (GR)
+    // in fact, this is downcasting
+    // SDN_data_packet * pkt = dynamic_cast<SDN_data_packet*> (p);
+    // SDN_data_header * hdr = dynamic_cast<SDN_data_header*> (p->getHeader());
+    // SDN_data_payload * pld = dynamic_cast<SDN_data_payload*> (p->getPayload());
+
+    // you can also change the SDN_data_payload setting
+    // pld->setMsg(message): to set the message transmitted to the destination; a string is converted to a message
+
+    // Besides, you can use packet::packet_generator::generate() to generate a new packet; note that you should fill the header and payload in the packet
+    // moreover, you can use "packet *p2 = packet::packet_generator::replicate(p)" to make a clone p2 of packet p
+    // note that if the packet is generated or replicated manually, you must delete it by packet::discard() manually before recv_handler finishes
+
+    // "IMPORTANT":
+    // You have to "carefully" fill the correct information (e.g., srcID, dstID, ...) in the packet before you send it
+    // Note that if you want to transmit a packet to only one next node (i.e., unicast), then you fill the ID of a specific node to "nexID" in the header
+    // Otherwise, i.e., you want to broadcasts, then you fill "BROCAST_ID" to "nexID" in the header
+    // after that, you can use send() to transmit the packet
+    // usage: send_handler (p);
+
+    // note that packet p will be discarded (deleted) after recv_handler(); you don't need to manually delete it
+}
+
+void SDN_controller::recv_handler(packet* p) {
+
+    if (p == nullptr)
+        return;
+
+    switch (p->type_id()) {
+    case SDN_CTRL_NEW_PACKET: {
+        SDN_ctrl_new_packet* p5 = nullptr;
+        p5 = static_cast<SDN_ctrl_new_packet*>(p);
+        if (p5->getHeader()->getSrcID() == getNodeID()) {
+            p5->getHeader()->setNexID(p5->getHeader()->getDstID());
+            send_handler(p5);
+        }
+        break;
+    }
+    case SDN_STAT_PACKET:
+        break;
+    default:
+        break;
+    }
+}
+
+// reads the unsigned integers of the input; a regular file is memory-mapped and scanned in place, and any other input
+// (e.g. a pipe) is read block by block, so the input is never copied into a string or parsed through the locale of cin.
+// every character which is not a digit separates two integers
+class input_scanner {
+private:
+    static const size_t BLOCK_SIZE = 1 << 16; // bytes per read() when the input cannot be mapped
+    static const size_t MAX_DIGITS = 20; // an integer is never split by the end of the block
+
+    FILE* file;
+    bool own_file; // the file is opened by the scanner
+    char* mapped;
+    size_t map_size;
+    vector<char> block;
+    const char* cur;
+    const char* end;
+    bool eof; // no more bytes after end
+    bool failed;
+
+    // move the unread bytes to the front of the block and read more after them; returns false if nothing is read
+    bool refill() {
+        if (eof)
+            return false;
+        size_t rest = end - cur;
+        memmove(block.data(), cur, rest);
+        size_t n = fread(block.data() + rest, 1, block.size() - rest, file);
+        if (n == 0)
+            eof = true;
+        cur = block.data();
+        end = block.data() + rest + n;
+        return n > 0;
+    }
+
+public:
+    // file_name "" means stdin
+    input_scanner(string file_name = "") : file(stdin), own_file(false), mapped(nullptr), map_size(0), cur(nullptr), end(nullptr), eof(false), failed(false) {
+        if (file_name != "") {
+            file = fopen(file_name.c_str(), "rb");
+            own_file = true;
+            if (file == nullptr) {
+                cerr << "cannot open " << file_name << endl;
+                failed = eof = true;
+                return;
+            }
+        }
+        struct stat st;
+        if (fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            off_t offset = ftello(file); // stdin may be partly read already
+            if (offset >= 0 && offset < st.st_size) {
+                void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+                if (m != MAP_FAILED) {
+                    madvise(m, st.st_size, MADV_SEQUENTIAL);
+                    mapped = (char*)m;
+                    map_size = st.st_size;
+                    cur = mapped + offset;
+                    end = mapped + map_size;
+                    eof = true;
+                    return;
+                }
+            }
+        }
+        block.resize(BLOCK_SIZE);
+        cur = end = block.data();
+    }
+    ~input_scanner() {
+        if (mapped != nullptr)
+            munmap(mapped, map_size);
+        if (own_file && file != nullptr)
+            fclose(file);
+    }
+    input_scanner(const input_scanner&) = delete;
+    input_scanner& operator=(const input_scanner&) = delete;
+
+    // the scanner can go back to a position (got by tell()) only if the input is mapped
+    bool rewindable() const { return mapped != nullptr; }
+    const char* tell() const { return cur; }
+    void seek(const char* pos) {
+        cur = pos;
+        failed = false;
+    }
+
+    // like cin >> v: the scanner fails if there is no integer left, and then every later read fails as well
+    input_scanner& operator>>(unsigned int& v) {
+        if (failed)
+            return *this;
+        while (true) {
+            while (cur < end && (unsigned char)(*cur - '0') > 9)
+                cur++;
+            if (cur < end && (eof || (size_t)(end - cur) > MAX_DIGITS))
+                break;
+            if (!refill() && cur == end) {
+                failed = true;
+                return *this;
+            }
+        }
+        unsigned int x = 0;
+        while (cur < end && (unsigned char)(*cur - '0') <= 9)
+            x = x * 10 + (*cur++ - '0');
+        v = x;
+        return *this;
+    }
+    explicit operator bool() const { return !failed; }
+};
+
+// the data packets of the input as a traffic source; the flows must be sorted by time (see sorted())
+class flow_source : public traffic_source {
+private:
+    input_scanner& in;
+    message msg;
+    flow next; // the flow read ahead
+    bool has_next;
+    vector<flow> flows; // the flows of the window being pulled
+
+    void read() { has_next = (bool)(in >> next.time >> next.src >> next.dst); }
+
+public:
+    flow_source(input_scanner& _in, message _msg = message::DEFAULT) : in(_in), msg(_msg) { read(); }
+    unsigned long long next_time() { return has_next ? next.time : ULLONG_MAX; }
+    void pull(unsigned long long end, vector<event*>& es) {
+        flows.clear();
+        while (has_next && next.time < end) {
+            flows.push_back(next);
+            read();
+        }
+        data_packet_events(flows, es, msg);
+    }
+    // whether the flows left in the input are sorted by time; they are scanned once and the input goes back to them.
+    // an input which cannot be scanned twice (e.g., a pipe) is taken as unsorted
+    static bool sorted(input_scanner& in) {
+        if (!in.rewindable())
+            return false;
+        const char* begin = in.tell();
+        unsigned int last = 0, t, src, dst;
+        bool ordered = true;
+        while (ordered && in >> t >> src >> dst) {
+            ordered = (last <= t);
+            last = t;
+        }
+        in.seek(begin);
+        return ordered;
+    }
+};
+
+// a binary snapshot of an input: the scalars, the old path, the weighted links in the CSR form and the flows sorted by time.
+// the file is written by convert() and mapped read-only by open(), so a run starts without parsing the text input.
+// the numbers are stored in the native byte order; every section begins at a multiple of 8 bytes
+class snapshot {
+public:
+    static const unsigned int VERSION = 1;
+    struct header {
+        char magic[4]; // "SDNS"
+        unsigned int version;
+        unsigned int node_num, node_cost;
+        unsigned int ins_time, upd_time, sim_duration;
+        unsigned int source, dest, old_path_len;
+        unsigned long long adj_num; // the entries of the adjacency; a link is stored at both of its nodes
+        unsigned long long flow_num;
+        // the byte offsets of the sections
+        unsigned long long old_path_offset; // old_path_len edges in the input order
+        unsigned long long index_offset;    // node_num + 1 entries: the links of node i are the entries index[i] to index[i + 1] - 1
+        unsigned long long neighbor_offset; // adj_num node ids, sorted for each node
+        unsigned long long weight_offset;   // adj_num weights
+        unsigned long long flow_offset;     // flow_num flows sorted by time
+    };
+    struct edge {
+        unsigned int node1;
+        unsigned int node2;
+    };
+
+private:
+    char* mapped;
+    size_t map_size;
+
+    template <typename T>
+    const T* section(unsigned long long offset) const { return (const T*)(mapped + offset); }
+    static unsigned long long align(unsigned long long offset) { return (offset + 7) / 8 * 8; }
+
+public:
+    snapshot() : mapped(nullptr), map_size(0) {}
+    ~snapshot() {
+        if (mapped != nullptr)
+            munmap(mapped, map_size);
+    }
+    snapshot(const snapshot&) = delete;
+    snapshot& operator=(const snapshot&) = delete;
+
+    // convert the text input to a snapshot file; returns false if the input is incorrect or the file cannot be written
+    static bool convert(input_scanner& in, string file_name);
+    // map the snapshot file; returns false if it is not a snapshot of this version
+    bool open(string file_name);
+    bool is_open() const { return mapped != nullptr; }
+
+    const header& get_header() const { return *section<header>(0); }
+    const edge* old_path() const { return section<edge>(get_header().old_path_offset); }
+    const unsigned long long* index() const { return section<unsigned long long>(get_header().index_offset); }
+    const unsigned int* neighbors() const { return section<unsigned int>(get_header().neighbor_offset); }
+    const unsigned int* weights() const { return section<unsigned int>(get_header().weight_offset); }
+    const flow* flows() const { return section<flow>(get_header().flow_offset); }
+};
+
+bool snapshot::convert(input_scanner& in, string file_name) {
+    header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "SDNS", 4);
+    h.version = VERSION;
+    in >> h.node_num >> h.node_cost >> h.ins_time >> h.upd_time >> h.sim_duration >> h.source >> h.dest >> h.old_path_len;
+    vector<edge> old_path(h.old_path_len);
+    for (unsigned int i = 0; i < h.old_path_len; i++) {
+        unsigned int link_id;
+        in >> link_id >> old_path[i].node1 >> old_path[i].node2;
+        if (in && (old_path[i].node1 >= h.node_num || old_path[i].node2 >= h.node_num)) {
+            cerr << "the old path has a node out of range" << endl;
+            return false;
+        }
+    }
+    // the same as main() reading the text: a later weight of a link replaces the earlier one
+    unsigned int list_num = 0;
+    in >> list_num;
+    vector<map<unsigned int, unsigned int>> link_weight(in ? h.node_num : 0);
+    for (unsigned int i = 0; i < list_num && in; i++) {
+        unsigned int link_id, node1, node2, weight;
+        in >> link_id >> node1 >> node2 >> weight;
+        if (in && (node1 >= h.node_num || node2 >= h.node_num)) {
+            cerr << "the link list has a node out of range" << endl;
+            return false;
+        }
+        link_weight[node1][node2] = weight;
+        link_weight[node2][node1] = weight;
+    }
+    if (!in) {
+        cerr << "the input is incomplete" << endl;
+        return false;
+    }
+    vector<flow> flow_list;
+    flow f;
+    while (in >> f.time >> f.src >> f.dst)
+        flow_list.push_back(f);
+    // the sort is stable: the flows of the same time keep their order, and so do the sequence numbers of their events,
+    // which order the events of the same time and hash (see event_key); hence the trace is the same
+    stable_sort(flow_list.begin(), flow_list.end(), [](const flow& a, const flow& b) { return a.time < b.time; });
+
+    vector<unsigned long long> index(h.node_num + 1, 0);
+    vector<unsigned int> neighbor, weight;
+    for (unsigned int id = 0; id < h.node_num; id++) {
+        for (map<unsigned int, unsigned int>::iterator it = link_weight[id].begin(); it != link_weight[id].end(); it++) {
+            neighbor.push_back(it->first);
+            weight.push_back(it->second);
+        }
+        index[id + 1] = neighbor.size();
+    }
+    h.adj_num = neighbor.size();
+    h.flow_num = flow_list.size();
+    h.old_path_offset = align(sizeof(header));
+    h.index_offset = align(h.old_path_offset + old_path.size() * sizeof(edge));
+    h.neighbor_offset = align(h.index_offset + index.size() * sizeof(unsigned long long));
+    h.weight_offset = align(h.neighbor_offset + neighbor.size() * sizeof(unsigned int));
+    h.flow_offset = align(h.weight_offset + weight.size() * sizeof(unsigned int));
+
+    FILE* out = fopen(file_name.c_str(), "wb");
+    if (out == nullptr) {
+        cerr << "cannot open " << file_name << endl;
+        return false;
+    }
+    unsigned long long at = 0;
+    const char zero[8] = {0};
+    // write a section at offset (after the padding from the end of the previous one)
+    auto write = [&](unsigned long long offset, const void* data, size_t size) {
+        fwrite(zero, 1, offset - at, out);
+        fwrite(data, 1, size, out);
+        at = offset + size;
+    };
+    write(0, &h, sizeof(h));
+    write(h.old_path_offset, old_path.data(), old_path.size() * sizeof(edge));
+    write(h.index_offset, index.data(), index.size() * sizeof(unsigned long long));
+    write(h.neighbor_offset, neighbor.data(), neighbor.size() * sizeof(unsigned int));
+    write(h.weight_offset, weight.data(), weight.size() * sizeof(unsigned int));
+    write(h.flow_offset, flow_list.data(), flow_list.size() * sizeof(flow));
+    bool ok = (ferror(out) == 0);
+    if (fclose(out) != 0 || !ok) {
+        cerr << "cannot write " << file_name << endl;
+        return false;
+    }
+    return true;
+}
+
+bool snapshot::open(string file_name) {
+    FILE* in = fopen(file_name.c_str(), "rb");
+    if (in == nullptr) {
+        cerr << "cannot open " << file_name << endl;
+        return false;
+    }
+    struct stat st;
+    void* m = MAP_FAILED;
+    if (fstat(fileno(in), &st) == 0 && st.st_size >= (off_t)sizeof(header))
+        m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(in), 0);
+    fclose(in); // the mapping stays after the file is closed
+    if (m == MAP_FAILED) {
+        cerr << file_name << " is not a snapshot" << endl;
+        return false;
+    }
+    mapped = (char*)m;
+    map_size = st.st_size;
+
+    // only the sizes are checked; the content is trusted as it is written by convert()
+    const header& h = get_header();
+    bool ok = memcmp(h.magic, "SDNS", 4) == 0 && h.version == VERSION && h.old_path_offset >= sizeof(header)
+              && h.old_path_offset + h.old_path_len * sizeof(edge) <= h.index_offset
+              && h.index_offset + (h.node_num + 1ULL) * sizeof(unsigned long long) <= h.neighbor_offset
+              && h.neighbor_offset + h.adj_num * sizeof(unsigned int) <= h.weight_offset
+              && h.weight_offset + h.adj_num * sizeof(unsigned int) <= h.flow_offset
+              && h.flow_offset + h.flow_num * sizeof(flow) <= map_size;
+    if (!ok || index()[h.node_num] != h.adj_num) {
+        cerr << file_name << " is not a snapshot of version " << VERSION << endl;
+        munmap(mapped, map_size);
+        mapped = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// the flows of a snapshot as a traffic source; they are used in place
+class snapshot_source : public traffic_source {
+private:
+    const flow* flows;
+    size_t flow_num;
+    size_t at; // the next flow
+    message msg;
+
+public:
+    snapshot_source(const snapshot& snap, message _msg = message::DEFAULT)
+        : flows(snap.flows()), flow_num(snap.get_header().flow_num), at(0), msg(_msg) {}
+    unsigned long long next_time() { return at < flow_num ? flows[at].time : ULLONG_MAX; }
+    void pull(unsigned long long end, vector<event*>& es) {
+        size_t from = at;
+        while (at < flow_num && flows[at].time < end)
+            at++;
+        data_packet_events(flows + from, at - from, es, msg);
+    }
+};
+
+// the links of a synthetic topology of node_num switches; returns false if the type is unknown
+// ring; grid (the side is the square root of node_num, rounded up); fat_tree (k-ary, with the smallest even k that has
+// node_num switches; node_num is rounded up to 5k^2/4); random (Erdos-Renyi with 2 * node_num links);
+// scale_free (Barabasi-Albert: each new switch links to 2 switches chosen in proportion to their degrees)
+bool synthetic_topology(string type, unsigned int& node_num, vector<pair<unsigned int, unsigned int>>& links, mt19937& rng) {
+    links.clear();
+    if (type == "ring") {
+        for (unsigned int i = 0; i < node_num && node_num > 1; i++)
+            links.push_back(make_pair(i, (i + 1) % node_num));
+    }
+    else if (type == "grid") {
+        unsigned int side = 1;
+        while (side * side < node_num)
+            side++;
+        for (unsigned int i = 0; i < node_num; i++) {
+            if ((i + 1) % side != 0 && i + 1 < node_num)
+                links.push_back(make_pair(i, i + 1));
+            if (i + side < node_num)
+                links.push_back(make_pair(i, i + side));
+        }
+    }
+    else if (type == "fat_tree") {
+        unsigned int k = 2;
+        while (5 * k * k / 4 < node_num)
+            k += 2;
+        unsigned int half = k / 2, core_num = half * half;
+        node_num = 5 * k * k / 4;
+        // the ids: the core switches, then the aggregation switches and the edge switches of each pod
+        for (unsigned int pod = 0; pod < k; pod++) {
+            unsigned int agg = core_num + pod * k, edge = agg + half;
+            for (unsigned int a = 0; a < half; a++) {
+                for (unsigned int c = 0; c < half; c++)
+                    links.push_back(make_pair(agg + a, a * half + c));
+                for (unsigned int e = 0; e < half; e++)
+                    links.push_back(make_pair(agg + a, edge + e));
+            }
+        }
+    }
+    else if (type == "random") {
+        for (unsigned int i = 0; i < 2 * node_num && node_num > 1; i++) {
+            unsigned int a = rng() % node_num, b = rng() % node_num;
+            if (a != b)
+                links.push_back(make_pair(a, b));
+        }
+    }
+    else if (type == "scale_free") {
+        vector<unsigned int> ends; // a switch appears once per link, so a uniform pick is in proportion to the degree
+        for (unsigned int i = 0; i < node_num && i < 3; i++) {
+            for (unsigned int j = 0; j < i; j++) {
+                links.push_back(make_pair(i, j));
+                ends.push_back(i);
+                ends.push_back(j);
+            }
+        }
+        for (unsigned int i = 3; i < node_num; i++) {
+            unsigned int a = ends[rng() % ends.size()], b = a;
+            while (b == a)
+                b = ends[rng() % ends.size()];
+            links.push_back(make_pair(i, a));
+            links.push_back(make_pair(i, b));
+            ends.push_back(i);
+            ends.push_back(a);
+            ends.push_back(i);
+            ends.push_back(b);
+        }
+    }
+    else {
+        cerr << "no such topology type" << endl;
+        return false;
+    }
+    return true;
+}
+
+// rate data packets per time unit from random switches to dst, from time begin to end - 1; made on demand
+class synthetic_source : public traffic_source {
+private:
+    mt19937 rng;
+    unsigned int node_num, dst, rate;
+    unsigned long long time, end;
+    vector<flow> flows; // the flows of the window being pulled
+
+public:
+    synthetic_source(unsigned int _node_num, unsigned int _dst, unsigned int _rate, unsigned int begin, unsigned int _end)
+        : rng(1), node_num(_node_num), dst(_dst), rate(_rate), time(begin), end(_rate > 0 ? _end : begin) {}
+    unsigned long long next_time() { return time < end ? time : ULLONG_MAX; }
+    void pull(unsigned long long before, vector<event*>& es) {
+        flows.clear();
+        for (; time < end && time < before; time++) {
+            for (unsigned int i = 0; i < rate; i++)
+                flows.push_back(flow{(unsigned int)time, (unsigned int)(rng() % node_num), dst});
+        }
+        data_packet_events(flows, es);
+    }
+};
+
+// run a synthetic scenario with the scheduler and the engine selected, and print its measurements as one JSON line
+// spec is topology[:node_num[:rate[:duration]]] (1024 switches, 16 packets per time unit and 1000 time units by default);
+// as in the input, the controller installs the rules toward switch 0 (along a BFS tree of the links) and gets the link
+// weights of every switch, then the switches send data packets to switch 0 until all of them arrive
+bool benchmark_simulation(string spec) {
+    string topology = spec;
+    unsigned int param[3] = {1024, 16, 1000}; // node_num, rate, duration
+    size_t at = spec.find(':');
+    if (at != string::npos) {
+        topology = spec.substr(0, at);
+        for (unsigned int i = 0; i < 3 && at != string::npos; i++) {
+            size_t next = spec.find(':', at + 1);
+            unsigned long value;
+            try {
+                value = stoul(spec.substr(at + 1, next == string::npos ? string::npos : next - at - 1));
+            }
+            catch (const exception&) { // not a number
+                value = ULONG_MAX;
+            }
+            if (value > UINT_MAX) {
+                cerr << "usage: -g topology[:node_num[:rate[:duration]]] (the numbers are unsigned int)" << endl;
+                return false;
+            }
+            param[i] = value;
+            at = next;
+        }
+    }
+    unsigned int node_num = param[0], rate = param[1], duration = param[2];
+    const unsigned int INS_TIME = 0, UPD_TIME = ONE_HOP_DELAY, DATA_TIME = 10 * ONE_HOP_DELAY, DST = 0;
+
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    mt19937 rng(0); // fixed seed; every run builds the same topology
+    vector<pair<unsigned int, unsigned int>> links;
+    if (node_num == 0 || !synthetic_topology(topology, node_num, links, rng))
+        return false;
+    for (unsigned int id = 0; id < node_num; id++)
+        node::node_generator::generate("SDN_switch", id);
+    unsigned int con_id = node::getNodeNum();
+    node::node_generator::generate("SDN_controller", con_id);
+    for (unsigned int i = 0; i < node_num; i++) {
+        node::id_to_node(i)->add_phy_neighbor(con_id);
+        node::id_to_node(con_id)->add_phy_neighbor(i);
+    }
+    vector<vector<unsigned int>> adj(node_num);
+    vector<map<unsigned int, unsigned int>> link_weight(node_num);
+    for (size_t i = 0; i < links.size(); i++) {
+        unsigned int a = links[i].first, b = links[i].second, weight = 1 + rng() % 9;
+        node::id_to_node(a)->add_phy_neighbor(b);
+        node::id_to_node(b)->add_phy_neighbor(a);
+        adj[a].push_back(b);
+        adj[b].push_back(a);
+        link_weight[a][b] = link_weight[b][a] = weight;
+    }
+
+    // the rules toward DST follow a BFS tree; the switches which cannot reach DST get no rule and drop their packets
+    vector<unsigned int> parent(node_num, UINT_MAX), depth(node_num, 0);
+    vector<unsigned int> bfs(1, DST);
+    parent[DST] = DST;
+    for (size_t i = 0; i < bfs.size(); i++) {
+        for (size_t j = 0; j < adj[bfs[i]].size(); j++) {
+            unsigned int nb = adj[bfs[i]][j];
+            if (parent[nb] == UINT_MAX) {
+                parent[nb] = bfs[i];
+                depth[nb] = depth[bfs[i]] + 1;
+                bfs.push_back(nb);
+            }
+        }
+    }
+    for (unsigned int id = 0; id < node_num; id++) {
+        if (id != DST && parent[id] != UINT_MAX)
+            ctrl_new_packet_event(con_id, id, DST, parent[id], INS_TIME);
+        stat_packet_event(id, con_id, move(link_weight[id]), UPD_TIME);
+    }
+    synthetic_source traffic(node_num, DST, rate, DATA_TIME, DATA_TIME + duration);
+    event::set_traffic(&traffic);
+    unsigned int end_time = DATA_TIME + duration + (depth[bfs.back()] + 1) * ONE_HOP_DELAY;
+    double setup_sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+#ifdef HEAP_COUNT
+    unsigned long long heap_new_begin = heap_alloc_num.load();
+#endif
+    begin = chrono::steady_clock::now();
+    event::start_simulate(end_time);
+    double run_sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    event::set_traffic(nullptr);
+    trace::close();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    unsigned long long pool_new, pool_slab, pool_live;
+    object_pool::count(pool_new, pool_slab, pool_live);
+    unsigned long long run_num = event::getRunNum();
+    cout << "{\"topology\": \"" << topology << "\", \"nodes\": " << node_num << ", \"links\": " << links.size()
+         << ", \"flows\": " << (unsigned long long)rate * duration << ", \"scheduler\": \"" << event::scheduler_type()
+         << "\", \"engine\": \"" << event::engine_type() << "\", \"threads\": " << event::getThreadNum()
+         << fixed << setprecision(6) << ", \"setup_sec\": " << setup_sec << ", \"run_sec\": " << run_sec
+         << ", \"events\": " << run_num << setprecision(0) << ", \"events_per_sec\": " << (run_sec > 0 ? run_num / run_sec : 0)
+         << setprecision(2) << ", \"ns_per_event\": " << (run_num > 0 ? run_sec * 1e9 / run_num : 0)
+         << ", \"peak_rss_kb\": " << usage.ru_maxrss << ", \"live_packets\": " << packet::getLivePacketNum()
+#ifdef HEAP_COUNT
+         << ", \"run_heap_new\": " << heap_alloc_num.load() - heap_new_begin
+#else
+         << ", \"run_heap_new\": null" // not counted without -DHEAP_COUNT
+#endif
+         << ", \"pool_new\": " << pool_new << ", \"pool_slabs\": " << pool_slab
+         << ", \"pool_live\": " << pool_live << "}" << endl;
+    cout.unsetf(ios::fixed);
+    return true;
+}
+
+class neightbor {
+public:
+    map<unsigned int, unsigned int> linkWeight;
+};
+
+// parse the number of an option as -g does; false with the usage of the option if it is not an unsigned int
+bool parse_option(const char* arg, unsigned int& value, const char* usage) {
+    unsigned long v;
+    try {
+        v = stoul(arg);
+    }
+    catch (const exception&) { // not a number
+        v = ULONG_MAX;
+    }
+    if (v > UINT_MAX) {
+        cerr << "usage: " << usage << " (an unsigned int)" << endl;
+        return false;
+    }
+    value = v;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    // usage: ./final2 [-i input_file | -m snapshot_file] [-c snapshot_file] [-s scheduler_type] [-j thread_num] [-e engine_type] [-b event_num] [-l flow_num] [-g benchmark_spec] [-p] [-t trace_mode] [-o trace_file] [-r trace_file] < input
+    // -i: read the input from input_file instead of stdin
+    // -m: read the input from snapshot_file, a binary snapshot written by -c
+    // -c: convert the text input to snapshot_file, then exit
+    // -s: the scheduler backend of the simulation, heap_scheduler (default) or calendar_scheduler
+    // -j: run the simulation with the parallel engine of thread_num threads; the result is the same as with one thread
+    // -e: the parallel engine, conservative (default) or optimistic
+    // -b: compare the events/sec of the scheduler backends with event_num pending events, then exit
+    // -l: compare the time to load flow_num data packets one by one and at once, then exit
+    // -g: run a synthetic benchmark instead of the input and print its measurements in JSON, then exit; the spec is
+    //     topology[:node_num[:rate[:duration]]] with topology ring, grid, fat_tree, random or scale_free;
+    //     the trace is off unless -t is given
+    // -p: print the object pool statistics after the simulation
+    // -t: the trace mode, text (default), binary or none
+    // -o: the file of the binary trace (trace.bin by default)
+    // -r: render the binary trace_file in the text format, then exit
+    bool print_pool = false;
+    string trace_mode = "", trace_file = "trace.bin", input_file = "", snapshot_file = "", convert_file = "", benchmark_spec = "";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            input_file = argv[++i];
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+            snapshot_file = argv[++i];
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            convert_file = argv[++i];
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            if (!event::set_scheduler(argv[++i]))
+                return 1;
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            unsigned int thread_num;
+            if (!parse_option(argv[++i], thread_num, "-j thread_num"))
+                return 1;
+            event::set_thread_num(thread_num);
+        }
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            if (!event::set_engine(argv[++i]))
+                return 1;
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            unsigned int event_num;
+            if (!parse_option(argv[++i], event_num, "-b event_num"))
+                return 1;
+            event::benchmark_scheduler("heap_scheduler", event_num);
+            event::benchmark_scheduler("calendar_scheduler", event_num);
+            return 0;
+        }
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            unsigned int flow_num;
+            if (!parse_option(argv[++i], flow_num, "-l flow_num"))
+                return 1;
+            benchmark_load(flow_num);
+            return 0;
+        }
+        else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+            benchmark_spec = argv[++i];
+        else if (strcmp(argv[i], "-p") == 0)
+            print_pool = true;
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            trace_mode = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            trace_file = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            return trace::render(argv[++i]) ? 0 : 1;
+    }
+    if (trace_mode == "")
+        trace_mode = (benchmark_spec == "") ? "text" : "none";
+    // the input is checked before the trace is opened: once it is open, it has to be closed before main() returns
+    input_scanner in(input_file); // not read if the input is a snapshot
+    if (!in)
+        return 1;
+    if (convert_file != "")
+        return snapshot::convert(in, convert_file) ? 0 : 1;
+    snapshot snap;
+    if (snapshot_file != "" && !snap.open(snapshot_file))
+        return 1;
+    if (!trace::open(trace_mode, trace_file))
+        return 1;
+    if (benchmark_spec != "") {
+        bool done = benchmark_simulation(benchmark_spec);
+        trace::close();
+        return done ? 0 : 1;
+    }
+    // header::header_generator::print(); // print all registered headers
+    // payload::payload_generator::print(); // print all registered payloads
+    // packet::packet_generator::print(); // print all registered packets
+    // node::node_generator::print(); // print all registered nodes
+    // event::event_generator::print(); // print all registered events
+    // link::link_generator::print(); // print all registered links
+    // scheduler::scheduler_generator::print(); // print all registered schedulers
+    unsigned int nodeNum, nodeCost;
+    unsigned int insTime, updTime, SimDuration;
+    unsigned int source, dest, oldPathLen;
+    unsigned int listInNetwork;
+    unsigned int sendTime;
+    // map<unsigned int, unsigned int> oldTable[nodeNum];
+    map<unsigned int, map<unsigned int, unsigned int>> oldTable;
+    if (snap.is_open()) {
+        const snapshot::header& h = snap.get_header();
+        nodeNum = h.node_num;
+        nodeCost = h.node_cost;
+        insTime = h.ins_time;
+        updTime = h.upd_time;
+        SimDuration = h.sim_duration;
+        source = h.source;
+        dest = h.dest;
+        oldPathLen = h.old_path_len;
+    }
+    else {
+        in >> nodeNum >> nodeCost;
+        in >> insTime >> updTime >> SimDuration;
+        in >> source >> dest >> oldPathLen;
+    }
+    // read the input and generate switch nodes
+    for (unsigned int id = 0; id < nodeNum; id++) {
+        node::node_generator::generate("SDN_switch", id);
+    }
+    unsigned int con_id = node::getNodeNum();
+    node::node_generator::generate("SDN_controller", con_id);
+    for (unsigned int i = 0; i < nodeNum; i++) {
+        node::id_to_node(i)->add_phy_neighbor(con_id);
+        node::id_to_node(con_id)->add_phy_neighbor(i);
+    }
+    // set switches' neighbors
+    for (unsigned int i = 0; i < oldPathLen; i++) {
+        unsigned int oldLinkID, node1, node2;
+        if (snap.is_open()) {
+            node1 = snap.old_path()[i].node1;
+            node2 = snap.old_path()[i].node2;
+        }
+        else
+            in >> oldLinkID >> node1 >> node2;
+        oldTable[node1][dest] = node2;
+        node::id_to_node(node1)->add_phy_neighbor(node2);
+        node::id_to_node(node2)->add_phy_neighbor(node1);
+    }
+
+    // control packet: the controller pushes the rules of the old table of each switch in one packet
+    for (unsigned int id = 0; id < nodeNum; id++) {
+        if (id != dest) {
+            map<unsigned int, unsigned int>& rules = oldTable[id];
+            rules.emplace(dest, 0); // a switch off the old path gets the rule toward node 0
+            ctrl_new_packet_event(con_id, id, vector<pair<unsigned int, unsigned int>>(rules.begin(), rules.end()), insTime);
+        }
+    }
+
+    // store the link and weight
+    if (snap.is_open()) { // the links of a node are sorted in the snapshot, so each map is built by appending
+        const unsigned long long* index = snap.index();
+        for (unsigned int id = 0; id < nodeNum; id++) {
+            map<unsigned int, unsigned int> link_weight;
+            for (unsigned long long k = index[id]; k < index[id + 1]; k++)
+                link_weight.emplace_hint(link_weight.end(), snap.neighbors()[k], snap.weights()[k]);
+            stat_packet_event(id, con_id, move(link_weight), updTime);
+        }
+    }
+    else {
+        in >> listInNetwork;
+        vector<class neightbor> neightbor_list;
+        for (unsigned int id = 0; id < nodeNum; id++) {
+            neightbor temp;
+            neightbor_list.push_back(temp);
+        }
+        for (unsigned int id = 0; id < listInNetwork; id++) {
+            unsigned int linkId, node1, node2, weight;
+            in >> linkId >> node1 >> node2 >> weight;
+            neightbor_list[node1].linkWeight[node2] = weight;
+            neightbor_list[node2].linkWeight[node1] = weight;
+        }
+        for (unsigned int id = 0; id < nodeNum; id++)
+            stat_packet_event(id, con_id, move(neightbor_list[id].linkWeight), updTime);
+    }
+
+    // data packet: a trace sorted by time is pulled window by window while the simulation runs, so only the flows in flight
+    // are kept; otherwise the flows are parsed chunk by chunk and their events are handed to the scheduler at once, so that
+    // it heapifies them once instead of pushing every chunk after the first one by one
+    traffic_source* traffic = nullptr;
+    if (snap.is_open()) { // the flows of a snapshot are always sorted
+        traffic = new snapshot_source(snap);
+        event::set_traffic(traffic);
+    }
+    else if (flow_source::sorted(in)) {
+        traffic = new flow_source(in);
+        event::set_traffic(traffic);
+    }
+    else {
+        const size_t FLOW_CHUNK = 1 << 16;
+        vector<flow> flows;
+        vector<event*> es;
+        flows.reserve(FLOW_CHUNK);
+        while (in >> sendTime >> source >> dest) {
+            flows.push_back(flow{sendTime, source, dest});
+            if (flows.size() == FLOW_CHUNK) {
+                data_packet_events(flows, es);
+                flows.clear();
+            }
+        }
+        data_packet_events(flows, es);
+        event::add_events(es);
+    }
+    // read the input and use data_packet_event to add an initial event
+
+    // data_packet_event(src, dst, t);
+
+    // 1st parameter: the source node
+    // 2nd parameter: the destination node
+    // 3rd parameter: time
+    // 4th parameter: msg for debug (optional)
+
+    // dst = 0;
+    /*
+    for (unsigned int id = 0; id < node::getNodeNum(); id++)
+    {
+        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
+        ctrl_packet_event(con_id, id, id, id + 1, 100);
+        // note that we don't need to use msg for network update anymore in hw3
+        // thus, function ctrl_packet_event is updated as follows:
+        // 1st parameter: the node that has to update the rule
+        // 2nd parameter: the target node of the rule (i.e., match ID)
+        // 3rd parameter: the next-hop node toward the target node recorded in the rule (i.e., action ID)
+        // 4th parameter: time (optional)
+        // 5th parameter: msg for debug (optional)
+
+        // !!!! note that you can use "ctrl_packet_event (con_id, id, mat, act)" in SDN_controller's recv_handler
+        // !!!! to generate the new ctrl msg in the next round
+    }
+    */
+    /*
+    for (unsigned int id = 0; id < node::getNodeNum(); id++)
+    {
+        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
+        ctrl_new_packet_event(con_id, id, id, id + 1, 200);
+    }
+    for (unsigned int id = 0; id < node::getNodeNum(); id++)
+    {
+        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
+        ctrl_del_packet_event(con_id, id, id, id + 1, 300);
+    }
+    for (unsigned int id = 0; id < node::getNodeNum(); id++)
+    {
+        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
+        ctrl_upd_packet_event(con_id, id, id, id + 1, 400);
+    }
+    for (unsigned int id = 0; id < node::getNodeNum(); id++)
+    {
+        // for (int id = node::getNodeNum()-1; id >= 0; id --){ // this line is used to check whether the sequence affects the results
+        map<unsigned int, unsigned int> link_weight;
+        stat_packet_event(id, con_id, link_weight, 0);
+    }
+    */
+    // start simulation!!
+    event::start_simulate(SimDuration);
+    event::set_traffic(nullptr);
+    delete traffic;
+    trace::close();
+    // event::flush_events() ;
+    // cout << packet::getLivePacketNum() << endl;
+    if (print_pool) {
+        object_pool::print();
+        cout << "live packets: " << packet::getLivePacketNum() << endl;
+    }
+    return 0;
+}
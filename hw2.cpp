@@ -978,8 +978,48 @@ public:
 
 simple_link::simple_link_generator simple_link::simple_link_generator::sample;
 
+// forwarding table of a switch: the next hop toward each destination
+// the rules are stored in an array indexed by the destination id, so a lookup is O(1);
+// unlike map::operator[], a lookup of a missing destination never adds a rule
+class forwarding_table {
+    vector<unsigned int> next_hop; // BROCAST_ID means that there is no rule for the destination
+    unsigned int rule_num;
+
+public:
+    forwarding_table() : rule_num(0) {}
+
+    // add or replace the rule of destination dst; a rule with BROCAST_ID, which marks a destination without a rule in the
+    // table, is rejected: false is returned and the table is not changed
+    bool install(unsigned int dst, unsigned int next) {
+        if (dst == BROCAST_ID || next == BROCAST_ID)
+            return false;
+        if (dst >= next_hop.size())
+            next_hop.resize(dst + 1, BROCAST_ID);
+        if (next_hop[dst] == BROCAST_ID)
+            rule_num++;
+        next_hop[dst] = next;
+        return true;
+    }
+    void remove(unsigned int dst) {
+        if (contains(dst)) {
+            next_hop[dst] = BROCAST_ID;
+            rule_num--;
+        }
+    }
+
+    // return false if there is no rule for dst (next is not changed in this case)
+    bool lookup(unsigned int dst, unsigned int& next) const {
+        if (!contains(dst))
+            return false;
+        next = next_hop[dst];
+        return true;
+    }
+    bool contains(unsigned int dst) const { return dst < next_hop.size() && next_hop[dst] != BROCAST_ID; }
+    unsigned int size() const { return rule_num; }
+};
+
 class SDN_switch : public node {
-    map<unsigned int, unsigned int> next; // you can use this variable to record the node's 1-hop neighbors 
+    forwarding_table next; // the next hop toward each destination
 
     bool hi; // this is used for example; you can remove it when doing hw2
 
@@ -995,12 +1035,13 @@ public:
     // please define recv_handler function to deal with the incoming packet
     virtual void recv_handler(packet* p);
 
-    void set_next_node_of_dest(unsigned int _dest, unsigned int _next) { next[_dest] = _next; }
-    unsigned int get_next_node_of_dest(unsigned int _dest) { return next[_dest]; }
-    bool checkDestNotExist(int dest) {
-        if (next.count(dest) == 0)return true;
-        return false;
+    void set_next_node_of_dest(unsigned int _dest, unsigned int _next) {
+        if (!next.install(_dest, _next))
+            cerr << "SDN_switch error: node " << getNodeID() << " rejects a rule with BROCAST_ID" << endl;
     }
+    // return false if there is no rule for _dest
+    bool get_next_node_of_dest(unsigned int _dest, unsigned int& _next) const { return next.lookup(_dest, _next); }
+    bool checkDestNotExist(unsigned int dest) const { return !next.contains(dest); }
 
     class SDN_switch_generator;
     friend class SDN_switch_generator;
@@ -1175,9 +1216,10 @@ void SDN_switch::recv_handler(packet* p) {
         // cout << "node " << getNodeID() << " send the packet" << endl;
         SDN_data_packet* p2 = nullptr;
         p2 = dynamic_cast<SDN_data_packet*> (p);
-        if (p2->getHeader()->getDstID() == getNodeID() || checkDestNotExist(p2->getHeader()->getDstID()))return; // if dest does not exist or dest == current id do nothing
+        unsigned int nexID;
+        if (p2->getHeader()->getDstID() == getNodeID() || !get_next_node_of_dest(p2->getHeader()->getDstID(), nexID))return; // if dest does not exist or dest == current id do nothing
         p2->getHeader()->setPreID(getNodeID()); // get current node id
-        p2->getHeader()->setNexID(get_next_node_of_dest(p2->getHeader()->getDstID())); //get next node of dest from map and set to the header
+        p2->getHeader()->setNexID(nexID); // set the next node of dest found in the forwarding table to the header
         p2->getHeader()->setDstID(p2->getHeader()->getDstID());
         send_handler(p2);
     }
@@ -1250,19 +1292,6 @@ public:
     int newWeight;
 };
 
-class Neighbor { // neighbor and weight between
-public:
-    unsigned int id;
-    int oldWeight;
-    int newWeight;
-};
-
-class Node { // node and it's neighbor list
-public:
-    unsigned int id;
-    vector<Neighbor>neighbors;
-};
-
 class pqLink { // structure for dijkstra priority queue
 public:
     unsigned int from;
@@ -1285,18 +1314,59 @@ public:
         return b.newWeight < a.newWeight;
     }
 };
-int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsigned int, Node>& nodes, int nodeCnt, bool newWeight) {
-    map<unsigned int, unsigned int> cost; // path cost for each point
-    priority_queue<pqLink, vector<pqLink>, CompareOld> oldPq; // two priority for using different compare function
-    priority_queue<pqLink, vector<pqLink>, CompareNew> newPq;
-    vector<bool> selected; // node selected already
+const unsigned int NO_PARENT = UINT_MAX; // the node is not reached from dest
+// the graph in compressed sparse row form: the neighbors of node u are adj[first[u]], ..., adj[first[u + 1] - 1]
+// they keep the input order of the links, so dijkstra pushes them in the same order as the old neighbor lists
+class CsrGraph {
+public:
+    vector<unsigned int> first; // nodeNum() + 1 offsets into adj
+    vector<unsigned int> adj; // the neighbor at the other end of each link
+    vector<int> oldWeight; // the weights of the link to adj[k]
+    vector<int> newWeight;
+
+    CsrGraph(const vector<Link>& links, unsigned int nodeCnt) {
+        for (auto& l : links)
+            nodeCnt = max(nodeCnt, max(l.nodeA, l.nodeB) + 1);
+        first.assign(nodeCnt + 1, 0);
+        for (auto& l : links) { // count the degrees
+            first[l.nodeA + 1]++;
+            first[l.nodeB + 1]++;
+        }
+        for (unsigned int u = 0; u < nodeCnt; u++)
+            first[u + 1] += first[u];
+        adj.resize(first[nodeCnt]);
+        oldWeight.resize(first[nodeCnt]);
+        newWeight.resize(first[nodeCnt]);
+        vector<unsigned int> next(first.begin(), first.end() - 1); // the next free slot of each node
+        for (auto& l : links) {
+            unsigned int k = next[l.nodeA]++;
+            adj[k] = l.nodeB, oldWeight[k] = l.oldWeight, newWeight[k] = l.newWeight;
+            k = next[l.nodeB]++;
+            adj[k] = l.nodeA, oldWeight[k] = l.oldWeight, newWeight[k] = l.newWeight;
+        }
+    }
+    unsigned int nodeNum() const { return first.size() - 1; }
+};
+// the next hop of id in table; a node without a route reads as 0, as a missing key of the old map tables did
+unsigned int routeOf(const vector<unsigned int>& table, unsigned int id) {
+    return id < table.size() && table[id] != NO_PARENT ? table[id] : 0;
+}
+// dijkstra toward dest; table[v] is the next hop of v (NO_PARENT if v is not reached) and table[dest] = dest
+// the pushes and the comparisons are the same as with the old map tables, so ties are broken the same way
+int dijkstra(vector<unsigned int>& table, unsigned int dest, const CsrGraph& graph, bool newWeight) {
+    unsigned int nodeNum = graph.nodeNum();
+    vector<int> cost(nodeNum, 0); // path cost for each point
+    vector<char> selected(nodeNum, false); // node selected already
+    vector<pqLink> heap; // the storage of the priority queue; one push per link at most
+    heap.reserve(graph.adj.size());
     pqLink current;
-    selected.resize(nodeCnt);
+    table.assign(nodeNum, NO_PARENT);
     table[dest] = dest;
     if (!newWeight) { // if comparing old weight
+        priority_queue<pqLink, vector<pqLink>, CompareOld> oldPq(CompareOld(), move(heap)); // two priority for using different compare function
         selected[dest] = true;
-        for (auto i : nodes[dest].neighbors) {
-            oldPq.push({ dest, i.id, i.oldWeight, i.newWeight }); // push all neighbors of dest
+        for (unsigned int k = graph.first[dest]; k < graph.first[dest + 1]; k++) {
+            oldPq.push({ dest, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] }); // push all neighbors of dest
         }
         while (!oldPq.empty()) {
             current = oldPq.top(); // get top of pq and pop
@@ -1306,17 +1376,17 @@ int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsi
             cost[current.to] = current.oldWeight; // upsate cost
 
             selected[current.to] = true; // update selected
-            for (auto i : nodes[current.to].neighbors) { // push all neighbors of the popped node
-                if (!selected[i.id]) // check if not selected
-                    oldPq.push({ current.to, i.id, i.oldWeight + (int)cost[current.to] , i.newWeight });
+            for (unsigned int k = graph.first[current.to]; k < graph.first[current.to + 1]; k++) { // push all neighbors of the popped node
+                if (!selected[graph.adj[k]]) // check if not selected
+                    oldPq.push({ current.to, graph.adj[k], graph.oldWeight[k] + cost[current.to], graph.newWeight[k] });
             }
-
         }
     }
     else {
+        priority_queue<pqLink, vector<pqLink>, CompareNew> newPq(CompareNew(), move(heap));
         selected[dest] = true;
-        for (auto i : nodes[dest].neighbors) {
-            newPq.push({ dest, i.id, i.oldWeight, i.newWeight });
+        for (unsigned int k = graph.first[dest]; k < graph.first[dest + 1]; k++) {
+            newPq.push({ dest, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] });
         }
         while (!newPq.empty()) {
             current = newPq.top();
@@ -1326,11 +1396,10 @@ int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsi
             cost[current.to] = current.newWeight;
 
             selected[current.to] = true;
-            for (auto i : nodes[current.to].neighbors) {
-                if (!selected[i.id])
-                    newPq.push({ current.to, i.id, i.oldWeight  , i.newWeight + (int)cost[current.to] });
+            for (unsigned int k = graph.first[current.to]; k < graph.first[current.to + 1]; k++) {
+                if (!selected[graph.adj[k]])
+                    newPq.push({ current.to, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] + cost[current.to] });
             }
-
         }
     }
     return 1;
@@ -1372,9 +1441,8 @@ int main() {
     // link::link_generator::print(); // print all registered links 
 
     vector<Link> links; // save input
-    map<unsigned int, Node> nodes; // nodes list and their neighbor
-    vector<map<unsigned int, unsigned int>>tableList; // route table list for different dest
-    vector<map<unsigned int, unsigned int>>newTableList; // route table using new weight
+    vector<vector<unsigned int>>tableList; // route table list for different dest
+    vector<vector<unsigned int>>newTableList; // route table using new weight
     unsigned int nodeCnt, destCnt, linkCnt;
     cin >> nodeCnt >> destCnt >> linkCnt;
     int insTime, updTime, simTime;
@@ -1390,17 +1458,14 @@ int main() {
         cin >> link.linkId >> link.nodeA >> link.nodeB >> link.oldWeight >> link.newWeight;
         links.push_back(link);
     }
-    for (auto i : links) { // build node list and their neighbors
-        nodes[i.nodeA].neighbors.push_back({ i.nodeB, i.oldWeight, i.newWeight });
-        nodes[i.nodeB].neighbors.push_back({ i.nodeA, i.oldWeight, i.newWeight });
-    }
+    CsrGraph graph(links, nodeCnt); // build node list and their neighbors
     tableList.resize(destCnt); // resize the table
     newTableList.resize(destCnt);
     for (unsigned int i = 0; i < destCnt; i++) {
-        dijkstra(tableList[i], destIds[i], nodes, nodeCnt, false); // shortest path algorithm, using old weight
+        dijkstra(tableList[i], destIds[i], graph, false); // shortest path algorithm, using old weight
     }
     for (unsigned int i = 0; i < destCnt; i++) {
-        dijkstra(newTableList[i], destIds[i], nodes, nodeCnt, true); // new weight
+        dijkstra(newTableList[i], destIds[i], graph, true); // new weight
     }
 
 
@@ -1412,8 +1477,8 @@ int main() {
     }
     // set switches' neighbors
     for (unsigned int id = 0; id < nodeCnt; id++) {
-        for (auto j : nodes[id].neighbors) {
-            node::id_to_node(id)->add_phy_neighbor(j.id);
+        for (unsigned int k = graph.first[id]; k < graph.first[id + 1]; k++) {
+            node::id_to_node(id)->add_phy_neighbor(graph.adj[k]);
         }
     }
 
@@ -1436,7 +1501,7 @@ int main() {
     for (unsigned int id = 0; id < node::getNodeNum(); id++) {
         for (unsigned int i = 0; i < destCnt; i++) { // seve old weight control packet
             if (id == destIds[i])continue;
-            string msg = to_string(destIds[i]) + " " + to_string(tableList[i][id]);
+            string msg = to_string(destIds[i]) + " " + to_string(routeOf(tableList[i], id));
             eventListElement e;
             e.type = "ctrl";
             e.time = insTime;
@@ -1446,8 +1511,8 @@ int main() {
         }
         for (unsigned int i = 0; i < destCnt; i++) { // save new weight control packet
             if (id == destIds[i])continue;
-            if (newTableList[i][id] != tableList[i][id]) { // if route change
-                string msg = to_string(destIds[i]) + " " + to_string(newTableList[i][id]);
+            if (routeOf(newTableList[i], id) != routeOf(tableList[i], id)) { // if route change
+                string msg = to_string(destIds[i]) + " " + to_string(routeOf(newTableList[i], id));
                 eventListElement e;
                 e.type = "ctrl";
                 e.time = updTime;
@@ -7,12 +7,56 @@
 #include <iomanip>
 #include <stack>
 #include <algorithm>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
 
 using namespace std;
 
 #define SET(func_name,type,var_name,_var_name) void func_name(type _var_name) { var_name = _var_name ;} 
 #define GET(func_name,type,var_name) type func_name() const { return var_name ;}
 
+// the message of a payload is interned: equal texts share one immutable string, so a copy is a pointer copy and two
+// messages are compared by their pointers. the fixed tags ("default", "update") are static strings found without the
+// table; any other text is added to the table the first time it is seen and kept until the end.
+// compare with the tag constants (msg == message::UPDATE), which is a pointer comparison
+class message {
+    const string* text;
+
+    explicit message(const string* _text) : text(_text) {}
+
+    static const string tags[];
+    static const size_t TAG_NUM;
+    static const string* intern(const char* s, size_t len) {
+        for (size_t i = 0; i < TAG_NUM; i++)
+            if (tags[i].size() == len && memcmp(tags[i].data(), s, len) == 0)
+                return &tags[i];
+        static mutex table_lock;
+        static unordered_set<string> table; // its strings never move, so the pointers to them stay valid
+        lock_guard<mutex> lock(table_lock);
+        return &*table.emplace(s, len).first;
+    }
+
+public:
+    static const message DEFAULT, UPDATE;
+
+    message() : text(&tags[0]) {} // "default"
+    message(const char* s) : text(intern(s, strlen(s))) {}
+    message(const string& s) : text(intern(s.data(), s.size())) {}
+
+    const string& str() const { return *text; }
+    operator const string&() const { return *text; }
+    bool operator==(const message& m) const { return text == m.text; }
+    bool operator!=(const message& m) const { return text != m.text; }
+    friend ostream& operator<<(ostream& os, const message& m) { return os << *m.text; }
+};
+const string message::tags[] = {"default", "update"};
+const size_t message::TAG_NUM = sizeof(message::tags) / sizeof(message::tags[0]);
+const message message::DEFAULT(&message::tags[0]);
+const message message::UPDATE(&message::tags[1]);
+
 class header;
 class payload;
 class packet;
@@ -150,7 +194,7 @@ SDN_ctrl_header::SDN_ctrl_header_generator SDN_ctrl_header::SDN_ctrl_header_gene
 class payload {
     payload(payload&) {} // this constructor cannot be directly called by users
 
-    string msg;
+    message msg;
 
 protected:
     payload() {}
@@ -158,8 +202,8 @@ public:
     virtual ~payload() {}
     virtual string type() = 0;
 
-    SET(setMsg, string, msg, _msg);
-    GET(getMsg, string, msg);
+    SET(setMsg, message, msg, _msg);
+    GET(getMsg, message, msg);
 
     class payload_generator {
         // lock the copy constructor
@@ -530,8 +574,48 @@ public:
 map<string, node::node_generator*> node::node_generator::prototypes;
 map<unsigned int, node*> node::id_node_table;
 
+// forwarding table of a switch: the next hop toward each destination
+// the rules are stored in an array indexed by the destination id, so a lookup is O(1);
+// unlike map::operator[], a lookup of a missing destination never adds a rule
+class forwarding_table {
+    vector<unsigned int> next_hop; // BROCAST_ID means that there is no rule for the destination
+    unsigned int rule_num;
+
+public:
+    forwarding_table() : rule_num(0) {}
+
+    // add or replace the rule of destination dst; a rule with BROCAST_ID, which marks a destination without a rule in the
+    // table, is rejected: false is returned and the table is not changed
+    bool install(unsigned int dst, unsigned int next) {
+        if (dst == BROCAST_ID || next == BROCAST_ID)
+            return false;
+        if (dst >= next_hop.size())
+            next_hop.resize(dst + 1, BROCAST_ID);
+        if (next_hop[dst] == BROCAST_ID)
+            rule_num++;
+        next_hop[dst] = next;
+        return true;
+    }
+    void remove(unsigned int dst) {
+        if (contains(dst)) {
+            next_hop[dst] = BROCAST_ID;
+            rule_num--;
+        }
+    }
+
+    // return false if there is no rule for dst (next is not changed in this case)
+    bool lookup(unsigned int dst, unsigned int& next) const {
+        if (!contains(dst))
+            return false;
+        next = next_hop[dst];
+        return true;
+    }
+    bool contains(unsigned int dst) const { return dst < next_hop.size() && next_hop[dst] != BROCAST_ID; }
+    unsigned int size() const { return rule_num; }
+};
+
 class SDN_switch : public node {
-    map<unsigned int, unsigned int> next; // you can use this variable to record the node's 1-hop neighbors 
+    forwarding_table next; // the next hop toward each destination
 
     bool hi; // this is used for example; you can remove it when doing hw2
 
@@ -550,12 +634,13 @@ public:
     // void add_one_hop_neighbor (unsigned int n_id) { one_hop_neighbors[n_id] = true; }
     // unsigned int get_one_hop_neighbor_num () { return one_hop_neighbors.size(); }
 
-    void set_next_node_of_dest(unsigned int _dest, unsigned int _next) { next[_dest] = _next; }
-    unsigned int get_next_node_of_dest(unsigned int _dest) { return next[_dest]; }
-    bool checkDestNotExist(int dest) {
-        if (next.count(dest) == 0)return true;
-        return false;
+    void set_next_node_of_dest(unsigned int _dest, unsigned int _next) {
+        if (!next.install(_dest, _next))
+            cerr << "SDN_switch error: node " << getNodeID() << " rejects a rule with BROCAST_ID" << endl;
     }
+    // return false if there is no rule for _dest
+    bool get_next_node_of_dest(unsigned int _dest, unsigned int& _next) const { return next.lookup(_dest, _next); }
+    bool checkDestNotExist(unsigned int dest) const { return !next.contains(dest); }
 
     class SDN_switch_generator;
     friend class SDN_switch_generator;
@@ -581,6 +666,52 @@ struct Round {
     bool operator==(const Round& a) { return a.target == this->target; }
 };
 
+// the progress of the update rounds of one destination
+// each target of the current round has an index to its slot and the round counts the targets which have not acknowledged yet,
+// so an ack costs O(1) and the next round is released as soon as the count reaches zero
+class RoundTracker {
+    vector<vector<Round > >* rounds = nullptr;
+    vector<pair<unsigned int, unsigned int> > slotOf; // target -> (round, index in the round)
+    unsigned int cur = 0; // the current round
+    unsigned int outstanding = 0; // the targets of the current round which have not acknowledged yet
+
+    // index the targets of the current round
+    void enter() {
+        outstanding = 0;
+        if (finished()) return;
+        for (unsigned int i = 0; i < (*rounds)[cur].size(); i++) {
+            unsigned int target = (*rounds)[cur][i].target;
+            if (target >= slotOf.size()) slotOf.resize(target + 1, { UINT_MAX, 0 });
+            if (slotOf[target].first == cur) continue; // the same target twice in a round is acknowledged once
+            slotOf[target] = { cur, i };
+            outstanding++;
+        }
+    }
+
+public:
+    // the first round becomes the current one
+    void track(vector<vector<Round > >& _rounds) {
+        rounds = &_rounds;
+        cur = 0;
+        slotOf.clear();
+        enter();
+    }
+    bool tracking() const { return rounds != nullptr; }
+    unsigned int current() const { return cur; }
+    bool finished() const { return cur >= rounds->size(); }
+    // target acknowledged its rule; returns true if this ack completed the current round, and then the next round is the current one
+    bool ack(unsigned int target) {
+        if (finished() || target >= slotOf.size() || slotOf[target].first != cur) return false; // not a target of the current round
+        Round& r = (*rounds)[cur][slotOf[target].second];
+        if (r.state == 1) return false; // acknowledged before
+        r.state = 1;
+        if (--outstanding > 0) return false;
+        cur++;
+        enter();
+        return true;
+    }
+};
+
 class SDN_controller : public node {
     // map<unsigned int,bool> one_hop_neighbors; // you can use this variable to record the node's 1-hop neighbors 
     map<unsigned int, vector<vector<Round > > >round; // update round of the route table
@@ -591,16 +722,24 @@ protected:
     SDN_controller(unsigned int _id) : node(_id) {} // this constructor cannot be directly called by users
 
 public:
-    map<unsigned int, unsigned int> curRound;
-    map<unsigned int, unsigned int> newCurRound;
+    vector<RoundTracker> curRound; // the progress of the rounds of each dest
+    vector<RoundTracker> newCurRound;
 
     ~SDN_controller() {}
     string type() { return "SDN_controller"; }
     void setRound(map<unsigned int, vector<vector<Round > > > _round) {
         round = _round;
+        curRound.clear();
     }
     void setNewRound(map<unsigned int, vector<vector<Round > > > _round) {
         newRound = _round;
+        newCurRound.clear();
+    }
+    // the tracker of the rounds of mat; it indexes the rounds at the first ack of mat
+    RoundTracker& trackerOf(vector<RoundTracker>& trackers, map<unsigned int, vector<vector<Round > > >& rounds, unsigned int mat) {
+        if (mat >= trackers.size()) trackers.resize(mat + 1);
+        if (!trackers[mat].tracking()) trackers[mat].track(rounds[mat]);
+        return trackers[mat];
     }
     // please define recv_handler function to deal with the incoming packet
     virtual void recv_handler(packet* p);
@@ -974,7 +1113,7 @@ private:
     unsigned int src; // the src
     unsigned int dst; // the dst 
     // packet *pkt; // the packet
-    string msg;
+    message msg;
 
 protected:
     SDN_data_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
@@ -1014,7 +1153,7 @@ public:
     public:
         unsigned int src_id;
         unsigned int dst_id;
-        string msg;
+        message msg;
         // packet *_pkt;
     };
 
@@ -1092,7 +1231,7 @@ private:
     unsigned int mat;
     unsigned int act;
     // packet *pkt; // the packet
-    string msg;
+    message msg;
 
 protected:
     SDN_ctrl_pkt_gen_event(unsigned int _trigger_time, void* data) : event(_trigger_time), src(BROCAST_ID), dst(BROCAST_ID) {
@@ -1136,7 +1275,7 @@ public:
         unsigned int dst_id; // the node that should update its rule
         unsigned int mat_id; // the target of the rule
         unsigned int act_id; // the next hop toward the target recorded in the rule
-        string msg;
+        message msg;
         // packet *_pkt;
     };
 
@@ -1318,7 +1457,7 @@ simple_link::simple_link_generator simple_link::simple_link_generator::sample;
 
 
 // the data_packet_event function is used to add an initial event
-void data_packet_event(unsigned int src, unsigned int dst, unsigned int t = 0, string msg = "default") {
+void data_packet_event(unsigned int src, unsigned int dst, unsigned int t = 0, message msg = message::DEFAULT) {
     if (node::id_to_node(src) == nullptr || (dst != BROCAST_ID && node::id_to_node(dst) == nullptr)) {
         cerr << "src or dst is incorrect" << endl; return;
         return;
@@ -1335,7 +1474,7 @@ void data_packet_event(unsigned int src, unsigned int dst, unsigned int t = 0, s
 }
 
 // the ctrl_packet_event function is used to add an initial event
-void ctrl_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), string msg = "default") {
+void ctrl_packet_event(unsigned int con_id, unsigned int id, unsigned int mat, unsigned int act, unsigned int t = event::getCurTime(), message msg = message::DEFAULT) {
     // void ctrl_packet_event (unsigned int dst, unsigned int t = 0, string msg = "default"){
     if (id == BROCAST_ID || node::id_to_node(id) == nullptr) {
         cerr << "id is incorrect" << endl; return;
@@ -1404,9 +1543,10 @@ void SDN_switch::recv_handler(packet* p) {
         // cout << "node " << getNodeID() << " send the packet" << endl;
         SDN_data_packet* p2 = nullptr;
         p2 = dynamic_cast<SDN_data_packet*> (p);
-        if (p2->getHeader()->getDstID() == getNodeID() || checkDestNotExist(p2->getHeader()->getDstID()))return; // if dest does not exist or dest == current id do nothing
+        unsigned int nexID;
+        if (p2->getHeader()->getDstID() == getNodeID() || !get_next_node_of_dest(p2->getHeader()->getDstID(), nexID))return; // if dest does not exist or dest == current id do nothing
         p2->getHeader()->setPreID(getNodeID()); // get current node id
-        p2->getHeader()->setNexID(get_next_node_of_dest(p2->getHeader()->getDstID())); //get next node of dest from map and set to the header
+        p2->getHeader()->setNexID(nexID); // set the next node of dest found in the forwarding table to the header
         p2->getHeader()->setDstID(p2->getHeader()->getDstID());
         send_handler(p2);
     }
@@ -1480,23 +1620,17 @@ void SDN_controller::recv_handler(packet* p) {
     if (p->type() == "SDN_data_packet") { // the controller receives a packet from the other switch
         return;
     }
-    else if (p->type() == "SDN_ctrl_packet" && p->getHeader()->getDstID() == getNodeID() && dynamic_cast<SDN_ctrl_payload*> (dynamic_cast<SDN_ctrl_packet*> (p)->getPayload())->getMsg() == "update") { //ack
+    else if (p->type() == "SDN_ctrl_packet" && p->getHeader()->getDstID() == getNodeID() && dynamic_cast<SDN_ctrl_payload*> (dynamic_cast<SDN_ctrl_packet*> (p)->getPayload())->getMsg() == message::UPDATE) { //ack
         SDN_ctrl_packet* p2 = nullptr;
         p2 = dynamic_cast<SDN_ctrl_packet*> (p);
         SDN_ctrl_payload* l2 = nullptr;
         l2 = dynamic_cast<SDN_ctrl_payload*> (p2->getPayload());
-        Round r = { p2->getHeader()->getSrcID(),0,0,0 };
-        if (curRound[l2->getMatID()] >= round[l2->getMatID()].size())return;
-        auto found = find(newRound[l2->getMatID()][newCurRound[l2->getMatID()]].begin(), newRound[l2->getMatID()][newCurRound[l2->getMatID()]].end(), r);
-        if (found != newRound[l2->getMatID()][newCurRound[l2->getMatID()]].end()) {
-            found->state = 1;
-            auto zeroFound = count_if(newRound[l2->getMatID()][newCurRound[l2->getMatID()]].begin(), newRound[l2->getMatID()][newCurRound[l2->getMatID()]].end(), [](Round r1) { return r1.state == 0; });
-            if (zeroFound == 0) {
-                newCurRound[l2->getMatID()]++;
-                if (newCurRound[l2->getMatID()] >= newRound[l2->getMatID()].size())return;
-                for (auto j : newRound[l2->getMatID()][newCurRound[l2->getMatID()]]) {
-                    ctrl_packet_event(getNodeID(), j.target, j.match, j.action);
-                }
+        auto mat = l2->getMatID();
+        if (trackerOf(curRound, round, mat).finished())return;
+        RoundTracker& tracker = trackerOf(newCurRound, newRound, mat);
+        if (tracker.ack(p2->getHeader()->getSrcID()) && !tracker.finished()) {
+            for (auto j : newRound[mat][tracker.current()]) {
+                ctrl_packet_event(getNodeID(), j.target, j.match, j.action);
             }
         }
     }
@@ -1506,19 +1640,10 @@ void SDN_controller::recv_handler(packet* p) {
         SDN_ctrl_payload* l2 = nullptr;
         l2 = dynamic_cast<SDN_ctrl_payload*> (p2->getPayload());
         auto mat = l2->getMatID();
-        auto nowRound = curRound[mat];
-        if (curRound[mat] >= round[mat].size())return;
-        for (int i = 0; i < round[mat][curRound[mat]].size(); i++) {
-            if (round[mat][nowRound][i].target == p2->getHeader()->getSrcID()) {
-                round[mat][nowRound][i].state = 1;
-                auto zeroFound = count_if(round[mat][curRound[mat]].begin(), round[mat][curRound[mat]].end(), [](Round r1) { return r1.state == 0; });
-                if (zeroFound == 0) {
-                    curRound[mat]++;
-                    if (curRound[mat] >= round[mat].size())return;
-                    for (auto j : round[mat][curRound[mat]]) {
-                        ctrl_packet_event(getNodeID(), j.target, j.match, j.action);
-                    }
-                }
+        RoundTracker& tracker = trackerOf(curRound, round, mat);
+        if (tracker.ack(p2->getHeader()->getSrcID()) && !tracker.finished()) {
+            for (auto j : round[mat][tracker.current()]) {
+                ctrl_packet_event(getNodeID(), j.target, j.match, j.action);
             }
         }
     }
@@ -1546,19 +1671,6 @@ public:
     int newWeight;
 };
 
-class Neighbor { // neighbor and weight between
-public:
-    unsigned int id;
-    int oldWeight;
-    int newWeight;
-};
-
-class Node { // node and it's neighbor list
-public:
-    unsigned int id;
-    vector<Neighbor>neighbors;
-};
-
 class pqLink { // structure for dijkstra priority queue
 public:
     unsigned int from;
@@ -1581,21 +1693,77 @@ public:
         return b.newWeight < a.newWeight;
     }
 };
-int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsigned int, Node>& nodes, int nodeCnt, bool newWeight, vector < vector<Round > >& round) {
-    map<unsigned int, unsigned int> cost; // path cost for each point
-    priority_queue<pqLink, vector<pqLink>, CompareOld> oldPq; // two priority for using different compare function
-    priority_queue<pqLink, vector<pqLink>, CompareNew> newPq;
-    map<unsigned int, unsigned int> depth;
-    unsigned maxDepth = 0;
-    vector<bool> selected; // node selected already
+// run task(i) for every i in [0, taskCnt) on a pool of threads; the tasks are taken in order from a shared counter
+// each task must write only its own outputs, so the results do not depend on the number of threads
+template <typename Task>
+void parallelFor(unsigned int taskCnt, Task task) {
+    unsigned int threadCnt = min(max(thread::hardware_concurrency(), 1u), taskCnt);
+    atomic<unsigned int> next(0);
+    auto work = [&]() {
+        for (unsigned int i = next++; i < taskCnt; i = next++)
+            task(i);
+    };
+    vector<thread> pool;
+    for (unsigned int i = 1; i < threadCnt; i++)
+        pool.emplace_back(work);
+    work();
+    for (auto& t : pool)
+        t.join();
+}
+const unsigned int NO_PARENT = UINT_MAX; // the node is not reached from dest
+// the graph in compressed sparse row form: the neighbors of node u are adj[first[u]], ..., adj[first[u + 1] - 1]
+// they keep the input order of the links, so dijkstra pushes them in the same order as the old neighbor lists
+class CsrGraph {
+public:
+    vector<unsigned int> first; // nodeNum() + 1 offsets into adj
+    vector<unsigned int> adj; // the neighbor at the other end of each link
+    vector<int> oldWeight; // the weights of the link to adj[k]
+    vector<int> newWeight;
+
+    CsrGraph(const vector<Link>& links, unsigned int nodeCnt) {
+        for (auto& l : links)
+            nodeCnt = max(nodeCnt, max(l.nodeA, l.nodeB) + 1);
+        first.assign(nodeCnt + 1, 0);
+        for (auto& l : links) { // count the degrees
+            first[l.nodeA + 1]++;
+            first[l.nodeB + 1]++;
+        }
+        for (unsigned int u = 0; u < nodeCnt; u++)
+            first[u + 1] += first[u];
+        adj.resize(first[nodeCnt]);
+        oldWeight.resize(first[nodeCnt]);
+        newWeight.resize(first[nodeCnt]);
+        vector<unsigned int> next(first.begin(), first.end() - 1); // the next free slot of each node
+        for (auto& l : links) {
+            unsigned int k = next[l.nodeA]++;
+            adj[k] = l.nodeB, oldWeight[k] = l.oldWeight, newWeight[k] = l.newWeight;
+            k = next[l.nodeB]++;
+            adj[k] = l.nodeA, oldWeight[k] = l.oldWeight, newWeight[k] = l.newWeight;
+        }
+    }
+    unsigned int nodeNum() const { return first.size() - 1; }
+};
+// the next hop of id in table; a node without a route reads as 0, as a missing key of the old map tables did
+unsigned int routeOf(const vector<unsigned int>& table, unsigned int id) {
+    return id < table.size() && table[id] != NO_PARENT ? table[id] : 0;
+}
+// dijkstra toward dest; table[v] is the next hop of v (NO_PARENT if v is not reached) and table[dest] = dest
+// the pushes and the comparisons are the same as with the old map tables, so ties are broken the same way
+// graph is only read, so the trees of different destinations can be built at the same time
+int dijkstra(vector<unsigned int>& table, unsigned int dest, const CsrGraph& graph, bool newWeight, vector < vector<Round > >& round) {
+    unsigned int nodeNum = graph.nodeNum();
+    vector<int> cost(nodeNum, 0); // path cost for each point
+    vector<char> selected(nodeNum, false); // node selected already
+    vector<pqLink> heap; // the storage of the priority queue; one push per link at most
+    heap.reserve(graph.adj.size());
     pqLink current;
-    depth[dest] = 0;
-    selected.resize(nodeCnt);
+    table.assign(nodeNum, NO_PARENT);
     table[dest] = dest;
     if (!newWeight) { // if comparing old weight
+        priority_queue<pqLink, vector<pqLink>, CompareOld> oldPq(CompareOld(), move(heap)); // two priority for using different compare function
         selected[dest] = true;
-        for (auto i : nodes[dest].neighbors) {
-            oldPq.push({ dest, i.id, i.oldWeight, i.newWeight }); // push all neighbors of dest
+        for (unsigned int k = graph.first[dest]; k < graph.first[dest + 1]; k++) {
+            oldPq.push({ dest, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] }); // push all neighbors of dest
         }
         while (!oldPq.empty()) {
             current = oldPq.top(); // get top of pq and pop
@@ -1605,17 +1773,17 @@ int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsi
             cost[current.to] = current.oldWeight; // upsate cost
 
             selected[current.to] = true; // update selected
-            for (auto i : nodes[current.to].neighbors) { // push all neighbors of the popped node
-                if (!selected[i.id]) { // check if not selected
-                    oldPq.push({ current.to, i.id, i.oldWeight + (int)cost[current.to] , i.newWeight });
-                }
+            for (unsigned int k = graph.first[current.to]; k < graph.first[current.to + 1]; k++) { // push all neighbors of the popped node
+                if (!selected[graph.adj[k]]) // check if not selected
+                    oldPq.push({ current.to, graph.adj[k], graph.oldWeight[k] + cost[current.to], graph.newWeight[k] });
             }
         }
     }
     else {
+        priority_queue<pqLink, vector<pqLink>, CompareNew> newPq(CompareNew(), move(heap));
         selected[dest] = true;
-        for (auto i : nodes[dest].neighbors) {
-            newPq.push({ dest, i.id, i.oldWeight, i.newWeight });
+        for (unsigned int k = graph.first[dest]; k < graph.first[dest + 1]; k++) {
+            newPq.push({ dest, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] });
         }
         while (!newPq.empty()) {
             current = newPq.top();
@@ -1625,29 +1793,36 @@ int dijkstra(map<unsigned int, unsigned int>& table, unsigned int dest, map<unsi
             cost[current.to] = current.newWeight;
 
             selected[current.to] = true;
-            for (auto i : nodes[current.to].neighbors) {
-                if (!selected[i.id]) {
-                    newPq.push({ current.to, i.id, i.oldWeight  , i.newWeight + (int)cost[current.to] });
-                }
+            for (unsigned int k = graph.first[current.to]; k < graph.first[current.to + 1]; k++) {
+                if (!selected[graph.adj[k]])
+                    newPq.push({ current.to, graph.adj[k], graph.oldWeight[k], graph.newWeight[k] + cost[current.to] });
             }
         }
-
     }
-    for (auto i : table) {
-        int depthCnt = 0;
+    // a node is one deeper than its next hop, so the walk toward dest stops at the first node whose depth is known
+    // and every depth is counted once
+    const unsigned int UNKNOWN = UINT_MAX;
+    vector<unsigned int> depth(nodeNum, UNKNOWN);
+    vector<unsigned int> path; // the walked nodes whose depth is not known yet
+    unsigned maxDepth = 0;
+    depth[dest] = 0;
+    for (unsigned int v = 0; v < nodeNum; v++) {
+        if (table[v] == NO_PARENT)continue; // not reached from dest
         unsigned int currentNode;
-        currentNode = i.first;
-        while (currentNode != dest) {
-            depthCnt++;
+        currentNode = v;
+        while (depth[currentNode] == UNKNOWN) {
+            path.push_back(currentNode);
             currentNode = table[currentNode];
         }
-        depth[i.first] = depthCnt;
-        if (depthCnt > maxDepth)maxDepth = depthCnt;
+        unsigned int depthCnt = depth[currentNode];
+        for (; !path.empty(); path.pop_back())
+            depth[path.back()] = ++depthCnt;
+        if (depth[v] > maxDepth)maxDepth = depth[v];
     }
     round.resize(maxDepth);
-    for (auto i : depth) {
-        if (i.first == dest)continue;
-        round[i.second - 1].push_back({ i.first, dest, table[i.first], 0 });
+    for (unsigned int v = 0; v < nodeNum; v++) {
+        if (v == dest || table[v] == NO_PARENT)continue;
+        round[depth[v] - 1].push_back({ v, dest, table[v], 0 });
     }
     return 1;
 }
@@ -1662,9 +1837,8 @@ int main() {
     // event::event_generator::print(); // print all registered events
     // link::link_generator::print(); // print all registered links 
     vector<Link> links; // save input
-    map<unsigned int, Node> nodes; // nodes list and their neighbor
-    vector<map<unsigned int, unsigned int> >tableList; // route table list for different dest
-    vector<map<unsigned int, unsigned int> >newTableList; // route table using new weight
+    vector<vector<unsigned int> >tableList; // route table list for different dest
+    vector<vector<unsigned int> >newTableList; // route table using new weight
     map<unsigned int, vector<vector<Round > > >round; // update round of the route table
     map<unsigned int, vector<vector<Round > > >newRound; // update round of new route table
     unsigned int nodeCnt, destCnt, linkCnt;
@@ -1682,18 +1856,30 @@ int main() {
         cin >> link.linkId >> link.nodeA >> link.nodeB >> link.oldWeight >> link.newWeight;
         links.push_back(link);
     }
-    for (auto i : links) { // build node list and their neighbors
-        nodes[i.nodeA].neighbors.push_back({ i.nodeB, i.oldWeight, i.newWeight });
-        nodes[i.nodeB].neighbors.push_back({ i.nodeA, i.oldWeight, i.newWeight });
-    }
+    CsrGraph graph(links, nodeCnt); // build node list and their neighbors
     tableList.resize(destCnt); // resize the table
     newTableList.resize(destCnt);
+    // a destination listed twice appends to the same rounds, so its trees are built by one task in the input order
+    vector<vector<unsigned int> > destTasks;
+    map<unsigned int, unsigned int> taskOfDest;
     for (unsigned int i = 0; i < destCnt; i++) {
-        dijkstra(tableList[i], destIds[i], nodes, nodeCnt, false, round[destIds[i]]); // shortest path algorithm, using old weight
-    }
-    for (unsigned int i = 0; i < destCnt; i++) {
-        dijkstra(newTableList[i], destIds[i], nodes, nodeCnt, true, newRound[destIds[i]]); // new weight
+        if (taskOfDest.find(destIds[i]) == taskOfDest.end()) {
+            taskOfDest[destIds[i]] = destTasks.size();
+            destTasks.push_back({});
+            round[destIds[i]]; // create the entries before the threads use them
+            newRound[destIds[i]];
+        }
+        destTasks[taskOfDest[destIds[i]]].push_back(i);
     }
+    parallelFor(2 * destTasks.size(), [&](unsigned int task) { // every (dest, weight) tree is independent
+        bool newWeight = task >= destTasks.size();
+        for (auto i : destTasks[newWeight ? task - destTasks.size() : task]) {
+            if (!newWeight)
+                dijkstra(tableList[i], destIds[i], graph, false, round.find(destIds[i])->second); // shortest path algorithm, using old weight
+            else
+                dijkstra(newTableList[i], destIds[i], graph, true, newRound.find(destIds[i])->second); // new weight
+        }
+    });
 
     // read the input and generate switch nodes
     for (unsigned int id = 0; id < nodeCnt; id++) {
@@ -1702,8 +1888,8 @@ int main() {
     unsigned int con_id = node::getNodeNum();
     // set switches' neighbors
     for (unsigned int id = 0; id < nodeCnt; id++) {
-        for (auto j : nodes[id].neighbors) {
-            node::id_to_node(id)->add_phy_neighbor(j.id);
+        for (unsigned int k = graph.first[id]; k < graph.first[id + 1]; k++) {
+            node::id_to_node(id)->add_phy_neighbor(graph.adj[k]);
         }
     }
     // generate and set neighbor of controller
@@ -1731,7 +1917,7 @@ int main() {
     }
     for (auto i : destIds) {
         for (auto k : newRound[i][0]) {
-            ctrl_packet_event(con_id, k.target, k.match, k.action, updTime, "update");
+            ctrl_packet_event(con_id, k.target, k.match, k.action, updTime, message::UPDATE);
         }
     }
 